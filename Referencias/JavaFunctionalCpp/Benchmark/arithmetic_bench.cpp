@@ -0,0 +1,287 @@
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+#include "envstack.hpp"
+#include "functionmemory.hpp"
+#include "parser.hpp"
+#include "resolver.hpp"
+#include "typechecker.hpp"
+#include "optimizer.hpp"
+#include "inliner.hpp"
+#include "interpret.hpp"
+#include "compiler.hpp"
+#include "vm.hpp"
+
+static const int STATEMENT_GROUPS = 20000;
+
+// Mixed-width arithmetic: every statement performs 4-6 binary operations
+// over short/int/long/float/double operands.
+BENCHMARK(ArithmeticHeavyProgram)
+{
+	std::string program = "{\nint a = 1;\nint b = 3;\nlong c = 5;\ndouble d = 1.5;\nfloat e = 2.5;\nshort s = 2;\n";
+	for (int i = 0; i < STATEMENT_GROUPS; i++)
+	{
+		program += "a = a * 3 + 7 - a * 2 - 7;\n";
+		program += "d = d * 1.5 - d * 0.5 + a - a;\n";
+		program += "c = c + b * 2 - b - b;\n";
+		program += "e = e * 2 - e + d - d;\n";
+		program += "s = s * s - s - s;\n";
+	}
+	program += "}\n";
+
+	FunctionMemory function_memory;
+	EnvStack env_stack;
+	Parser parser(program, std::move(env_stack), function_memory);
+	Program ast = parser.Parse();
+	std::vector<AstNode*>& statements = ast.statements;
+	Resolver resolver(function_memory);
+	resolver.Resolve(statements);
+
+	double ms = MeasureMs([&]()
+	{
+		Interpreter interpreter(function_memory, resolver.GetGlobalSlotCount());
+		for (auto& stmt : statements)
+		{
+			stmt->Accept(interpreter);
+		}
+	});
+	TypeChecker type_checker(function_memory, resolver.GetGlobalSlotCount());
+	type_checker.Check(statements);
+	double typed_ms = MeasureMs([&]()
+	{
+		Interpreter interpreter(function_memory, resolver.GetGlobalSlotCount());
+		for (auto& stmt : statements)
+		{
+			stmt->Accept(interpreter);
+		}
+	});
+	Compiler compiler(function_memory, resolver.GetGlobalSlotCount());
+	compiler.Compile(statements);
+	double vm_ms = MeasureMs([&]()
+	{
+		VirtualMachine vm(compiler.GetChunks());
+		vm.Run();
+	});
+
+	int operations = STATEMENT_GROUPS * 24;
+	std::cout << "  " << operations << " binary operations" << std::endl;
+	PrintResult("Interpreter", ms);
+	std::cout << "  " << operations / ms / 1000 << " M operations/s" << std::endl;
+	PrintResult("Interpreter, typed", typed_ms);
+	std::cout << "  " << operations / typed_ms / 1000 << " M operations/s" << std::endl;
+	PrintResult("VM", vm_ms);
+	std::cout << "  " << operations / vm_ms / 1000 << " M operations/s" << std::endl;
+}
+
+static const int CALL_DEPTH = 2000;
+static const int CALL_ROUNDS = 50;
+
+// Recursive calls: frame setup, argument passing and a little arithmetic.
+BENCHMARK(CallHeavyProgram)
+{
+	std::string program = "int total = 0;\n"
+		"int f(int n) { int x = n * 2 + 1; total = total + x - n - n; if (n != 0) { f(n - 1); } }\n";
+	for (int i = 0; i < CALL_ROUNDS; i++)
+	{
+		program += "f(" + std::to_string(CALL_DEPTH) + ");\n";
+	}
+
+	FunctionMemory function_memory;
+	EnvStack env_stack;
+	Parser parser(program, std::move(env_stack), function_memory);
+	Program ast = parser.Parse();
+	std::vector<AstNode*>& statements = ast.statements;
+	Resolver resolver(function_memory);
+	resolver.Resolve(statements);
+
+	double ms = MeasureMs([&]()
+	{
+		Interpreter interpreter(function_memory, resolver.GetGlobalSlotCount());
+		for (auto& stmt : statements)
+		{
+			stmt->Accept(interpreter);
+		}
+	});
+
+	Compiler compiler(function_memory, resolver.GetGlobalSlotCount());
+	compiler.Compile(statements);
+	double vm_ms = MeasureMs([&]()
+	{
+		VirtualMachine vm(compiler.GetChunks());
+		vm.Run();
+	});
+
+	std::cout << "  " << CALL_ROUNDS * (CALL_DEPTH + 1) << " calls" << std::endl;
+	PrintResult("Interpreter", ms);
+	PrintResult("VM", vm_ms);
+}
+
+// Recursive calls (as in CallHeavyProgram) that each call two tiny helpers,
+// before and after the -O1 Inliner copies the helpers into the caller.
+BENCHMARK(SmallHelperCalls)
+{
+	std::string program = "int total = 0;\n"
+		"int add(int a, int b) { int t = a * 2 - b; total = total + t; }\n"
+		"int f(int n) { add(n, 1); add(n, 2); if (n != 0) { f(n - 1); } }\n";
+	for (int i = 0; i < CALL_ROUNDS; i++)
+	{
+		program += "f(" + std::to_string(CALL_DEPTH) + ");\n";
+	}
+
+	FunctionMemory function_memory;
+	Parser parser(program, EnvStack(), function_memory);
+	Program ast = parser.Parse();
+	Resolver resolver(function_memory);
+	resolver.Resolve(ast.statements);
+	TypeChecker type_checker(function_memory, resolver.GetGlobalSlotCount());
+	type_checker.Check(ast.statements);
+	int global_slot_count = resolver.GetGlobalSlotCount();
+	auto run = [&]()
+	{
+		Interpreter interpreter(function_memory, global_slot_count);
+		for (auto& stmt : ast.statements)
+		{
+			stmt->Accept(interpreter);
+		}
+	};
+	double ms = MeasureMs(run);
+	Inliner inliner(ast.arena, function_memory, global_slot_count);
+	double inline_ms = MeasureMs([&]() { inliner.Inline(ast.statements); }, 1);
+	global_slot_count = inliner.GetGlobalSlotCount();
+	double inlined_ms = MeasureMs(run);
+
+	InlinerStats stats = inliner.GetStats();
+	std::cout << "  " << CALL_ROUNDS * (CALL_DEPTH + 1) * 3 << " calls, " << stats.calls << " sites inlined, "
+		<< stats.nodes_before << " -> " << stats.nodes_after << " nodes" << std::endl;
+	PrintResult("Inliner", inline_ms);
+	PrintResult("Interpreter", ms);
+	PrintResult("Interpreter, -O1", inlined_ms);
+}
+
+static const int FIB_N = 22;
+
+// Tree recursion shaped like fib(n), without a return value: nearly every
+// node evaluated is a call, a comparison or a subtraction, so the time is
+// per-node dispatch plus the cost of each call (arguments and a frame).
+BENCHMARK(FibRecursion)
+{
+	std::string program = "int fib(int n) { if (n != 0) { if (n != 1) { fib(n - 1); fib(n - 2); } } }\n";
+	program += "fib(" + std::to_string(FIB_N) + ");\n";
+
+	FunctionMemory function_memory;
+	Parser parser(program, EnvStack(), function_memory);
+	Program ast = parser.Parse();
+	Resolver resolver(function_memory);
+	resolver.Resolve(ast.statements);
+
+	double ms = MeasureMs([&]()
+	{
+		Interpreter interpreter(function_memory, resolver.GetGlobalSlotCount());
+		for (AstNode* stmt : ast.statements)
+		{
+			interpreter.Interpret(stmt);
+		}
+	});
+
+	// fib(0) evaluates the body block, the if and 'n != 0': 5 nodes. fib(1)
+	// adds the inner block, if and comparison: 10. Above that a call adds
+	// a block and two calls of 'n - k': 19, plus the calls it makes.
+	long long calls[FIB_N + 1];
+	long long nodes[FIB_N + 1];
+	for (int n = 0; n <= FIB_N; n++)
+	{
+		calls[n] = n <= 1 ? 1 : calls[n - 1] + calls[n - 2] + 1;
+		nodes[n] = n == 0 ? 5 : n == 1 ? 10 : nodes[n - 1] + nodes[n - 2] + 19;
+	}
+	long long evaluated = nodes[FIB_N] + 2; // and the top-level call with its argument
+	std::cout << "  " << calls[FIB_N] << " calls, " << evaluated << " nodes evaluated" << std::endl;
+	PrintResult("Interpreter", ms);
+	std::cout << "  " << ms * 1e6 / evaluated << " ns per node" << std::endl;
+}
+
+// One generated sum per size: parse, resolve and evaluate must stay linear
+// in the number of terms, with no recursion per operator.
+BENCHMARK(LongExpression)
+{
+	for (int terms : { 500000, 1000000, 2000000 })
+	{
+		std::string program = "int x = 0;\nx = 1";
+		for (int i = 0; i < terms; i++)
+		{
+			program += i % 2 == 0 ? " + 3" : " - 1";
+		}
+		program += ";\n";
+
+		FunctionMemory function_memory;
+		Program ast;
+		double parse_ms = MeasureMs([&]()
+		{
+			Parser parser(program, EnvStack(), function_memory);
+			ast = parser.Parse();
+		}, 1);
+		Resolver resolver(function_memory);
+		resolver.Resolve(ast.statements);
+		double ms = MeasureMs([&]()
+		{
+			Interpreter interpreter(function_memory, resolver.GetGlobalSlotCount());
+			for (auto& stmt : ast.statements)
+			{
+				stmt->Accept(interpreter);
+			}
+		});
+		Compiler compiler(function_memory, resolver.GetGlobalSlotCount());
+		compiler.Compile(ast.statements);
+		double vm_ms = MeasureMs([&]()
+		{
+			VirtualMachine vm(compiler.GetChunks());
+			vm.Run();
+		});
+
+		std::cout << "  " << terms << " terms" << std::endl;
+		PrintResult("Parse", parse_ms);
+		PrintResult("Interpreter", ms);
+		PrintResult("VM", vm_ms);
+		std::cout << "  " << ms * 1e6 / terms << " ns/term interpreted" << std::endl;
+	}
+}
+
+// Literal subexpressions, never-reassigned constants and constant ifs, run
+// before and after the -O1 Optimizer.
+BENCHMARK(ConstantFolding)
+{
+	std::string program = "{\nint k = 4;\ndouble scale = 0.5;\nint acc = 0;\ndouble d = 0.0;\n";
+	for (int i = 0; i < STATEMENT_GROUPS; i++)
+	{
+		program += "acc = acc + k * 2 + 3 - 2 * 4;\n";
+		program += "d = d + scale * 3 - 1.5;\n";
+		program += "if (k == 4) { acc = acc - 1; }\n";
+		program += "if (k != 4) { acc = 0; }\n";
+	}
+	program += "}\n";
+
+	FunctionMemory function_memory;
+	Parser parser(program, EnvStack(), function_memory);
+	Program ast = parser.Parse();
+	Resolver resolver(function_memory);
+	resolver.Resolve(ast.statements);
+	auto run = [&]()
+	{
+		Interpreter interpreter(function_memory, resolver.GetGlobalSlotCount());
+		for (auto& stmt : ast.statements)
+		{
+			stmt->Accept(interpreter);
+		}
+	};
+	double ms = MeasureMs(run);
+	Optimizer optimizer(ast.arena, function_memory, resolver.GetGlobalSlotCount());
+	double optimize_ms = MeasureMs([&]() { optimizer.Optimize(ast.statements); }, 1);
+	double optimized_ms = MeasureMs(run);
+
+	OptimizerStats stats = optimizer.GetStats();
+	std::cout << "  " << stats.nodes_before << " -> " << stats.nodes_after << " nodes" << std::endl;
+	PrintResult("Optimizer", optimize_ms);
+	PrintResult("Interpreter", ms);
+	PrintResult("Interpreter, -O1", optimized_ms);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct Benchmark
+{
+	std::string name;
+	std::function<void()> run;
+};
+
+std::vector<Benchmark>& Benchmarks();
+
+struct BenchmarkRegistrar
+{
+	BenchmarkRegistrar(std::string name, std::function<void()> run)
+	{
+		Benchmarks().push_back({ name, run });
+	}
+};
+
+// BENCHMARK(Name) { ... } defines a benchmark selectable as 'Benchmark Name'.
+#define BENCHMARK(name) \
+	static void name(); \
+	static BenchmarkRegistrar name##_registrar(#name, name); \
+	static void name()
+
+// Best wall-clock time in milliseconds over 'repetitions' runs of 'f'.
+template <class F>
+double MeasureMs(F&& f, int repetitions = 5)
+{
+	double best = 0;
+	for (int i = 0; i < repetitions; i++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		f();
+		auto end = std::chrono::steady_clock::now();
+		double ms = std::chrono::duration<double, std::milli>(end - start).count();
+		if (i == 0 || ms < best)
+		{
+			best = ms;
+		}
+	}
+	return best;
+}
+
+// Number of global operator new calls so far (counted in main.cpp).
+size_t AllocationCount();
+
+inline void PrintResult(std::string label, double ms)
+{
+	std::cout << "  " << label << ": " << ms << " ms" << std::endl;
+}
@@ -0,0 +1,109 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+
+#include "lexer.hpp"
+
+static const int LEX_GROUPS = 20000;
+
+// Mostly keywords, type names and identifiers, some of them sharing a
+// keyword's prefix or length.
+static std::string IdentifierProgram()
+{
+	std::string program;
+	for (int i = 0; i < LEX_GROUPS; i++)
+	{
+		program += "int integer = 1;\tdouble doubles = 2.5;\n";
+		program += "bool flag = true; bool flags = false;\n";
+		program += "long f_" + std::to_string(i) + "(short s, float ft){ if (s == 0){ return ft; } print s; }\n";
+	}
+	return program;
+}
+
+// Operators, literals and whitespace in the proportion of ParseLargeProgram.
+static std::string ExpressionProgram()
+{
+	std::string program;
+	for (int i = 0; i < LEX_GROUPS; i++)
+	{
+		program += "a = a * 3 + 7 - a * 2 - 7;\n";
+		program += "d = d * 1.5 - d * 0.5 + a - a;\n";
+		program += "s = \"text\"; b += 1; c != b;\n";
+	}
+	return program;
+}
+
+// Generated-code shape: deep indentation, block comments and string
+// literals between short statements.
+static std::string CommentProgram()
+{
+	std::string program;
+	for (int i = 0; i < LEX_GROUPS; i++)
+	{
+		program += "                /* generated from rule " + std::to_string(i) + ", do not edit by hand;\n";
+		program += "                   regenerate with the schema tool instead */\n";
+		program += "                print \"value of the generated field number " + std::to_string(i) + "\";\n\n";
+	}
+	return program;
+}
+
+static void LexProgram(std::string label, const std::string& program)
+{
+	size_t token_count = 0;
+	double ms = MeasureMs([&]()
+	{
+		Lexer lexer(program);
+		token_count = 0;
+		while (lexer.Lex().GetToken_t() != END_OF_FILE_TOKEN)
+		{
+			token_count++;
+		}
+	});
+
+	double mb = program.size() / (1024.0 * 1024.0);
+	std::cout << "  " << label << ": " << program.size() << " bytes, " << token_count << " tokens" << std::endl;
+	PrintResult(label, ms);
+	std::cout << "  " << label << ": " << mb / (ms / 1000) << " MB/s, "
+		<< token_count / (ms / 1000) / 1e6 << " M tokens/s" << std::endl;
+}
+
+// Lexer alone, token by token, without collecting the tokens.
+BENCHMARK(LexerThroughput)
+{
+	LexProgram("Identifiers", IdentifierProgram());
+	LexProgram("Expressions", ExpressionProgram());
+	LexProgram("Comments", CommentProgram());
+}
+
+// LexAll() against LexAllParallel() on a large mixed input, by thread count.
+BENCHMARK(LexerParallel)
+{
+	std::string program;
+	std::string groups[] = { IdentifierProgram(), ExpressionProgram(), CommentProgram() };
+	while (program.size() < (64 << 20))
+	{
+		program += groups[program.size() % 3];
+	}
+	double mb = program.size() / (1024.0 * 1024.0);
+	std::cout << "  " << program.size() << " bytes, " << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+
+	double ms = MeasureMs([&]()
+	{
+		Lexer(program).LexAll();
+	}, 3);
+	PrintResult("LexAll", ms);
+	std::cout << "  LexAll: " << mb / (ms / 1000) << " MB/s" << std::endl;
+
+	for (size_t threads : { 2, 4, 8 })
+	{
+		std::string label = "LexAllParallel(" + std::to_string(threads) + ")";
+		double parallel_ms = MeasureMs([&]()
+		{
+			Lexer(program).LexAllParallel(threads);
+		}, 3);
+		PrintResult(label, parallel_ms);
+		std::cout << "  " << label << ": " << mb / (parallel_ms / 1000) << " MB/s, " << ms / parallel_ms << "x" << std::endl;
+	}
+}
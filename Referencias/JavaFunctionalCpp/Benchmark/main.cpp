@@ -0,0 +1,65 @@
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "bench.hpp"
+
+std::vector<Benchmark>& Benchmarks()
+{
+	static std::vector<Benchmark> benchmarks;
+	return benchmarks;
+}
+
+static size_t allocation_count = 0;
+
+size_t AllocationCount()
+{
+	return allocation_count;
+}
+
+void* operator new(size_t size)
+{
+	allocation_count++;
+	void* memory = std::malloc(size == 0 ? 1 : size);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+int main(int argc, char* argv[])
+{
+	bool found = false;
+	for (Benchmark& benchmark : Benchmarks())
+	{
+		if (argc >= 2 && benchmark.name != argv[1])
+		{
+			continue;
+		}
+		found = true;
+		std::cout << benchmark.name << std::endl;
+		benchmark.run();
+	}
+	if (not found)
+	{
+		std::cout << "Usage: Benchmark [name]" << std::endl;
+		for (Benchmark& benchmark : Benchmarks())
+		{
+			std::cout << "  " << benchmark.name << std::endl;
+		}
+		return 64;
+	}
+	return 0;
+}
@@ -0,0 +1,313 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+
+#include "ast_node_headers.hpp"
+#include "envstack.hpp"
+#include "flatast.hpp"
+#include "functionmemory.hpp"
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "resolver.hpp"
+#include "interpret.hpp"
+
+static const int PARSE_GROUPS = 20000;
+static const int PARSE_REPETITIONS = 5;
+
+static std::string LargeProgram()
+{
+	std::string program = "{\nint a = 1;\nint b = 3;\ndouble d = 1.5;\n";
+	for (int i = 0; i < PARSE_GROUPS; i++)
+	{
+		program += "a = a * 3 + 7 - a * 2 - 7;\n";
+		program += "d = d * 1.5 - d * 0.5 + a - a;\n";
+		program += "b = b + a * 2 - b - b;\n";
+	}
+	program += "}\n";
+	return program;
+}
+
+// Parse (lexer included), a full pass over the tree and the release of the
+// whole tree.
+BENCHMARK(ParseLargeProgram)
+{
+	std::string program = LargeProgram();
+
+	std::vector<FunctionMemory> function_memories(PARSE_REPETITIONS);
+	std::vector<Program> programs;
+	int parsed = 0;
+	double parse_ms = MeasureMs([&]()
+	{
+		EnvStack env_stack;
+		Parser parser(program, std::move(env_stack), function_memories[parsed++]);
+		programs.push_back(parser.Parse());
+	}, PARSE_REPETITIONS);
+
+	double resolve_ms = MeasureMs([&]()
+	{
+		FunctionMemory function_memory;
+		Resolver resolver(function_memory);
+		resolver.Resolve(programs.front().statements);
+	});
+
+	double free_ms = MeasureMs([&]()
+	{
+		programs.pop_back();
+	}, PARSE_REPETITIONS);
+
+	TokenBuffer tokens = Lexer(program).LexAll();
+	size_t token_count = tokens.Size();
+	size_t allocations = AllocationCount();
+	{
+		FunctionMemory function_memory;
+		EnvStack env_stack;
+		Parser parser(program, std::move(env_stack), function_memory);
+		Program ast = parser.Parse();
+	}
+	allocations = AllocationCount() - allocations;
+
+	double mb = program.size() / (1024.0 * 1024.0);
+	std::cout << "  " << program.size() << " bytes, " << PARSE_GROUPS * 3 << " statements" << std::endl;
+	std::cout << "  " << token_count << " tokens, " << allocations << " allocations (" << (double)allocations / token_count << " per token)" << std::endl;
+	std::cout << "  " << tokens.BytesUsed() << " bytes of tokens (" << (double)tokens.BytesUsed() / token_count << " per token), parser keeps a " << TokenStream(program).BytesUsed() << " byte window" << std::endl;
+	PrintResult("Parse", parse_ms);
+	std::cout << "  " << mb / (parse_ms / 1000) << " MB/s" << std::endl;
+	PrintResult("Resolver pass", resolve_ms);
+	PrintResult("Free tree", free_ms);
+}
+
+// The same input parsed with the lexer on its own thread.
+BENCHMARK(ParsePipelined)
+{
+	std::string program = LargeProgram();
+	for (bool pipelined : { false, true })
+	{
+		std::vector<FunctionMemory> function_memories(PARSE_REPETITIONS);
+		std::vector<Program> programs;
+		PipelineStats stats;
+		int parsed = 0;
+		double ms = MeasureMs([&]()
+		{
+			Parser parser(program, EnvStack(), function_memories[parsed++], pipelined ? PARSE_PIPELINED : PARSE_STREAMING);
+			programs.push_back(parser.Parse());
+			stats = parser.GetPipelineStats();
+		}, PARSE_REPETITIONS);
+		PrintResult(pipelined ? "Pipelined" : "Sequential", ms);
+		if (pipelined)
+		{
+			std::cout << "  " << stats.batches << " batches, lexer stalled " << stats.lexer_stalls
+				<< " times, parser stalled " << stats.parser_stalls << " times" << std::endl;
+		}
+	}
+	std::cout << "  " << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+}
+
+// Thousands of top-level functions, serial against PARSE_PARALLEL.
+BENCHMARK(ParseManyFunctions)
+{
+	std::string program = "int g = 1;\n";
+	for (int i = 0; i < PARSE_GROUPS / 4; i++)
+	{
+		std::string n = std::to_string(i);
+		program += "int f" + n + "(int a, double b) {\n  int l = a * 3 + 7;\n  if (a == 0) { print l - g; }\n";
+		program += "  double d = b * 1.5 - b * 0.5 + a;\n  print d + l;\n}\n";
+	}
+	std::cout << "  " << program.size() << " bytes, " << PARSE_GROUPS / 4 << " functions, "
+		<< std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+
+	for (ParseMode mode : { PARSE_STREAMING, PARSE_PARALLEL })
+	{
+		std::vector<FunctionMemory> function_memories(PARSE_REPETITIONS);
+		std::vector<Program> programs;
+		int parsed = 0;
+		double ms = MeasureMs([&]()
+		{
+			Parser parser(program, EnvStack(), function_memories[parsed++], mode);
+			programs.push_back(parser.Parse());
+		}, PARSE_REPETITIONS);
+		PrintResult(mode == PARSE_PARALLEL ? "Parallel" : "Serial", ms);
+	}
+}
+
+// Start-up of a generated library: PARSE_GROUPS / 4 functions of which one
+// in twenty is called. Parse, resolve and run the calls, eagerly and with
+// PARSE_LAZY; memory is the AST arena bytes, lazy bodies included.
+BENCHMARK(ParseLazyLibrary)
+{
+	const int functions = PARSE_GROUPS / 4;
+	std::string program = "int g = 1;\n";
+	for (int i = 0; i < functions; i++)
+	{
+		std::string n = std::to_string(i);
+		program += "int f" + n + "(int a, double b) {\n  int l = a * 3 + 7;\n  if (a == 0) { g = l - g; }\n";
+		program += "  double d = b * 1.5 - b * 0.5 + a;\n  g = g + l;\n}\n";
+	}
+	for (int i = 0; i < functions; i += 20)
+	{
+		program += "f" + std::to_string(i) + "(1, 2.5);\n";
+	}
+	std::cout << "  " << program.size() << " bytes, " << functions << " functions, " << functions / 20 << " called" << std::endl;
+
+	for (ParseMode mode : { PARSE_STREAMING, PARSE_LAZY })
+	{
+		size_t arena_bytes = 0;
+		size_t allocations = 0;
+		double ms = MeasureMs([&]()
+		{
+			size_t allocations_before = AllocationCount();
+			FunctionMemory function_memory;
+			Parser parser(program, EnvStack(), function_memory, mode);
+			Program ast = parser.Parse();
+			Resolver resolver(function_memory);
+			resolver.Resolve(ast.statements);
+			Interpreter interpreter(function_memory, resolver.GetGlobalSlotCount(), &resolver);
+			for (AstNode* stmt : ast.statements)
+			{
+				interpreter.Interpret(stmt);
+			}
+			allocations = AllocationCount() - allocations_before;
+
+			arena_bytes = ast.arena.BytesUsed();
+			for (Symbol identifier : function_memory.GetIdentifiers())
+			{
+				FuncVariable& func_var = function_memory.GetRef(identifier);
+				if (func_var.lazy_body != nullptr)
+				{
+					arena_bytes += func_var.lazy_body->program.arena.BytesUsed();
+				}
+			}
+		}, PARSE_REPETITIONS);
+		PrintResult(mode == PARSE_LAZY ? "Lazy" : "Eager", ms);
+		std::cout << "    " << arena_bytes << " arena bytes, " << allocations << " allocations" << std::endl;
+	}
+}
+
+static std::string ConstantTable()
+{
+	std::string program = "{\nint i = 0;\nlong l = 0;\nfloat f = 0;\ndouble d = 0;\n";
+	for (int i = 0; i < PARSE_GROUPS; i++)
+	{
+		std::string n = std::to_string(i * 7919 % 100000);
+		program += "i = " + n + "; l = " + n + "0; f = " + n + ".25; d = 0." + n + "; print 1" + n + ";\n";
+	}
+	program += "}\n";
+	return program;
+}
+
+// Literal-heavy input: every statement assigns a number to a typed variable.
+BENCHMARK(ParseConstantTable)
+{
+	std::string program = ConstantTable();
+
+	std::vector<FunctionMemory> function_memories(PARSE_REPETITIONS);
+	std::vector<Program> programs;
+	int parsed = 0;
+	double parse_ms = MeasureMs([&]()
+	{
+		EnvStack env_stack;
+		Parser parser(program, std::move(env_stack), function_memories[parsed++]);
+		programs.push_back(parser.Parse());
+	}, PARSE_REPETITIONS);
+
+	std::cout << "  " << program.size() << " bytes, " << PARSE_GROUPS * 5 << " literals" << std::endl;
+	PrintResult("Parse", parse_ms);
+}
+
+// Pre-order walk of the pointer tree: counts nodes and sums number literals.
+class LiteralSum final : public Visitor
+{
+public:
+	size_t nodes = 0;
+	double sum = 0;
+
+	void Walk(AstNode* node)
+	{
+		if (node != nullptr)
+		{
+			Dispatch(*this, *node);
+		}
+	}
+
+	Value VisitBinaryExpression(BinaryExpression& node) { this->nodes++; Walk(node.left); Walk(node.right); return Value(); }
+	Value VisitBoolNode(BoolNode& node) { this->nodes++; return Value(); }
+	Value VisitNumberNode(NumberNode& node) { this->nodes++; this->sum += node.number.As<double>(); return Value(); }
+	Value VisitStringNode(StringNode& node) { this->nodes++; return Value(); }
+	Value VisitIdentifierNode(IdentifierNode& node) { this->nodes++; return Value(); }
+	Value VisitUnaryNode(UnaryNode& node) { this->nodes++; Walk(node.left); return Value(); }
+
+	Value VisitIfStmtNode(IfStmtNode& node) { this->nodes++; Walk(node.expression); Walk(node.blockStmt); return Value(); }
+	Value VisitPrintStmt(PrintStmtNode& node) { this->nodes++; Walk(node.expression); return Value(); }
+	Value VisitVarDeclarationStmt(VarDeclarationNode& node) { this->nodes++; Walk(node.expression); return Value(); }
+	Value VisitVarAssignmentStmt(VarAssignmentStmtNode& node) { this->nodes++; Walk(node.expression); return Value(); }
+
+	Value VisitFunctionCallNode(FunctionCallExpr& node)
+	{
+		this->nodes++;
+		for (AstNode* argument : node.arguments)
+		{
+			Walk(argument);
+		}
+		return Value();
+	}
+	Value VisitBlockStmtNode(BlockStmtNode& node)
+	{
+		this->nodes++;
+		for (AstNode* stmt : node.stmts)
+		{
+			Walk(stmt);
+		}
+		return Value();
+	}
+};
+
+// The same pre-order walk over the pointer tree and over its FlatAst.
+BENCHMARK(FlatAstWalk)
+{
+	std::string program = LargeProgram();
+	FunctionMemory function_memory;
+	Parser parser(program, EnvStack(), function_memory);
+	Program ast = parser.Parse();
+
+	LiteralSum pointer_walk;
+	double pointer_ms = MeasureMs([&]()
+	{
+		pointer_walk = LiteralSum();
+		for (AstNode* stmt : ast.statements)
+		{
+			pointer_walk.Walk(stmt);
+		}
+	}, 20);
+
+	FlatAst flat;
+	double flatten_ms = MeasureMs([&]()
+	{
+		flat = FlatAst::Flatten(ast.statements);
+	});
+
+	size_t flat_nodes = 0;
+	double flat_sum = 0;
+	double flat_ms = MeasureMs([&]()
+	{
+		flat_nodes = 0;
+		flat_sum = 0;
+		for (uint32_t node = 0; node < flat.Size(); node++)
+		{
+			flat_nodes += flat.Kind(node) != NODE_EMPTY;
+			if (flat.Kind(node) == NODE_NUMBER)
+			{
+				flat_sum += flat.Constant(node).As<double>();
+			}
+		}
+	}, 20);
+
+	std::cout << "  " << pointer_walk.nodes << " nodes, " << ast.arena.BytesUsed() << " arena bytes, " << flat.BytesUsed() << " flat bytes" << std::endl;
+	if (flat_nodes != pointer_walk.nodes || flat_sum != pointer_walk.sum)
+	{
+		std::cout << "  flat walk disagrees: " << flat_nodes << " nodes" << std::endl;
+	}
+	PrintResult("Pointer walk", pointer_ms);
+	PrintResult("Flatten", flatten_ms);
+	PrintResult("Flat walk", flat_ms);
+}
@@ -0,0 +1,131 @@
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+#include "envstack.hpp"
+#include "environment.hpp"
+#include "framestack.hpp"
+#include "functionmemory.hpp"
+#include "parser.hpp"
+#include "resolver.hpp"
+#include "interpret.hpp"
+#include "compiler.hpp"
+#include "vm.hpp"
+
+static const int SCOPES = 8;
+static const int VARS_PER_SCOPE = 16;
+static const int ROUNDS = 2000;
+
+// Same access pattern through both stores: every variable of SCOPES nested
+// scopes is read and written ROUNDS times.
+BENCHMARK(VariableAccess)
+{
+	std::vector<Symbol> names;
+	for (int i = 0; i < SCOPES * VARS_PER_SCOPE; i++)
+	{
+		names.push_back(Symbols().Intern("v" + std::to_string(i)));
+	}
+
+	EnvStack env_stack;
+	for (int s = 0; s < SCOPES; s++)
+	{
+		Environment env;
+		for (int v = 0; v < VARS_PER_SCOPE; v++)
+		{
+			Variable var;
+			var.dtType = DT_INT;
+			var.identifier = names[s * VARS_PER_SCOPE + v];
+			var.value = Value(v);
+			env.env_var.Set(var);
+		}
+		env_stack.Push(std::move(env));
+	}
+	double env_ms = MeasureMs([&]()
+	{
+		for (int r = 0; r < ROUNDS; r++)
+		{
+			for (Symbol name : names)
+			{
+				Value value = env_stack.Get(name).first.value;
+				env_stack.Assign(name, value);
+			}
+		}
+	}, 3);
+
+	FrameStack frames;
+	frames.Push(0);
+	frames.Push(SCOPES * VARS_PER_SCOPE);
+	for (int slot = 0; slot < SCOPES * VARS_PER_SCOPE; slot++)
+	{
+		frames.At(0, slot) = Value(slot);
+	}
+	double frame_ms = MeasureMs([&]()
+	{
+		for (int r = 0; r < ROUNDS; r++)
+		{
+			for (int slot = 0; slot < SCOPES * VARS_PER_SCOPE; slot++)
+			{
+				Value value = frames.At(0, slot);
+				frames.At(0, slot) = value;
+			}
+		}
+	});
+
+	int accesses = ROUNDS * SCOPES * VARS_PER_SCOPE;
+	std::cout << "  " << accesses << " read+write pairs, " << SCOPES << " scopes x " << VARS_PER_SCOPE << " variables" << std::endl;
+	PrintResult("EnvStack::Get/Assign", env_ms);
+	PrintResult("FrameStack::At", frame_ms);
+}
+
+// End to end: variable-heavy straight-line code in nested blocks.
+BENCHMARK(VariableHeavyProgram)
+{
+	std::string program = "{\n";
+	for (int v = 0; v < 32; v++)
+	{
+		program += "int v" + std::to_string(v) + " = " + std::to_string(v) + ";\n";
+	}
+	for (int s = 0; s < SCOPES; s++)
+	{
+		program += "{\n";
+		for (int i = 0; i < 4000; i++)
+		{
+			int a = (i * 7) % 32, b = (i * 13) % 32, c = (i * 5) % 32;
+			program += "v" + std::to_string(a) + " = v" + std::to_string(b) + " + v" + std::to_string(c) + ";\n";
+		}
+	}
+	for (int s = 0; s < SCOPES; s++)
+	{
+		program += "}\n";
+	}
+	program += "}\n";
+
+	FunctionMemory function_memory;
+	EnvStack env_stack;
+	Parser parser(program, std::move(env_stack), function_memory);
+	Program ast = parser.Parse();
+	std::vector<AstNode*>& statements = ast.statements;
+	Resolver resolver(function_memory);
+	resolver.Resolve(statements);
+
+	double ms = MeasureMs([&]()
+	{
+		Interpreter interpreter(function_memory, resolver.GetGlobalSlotCount());
+		for (auto& stmt : statements)
+		{
+			stmt->Accept(interpreter);
+		}
+	});
+	Compiler compiler(function_memory, resolver.GetGlobalSlotCount());
+	compiler.Compile(statements);
+	double vm_ms = MeasureMs([&]()
+	{
+		VirtualMachine vm(compiler.GetChunks());
+		vm.Run();
+	});
+
+	std::cout << "  " << SCOPES * 4000 << " assignments" << std::endl;
+	PrintResult("Interpreter", ms);
+	PrintResult("VM", vm_ms);
+}
@@ -1,17 +1,16 @@
 #include "pch.h"
 #include "parser.hpp"
 
-static void AssertEqSyntaxTokens(std::vector<SyntaxToken> expected_output, std::vector<SyntaxToken> lexer_output)
+static void AssertEqSyntaxTokens(std::vector<SyntaxToken> expected_output, const TokenBuffer& lexer_output)
 {
-	ASSERT_EQ(lexer_output.size(), expected_output.size());
-	for (int i = 0; i < lexer_output.size(); i++)
+	ASSERT_EQ(lexer_output.Size(), expected_output.size());
+	for (int i = 0; i < lexer_output.Size(); i++)
 	{
 		SyntaxToken expected_syntaxtoken = expected_output.at(i);
-		SyntaxToken lexer_syntaxtoken = lexer_output.at(i);
+		SyntaxToken lexer_syntaxtoken = lexer_output.At(i);
 
 		ASSERT_EQ(expected_syntaxtoken.GetLen(), lexer_syntaxtoken.GetLen());
 		ASSERT_EQ(expected_syntaxtoken.GetPos(), lexer_syntaxtoken.GetPos());
-		ASSERT_EQ(expected_syntaxtoken.GetRow(), lexer_syntaxtoken.GetRow());
 		ASSERT_EQ(expected_syntaxtoken.GetToken_t(), lexer_syntaxtoken.GetToken_t());
 		ASSERT_EQ(expected_syntaxtoken.GetValue(), lexer_syntaxtoken.GetValue());
 	}
@@ -38,11 +37,10 @@ TEST_F(LexerTest, EndOfFileLexer)
 {
 	program = "";
 	SetUp();
-	int row = 0;
 	std::vector<SyntaxToken> expected_output = {
-		SyntaxToken(END_OF_FILE_TOKEN, "", 0, row, 0)
+		SyntaxToken(END_OF_FILE_TOKEN, "", 0, 0)
 	};
-	std::vector<SyntaxToken> lexer_output = lexer.LexAll();
+	TokenBuffer lexer_output = lexer.LexAll();
 	AssertEqSyntaxTokens(expected_output, lexer_output);
 }
 
@@ -50,15 +48,14 @@ TEST_F(LexerTest, KeywordsLexer)
 {
 	program = "print if return printifreturn";
 	SetUp();
-	int row = 0;
 	std::vector<SyntaxToken> expected_output = {
-		SyntaxToken(PRINT_KW, DisplayToken(PRINT_KW), 0, row, 5),
-		SyntaxToken(IF_KW, DisplayToken(IF_KW), 6, row, 2),
-		SyntaxToken(RETURN_KW, DisplayToken(RETURN_KW), 9, row, 6),
-		SyntaxToken(IDENTIFIER_TOKEN, "printifreturn", 16, row, 13),
-		SyntaxToken(END_OF_FILE_TOKEN, "", 16+13, row, 0)
+		SyntaxToken(PRINT_KW, DisplayToken(PRINT_KW), 0, 5),
+		SyntaxToken(IF_KW, DisplayToken(IF_KW), 6, 2),
+		SyntaxToken(RETURN_KW, DisplayToken(RETURN_KW), 9, 6),
+		SyntaxToken(IDENTIFIER_TOKEN, "printifreturn", 16, 13),
+		SyntaxToken(END_OF_FILE_TOKEN, "", 16+13, 0)
 	};
-	std::vector<SyntaxToken> lexer_output = lexer.LexAll();
+	TokenBuffer lexer_output = lexer.LexAll();
 	AssertEqSyntaxTokens(expected_output, lexer_output);
 }
 
@@ -66,18 +63,17 @@ TEST_F(LexerTest, VariableTypesLexer)
 {
 	program = "bool short int long float double boolshortintlongfloatdouble";
 	SetUp();
-	int row = 0;
 	std::vector<SyntaxToken> expected_output = {
-		SyntaxToken(BOOL_TYPE, DisplayToken(BOOL_TYPE), 0, row, 4),
-		SyntaxToken(SHORT_TYPE, DisplayToken(SHORT_TYPE), 5, row, 5),
-		SyntaxToken(INT_TYPE, DisplayToken(INT_TYPE), 11, row, 3),
-		SyntaxToken(LONG_TYPE, DisplayToken(LONG_TYPE), 15, row, 4),
-		SyntaxToken(FLOAT_TYPE, DisplayToken(FLOAT_TYPE), 20, row, 5),
-		SyntaxToken(DOUBLE_TYPE, DisplayToken(DOUBLE_TYPE), 26, row, 6),
-		SyntaxToken(IDENTIFIER_TOKEN, "boolshortintlongfloatdouble", 33, row, strlen("boolshortintlongfloatdouble")),
-		SyntaxToken(END_OF_FILE_TOKEN, "", 33 + strlen("boolshortintlongfloatdouble"), row, 0)
+		SyntaxToken(BOOL_TYPE, DisplayToken(BOOL_TYPE), 0, 4),
+		SyntaxToken(SHORT_TYPE, DisplayToken(SHORT_TYPE), 5, 5),
+		SyntaxToken(INT_TYPE, DisplayToken(INT_TYPE), 11, 3),
+		SyntaxToken(LONG_TYPE, DisplayToken(LONG_TYPE), 15, 4),
+		SyntaxToken(FLOAT_TYPE, DisplayToken(FLOAT_TYPE), 20, 5),
+		SyntaxToken(DOUBLE_TYPE, DisplayToken(DOUBLE_TYPE), 26, 6),
+		SyntaxToken(IDENTIFIER_TOKEN, "boolshortintlongfloatdouble", 33, strlen("boolshortintlongfloatdouble")),
+		SyntaxToken(END_OF_FILE_TOKEN, "", 33 + strlen("boolshortintlongfloatdouble"), 0)
 	};
-	std::vector<SyntaxToken> lexer_output = lexer.LexAll();
+	TokenBuffer lexer_output = lexer.LexAll();
 	AssertEqSyntaxTokens(expected_output, lexer_output);
 }
 
@@ -85,16 +81,15 @@ TEST_F(LexerTest, ParenLexer)
 {
 	program = "(){}}";
 	SetUp();
-	int row = 0;
 	std::vector<SyntaxToken> expected_output = {
-		SyntaxToken(OPEN_PAREN, "(", 0, row, 1),
-		SyntaxToken(CLOSE_PAREN, ")", 1, row, 1),
-		SyntaxToken(OPEN_CURLY_BRACKET, "{", 2, row, 1),
-		SyntaxToken(CLOSE_CURLY_BRACKET, "}", 3, row, 1),
-		SyntaxToken(CLOSE_CURLY_BRACKET, "}", 4, row, 1),
-		SyntaxToken(END_OF_FILE_TOKEN, "", 5, row, 0)
+		SyntaxToken(OPEN_PAREN, "(", 0, 1),
+		SyntaxToken(CLOSE_PAREN, ")", 1, 1),
+		SyntaxToken(OPEN_CURLY_BRACKET, "{", 2, 1),
+		SyntaxToken(CLOSE_CURLY_BRACKET, "}", 3, 1),
+		SyntaxToken(CLOSE_CURLY_BRACKET, "}", 4, 1),
+		SyntaxToken(END_OF_FILE_TOKEN, "", 5, 0)
 	};
-	std::vector<SyntaxToken> lexer_output = lexer.LexAll();
+	TokenBuffer lexer_output = lexer.LexAll();
 	AssertEqSyntaxTokens(expected_output, lexer_output);
 }
 
@@ -102,28 +97,27 @@ TEST_F(LexerTest, OperatorsLexer)
 {
 	program = "+ - * / ++ +++ -- += -= *= /= = == != && || ,";
 	SetUp();
-	int row = 0;
 	std::vector<SyntaxToken> expected_output = {
-		SyntaxToken(PLUS_TOKEN, "+", 0, row, 1),
-		SyntaxToken(MINUS_TOKEN, "-", 2, row, 1),
-		SyntaxToken(STAR_TOKEN, "*", 4, row, 1),
-		SyntaxToken(SLASH_TOKEN, "/", 6, row, 1),
-		SyntaxToken(PLUS_PLUS_TOKEN, "++", 8, row, 2),
-		SyntaxToken(TRIPLE_PLUS_TOKEN, "+++", 11, row, 3),
-		SyntaxToken(MINUS_MINUS_TOKEN, "--", 15, row, 2),
-		SyntaxToken(PLUS_EQUAL_TOKEN, "+=", 18, row, 2),
-		SyntaxToken(MINUS_EQUAL_TOKEN, "-=", 21, row, 2),
-		SyntaxToken(STAR_EQUAL_TOKEN, "*=", 24, row, 2),
-		SyntaxToken(SLASH_EQUAL_TOKEN, "/=", 27, row, 2),
-		SyntaxToken(EQUAL_TOKEN, "=", 30, row, 1),
-		SyntaxToken(EQUAL_EQUAL_TOKEN, "==", 32, row, 2),
-		SyntaxToken(BANG_EQUAL_TOKEN, "!=", 35, row, 2),
-		SyntaxToken(AMPERSAND_AMPERSAND_TOKEN, "&&", 38, row, 2),
-		SyntaxToken(PIPE_PIPE_TOKEN, "||", 41, row, 2),
-		SyntaxToken(COMMA_TOKEN, ",", 44, row, 1),
-		SyntaxToken(END_OF_FILE_TOKEN, "", 45, row, 0)
+		SyntaxToken(PLUS_TOKEN, "+", 0, 1),
+		SyntaxToken(MINUS_TOKEN, "-", 2, 1),
+		SyntaxToken(STAR_TOKEN, "*", 4, 1),
+		SyntaxToken(SLASH_TOKEN, "/", 6, 1),
+		SyntaxToken(PLUS_PLUS_TOKEN, "++", 8, 2),
+		SyntaxToken(TRIPLE_PLUS_TOKEN, "+++", 11, 3),
+		SyntaxToken(MINUS_MINUS_TOKEN, "--", 15, 2),
+		SyntaxToken(PLUS_EQUAL_TOKEN, "+=", 18, 2),
+		SyntaxToken(MINUS_EQUAL_TOKEN, "-=", 21, 2),
+		SyntaxToken(STAR_EQUAL_TOKEN, "*=", 24, 2),
+		SyntaxToken(SLASH_EQUAL_TOKEN, "/=", 27, 2),
+		SyntaxToken(EQUAL_TOKEN, "=", 30, 1),
+		SyntaxToken(EQUAL_EQUAL_TOKEN, "==", 32, 2),
+		SyntaxToken(BANG_EQUAL_TOKEN, "!=", 35, 2),
+		SyntaxToken(AMPERSAND_AMPERSAND_TOKEN, "&&", 38, 2),
+		SyntaxToken(PIPE_PIPE_TOKEN, "||", 41, 2),
+		SyntaxToken(COMMA_TOKEN, ",", 44, 1),
+		SyntaxToken(END_OF_FILE_TOKEN, "", 45, 0)
 	};
-	std::vector<SyntaxToken> lexer_output = lexer.LexAll();
+	TokenBuffer lexer_output = lexer.LexAll();
 	AssertEqSyntaxTokens(expected_output, lexer_output);
 }
 
@@ -131,15 +125,14 @@ TEST_F(LexerTest, BoolTokensLexer)
 {
 	program = "true false true true";
 	SetUp();
-	int row = 0;
 	std::vector<SyntaxToken> expected_output = {
-		SyntaxToken(TRUE_TOKEN, "true", 0, row, 4),
-		SyntaxToken(FALSE_TOKEN, "false", 5, row, 5),
-		SyntaxToken(TRUE_TOKEN, "true", 11, row, 4),
-		SyntaxToken(TRUE_TOKEN, "true", 16, row, 4),
-		SyntaxToken(END_OF_FILE_TOKEN, "", 20, row, 0)
+		SyntaxToken(TRUE_TOKEN, "true", 0, 4),
+		SyntaxToken(FALSE_TOKEN, "false", 5, 5),
+		SyntaxToken(TRUE_TOKEN, "true", 11, 4),
+		SyntaxToken(TRUE_TOKEN, "true", 16, 4),
+		SyntaxToken(END_OF_FILE_TOKEN, "", 20, 0)
 	};
-	std::vector<SyntaxToken> lexer_output = lexer.LexAll();
+	TokenBuffer lexer_output = lexer.LexAll();
 	AssertEqSyntaxTokens(expected_output, lexer_output);
 }
 
@@ -147,15 +140,14 @@ TEST_F(LexerTest, IdentifierLiteralsLexer)
 {
 	program = "var1 _vs2 VARIA __MALO__";
 	SetUp();
-	int row = 0;
 	std::vector<SyntaxToken> expected_output = {
-		SyntaxToken(IDENTIFIER_TOKEN, "var1", 0, row, 4),
-		SyntaxToken(IDENTIFIER_TOKEN, "_vs2", 5, row, 4),
-		SyntaxToken(IDENTIFIER_TOKEN, "VARIA", 10, row, 5),
-		SyntaxToken(IDENTIFIER_TOKEN, "__MALO__", 16, row, 8),
-		SyntaxToken(END_OF_FILE_TOKEN, "", 24, row, 0)
+		SyntaxToken(IDENTIFIER_TOKEN, "var1", 0, 4),
+		SyntaxToken(IDENTIFIER_TOKEN, "_vs2", 5, 4),
+		SyntaxToken(IDENTIFIER_TOKEN, "VARIA", 10, 5),
+		SyntaxToken(IDENTIFIER_TOKEN, "__MALO__", 16, 8),
+		SyntaxToken(END_OF_FILE_TOKEN, "", 24, 0)
 	};
-	std::vector<SyntaxToken> lexer_output = lexer.LexAll();
+	TokenBuffer lexer_output = lexer.LexAll();
 	AssertEqSyntaxTokens(expected_output, lexer_output);
 }
 
@@ -163,13 +155,12 @@ TEST_F(LexerTest, StringLiteralsLexer)
 {
 	program = "\"hello\" \"world\"";
 	SetUp();
-	int row = 0;
 	std::vector<SyntaxToken> expected_output = {
-		SyntaxToken(STRING_LITERAL_TOKEN, "hello", 1, row, 5),
-		SyntaxToken(STRING_LITERAL_TOKEN, "world", 9, row, 5),
-		SyntaxToken(END_OF_FILE_TOKEN, "", 15, row, 0)
+		SyntaxToken(STRING_LITERAL_TOKEN, "hello", 1, 5),
+		SyntaxToken(STRING_LITERAL_TOKEN, "world", 9, 5),
+		SyntaxToken(END_OF_FILE_TOKEN, "", 15, 0)
 	};
-	std::vector<SyntaxToken> lexer_output = lexer.LexAll();
+	TokenBuffer lexer_output = lexer.LexAll();
 	AssertEqSyntaxTokens(expected_output, lexer_output);
 }
 
@@ -177,54 +168,309 @@ TEST_F(LexerTest, NumberLiteralsLexer)
 {
 	program = "2 123 1465 94";
 	SetUp();
-	int row = 0;
 	std::vector<SyntaxToken> expected_output = {
-		SyntaxToken(NUMBER_LITERAL_TOKEN, "2", 0, row, 1),
-		SyntaxToken(NUMBER_LITERAL_TOKEN, "123", 2, row, 3),
-		SyntaxToken(NUMBER_LITERAL_TOKEN, "1465", 6, row, 4),
-		SyntaxToken(NUMBER_LITERAL_TOKEN, "94", 11, row, 2),
-		SyntaxToken(END_OF_FILE_TOKEN, "", 13, row, 0)
+		SyntaxToken(NUMBER_LITERAL_TOKEN, "2", 0, 1),
+		SyntaxToken(NUMBER_LITERAL_TOKEN, "123", 2, 3),
+		SyntaxToken(NUMBER_LITERAL_TOKEN, "1465", 6, 4),
+		SyntaxToken(NUMBER_LITERAL_TOKEN, "94", 11, 2),
+		SyntaxToken(END_OF_FILE_TOKEN, "", 13, 0)
 	};
-	std::vector<SyntaxToken> lexer_output = lexer.LexAll();
+	TokenBuffer lexer_output = lexer.LexAll();
 	AssertEqSyntaxTokens(expected_output, lexer_output);
 }
 
+// Too long for a long long, but a valid double.
+TEST_F(LexerTest, WideIntegerLiteralLexer)
+{
+	program = "99999999999999999999";
+	SetUp();
+	TokenBuffer lexer_output = lexer.LexAll();
+	ASSERT_EQ(lexer_output.Kind(0), NUMBER_LITERAL_TOKEN);
+
+	const NumberLiteral& number = lexer_output.Number(0);
+	ASSERT_FALSE(number.is_floating);
+	ASSERT_FALSE(number.integer_fits);
+	ASSERT_TRUE(number.real_fits);
+	ASSERT_EQ(number.real, 1e20);
+}
+
 TEST_F(LexerTest, FunctionDeclarationLexer)
 {
 	program = "int f(int a, int b){print a + b;}f(2, 52);";
 	SetUp();
-	int row = 0;
 
 	std::vector<SyntaxToken> expected_output = {
-		SyntaxToken(INT_TYPE, DisplayToken(INT_TYPE), 0, row, 3),
-		SyntaxToken(IDENTIFIER_TOKEN, "f", 4, row, 1),
-		SyntaxToken(OPEN_PAREN, "(", 5, row, 1),
-		SyntaxToken(INT_TYPE, DisplayToken(INT_TYPE), 6, row, 3),
-		SyntaxToken(IDENTIFIER_TOKEN, "a", 10, row, 1),
-		SyntaxToken(COMMA_TOKEN, ",", 11, row, 1),
-		SyntaxToken(INT_TYPE, DisplayToken(INT_TYPE), 13, row, 3),
-		SyntaxToken(IDENTIFIER_TOKEN, "b", 17, row, 1),
-		SyntaxToken(CLOSE_PAREN, ")", 18, row, 1),
-		SyntaxToken(OPEN_CURLY_BRACKET, "{", 19, row, 1),
-		SyntaxToken(PRINT_KW, DisplayToken(PRINT_KW), 20, row, 5),
-		SyntaxToken(IDENTIFIER_TOKEN, "a", 26, row, 1),
-		SyntaxToken(PLUS_TOKEN, "+", 28, row, 1),
-		SyntaxToken(IDENTIFIER_TOKEN, "b", 30, row, 1),
-		SyntaxToken(SEMICOLON_TOKEN, ";", 31, row, 1),
-		SyntaxToken(CLOSE_CURLY_BRACKET, "}", 32, row ,1),
-		SyntaxToken(IDENTIFIER_TOKEN, "f", 33, row, 1),
-		SyntaxToken(OPEN_PAREN, "(", 34, row, 1),
-		SyntaxToken(NUMBER_LITERAL_TOKEN, "2", 35, row, 1),
-		SyntaxToken(COMMA_TOKEN, ",", 36, row, 1),
-		SyntaxToken(NUMBER_LITERAL_TOKEN, "52", 38, row, 2),
-		SyntaxToken(CLOSE_PAREN, ")", 40, row, 1),
-		SyntaxToken(SEMICOLON_TOKEN, ";", 41, row ,1),
-
-		SyntaxToken(END_OF_FILE_TOKEN, "", 42, row, 0)
+		SyntaxToken(INT_TYPE, DisplayToken(INT_TYPE), 0, 3),
+		SyntaxToken(IDENTIFIER_TOKEN, "f", 4, 1),
+		SyntaxToken(OPEN_PAREN, "(", 5, 1),
+		SyntaxToken(INT_TYPE, DisplayToken(INT_TYPE), 6, 3),
+		SyntaxToken(IDENTIFIER_TOKEN, "a", 10, 1),
+		SyntaxToken(COMMA_TOKEN, ",", 11, 1),
+		SyntaxToken(INT_TYPE, DisplayToken(INT_TYPE), 13, 3),
+		SyntaxToken(IDENTIFIER_TOKEN, "b", 17, 1),
+		SyntaxToken(CLOSE_PAREN, ")", 18, 1),
+		SyntaxToken(OPEN_CURLY_BRACKET, "{", 19, 1),
+		SyntaxToken(PRINT_KW, DisplayToken(PRINT_KW), 20, 5),
+		SyntaxToken(IDENTIFIER_TOKEN, "a", 26, 1),
+		SyntaxToken(PLUS_TOKEN, "+", 28, 1),
+		SyntaxToken(IDENTIFIER_TOKEN, "b", 30, 1),
+		SyntaxToken(SEMICOLON_TOKEN, ";", 31, 1),
+		SyntaxToken(CLOSE_CURLY_BRACKET, "}", 32,1),
+		SyntaxToken(IDENTIFIER_TOKEN, "f", 33, 1),
+		SyntaxToken(OPEN_PAREN, "(", 34, 1),
+		SyntaxToken(NUMBER_LITERAL_TOKEN, "2", 35, 1),
+		SyntaxToken(COMMA_TOKEN, ",", 36, 1),
+		SyntaxToken(NUMBER_LITERAL_TOKEN, "52", 38, 2),
+		SyntaxToken(CLOSE_PAREN, ")", 40, 1),
+		SyntaxToken(SEMICOLON_TOKEN, ";", 41,1),
+
+		SyntaxToken(END_OF_FILE_TOKEN, "", 42, 0)
 	};
 
-	std::vector<SyntaxToken> lexer_output = lexer.LexAll();
+	TokenBuffer lexer_output = lexer.LexAll();
 
 	AssertEqSyntaxTokens(expected_output, lexer_output);
 }
 
+
+TEST_F(LexerTest, TokensViewSourceLexer)
+{
+	program = "int value = 42; print \"text\";";
+	SetUp();
+
+	TokenBuffer lexer_output = lexer.LexAll();
+	for (size_t i = 0; i < lexer_output.Size(); i++)
+	{
+		SyntaxToken token = lexer_output.At(i);
+		if (token.GetToken_t() == IDENTIFIER_TOKEN || token.GetToken_t() == NUMBER_LITERAL_TOKEN ||
+			token.GetToken_t() == STRING_LITERAL_TOKEN || token.GetToken_t() == INT_TYPE)
+		{
+			ASSERT_EQ(token.GetValue().data(), program.data() + token.GetPos());
+		}
+	}
+}
+
+TEST_F(LexerTest, NearKeywordIdentifiersLexer)
+{
+	program = "in ints\tdoubl fals iff Print returned";
+	SetUp();
+	std::vector<SyntaxToken> expected_output = {
+		SyntaxToken(IDENTIFIER_TOKEN, "in", 0, 2),
+		SyntaxToken(IDENTIFIER_TOKEN, "ints", 3, 4),
+		SyntaxToken(IDENTIFIER_TOKEN, "doubl", 8, 5),
+		SyntaxToken(IDENTIFIER_TOKEN, "fals", 14, 4),
+		SyntaxToken(IDENTIFIER_TOKEN, "iff", 19, 3),
+		SyntaxToken(IDENTIFIER_TOKEN, "Print", 23, 5),
+		SyntaxToken(IDENTIFIER_TOKEN, "returned", 29, 8),
+		SyntaxToken(END_OF_FILE_TOKEN, "", 37, 0)
+	};
+	TokenBuffer lexer_output = lexer.LexAll();
+	AssertEqSyntaxTokens(expected_output, lexer_output);
+}
+
+TEST_F(LexerTest, CommentsAndLinesLexer)
+{
+	program = "a /* one\ntwo */\n\n  b\t/**/ \"x\ny\" c !d";
+	SetUp();
+	std::vector<SyntaxToken> expected_output = {
+		SyntaxToken(IDENTIFIER_TOKEN, "a", 0, 1),
+		SyntaxToken(IDENTIFIER_TOKEN, "b", 19, 1),
+		SyntaxToken(STRING_LITERAL_TOKEN, "x\ny", 27, 3),
+		SyntaxToken(IDENTIFIER_TOKEN, "c", 32, 1),
+		SyntaxToken(BANG_TOKEN, "!", 34, 1),
+		SyntaxToken(IDENTIFIER_TOKEN, "d", 35, 1),
+		SyntaxToken(END_OF_FILE_TOKEN, "", 36, 0)
+	};
+	TokenBuffer lexer_output = lexer.LexAll();
+	AssertEqSyntaxTokens(expected_output, lexer_output);
+	ASSERT_TRUE(lexer.GetErrorReports().empty());
+
+	std::vector<std::pair<uint32_t, uint32_t>> locations = { { 1, 1 }, { 4, 3 }, { 4, 11 }, { 5, 4 }, { 5, 6 }, { 5, 7 }, { 5, 8 } };
+	for (size_t i = 0; i < lexer_output.Size(); i++)
+	{
+		SourceLocation location = lexer_output.Locate(i);
+		ASSERT_EQ(location.line, locations[i].first);
+		ASSERT_EQ(location.column, locations[i].second);
+	}
+}
+
+TEST_F(LexerTest, UnterminatedLexer)
+{
+	program = "print 1; /* no end *";
+	SetUp();
+	TokenBuffer lexer_output = lexer.LexAll();
+	ASSERT_EQ(lexer_output.Kind(lexer_output.Size() - 1), BAD_TOKEN);
+	ASSERT_EQ(lexer.GetErrorReports().size(), 1);
+	ASSERT_EQ(lexer.GetErrorReports()[0], "Unterminated comment starting at line 1, column 10.");
+
+	program = "print \"no end;\n";
+	SetUp();
+	lexer_output = lexer.LexAll();
+	ASSERT_EQ(lexer_output.Kind(lexer_output.Size() - 1), BAD_TOKEN);
+	ASSERT_EQ(lexer.GetErrorReports().size(), 1);
+	ASSERT_EQ(lexer.GetErrorReports()[0], "Unterminated string literal starting at line 1, column 7.");
+}
+
+TEST_F(LexerTest, IdentifiersInternedLexer)
+{
+	program = "alpha beta alpha int alpha2";
+	SetUp();
+	TokenBuffer lexer_output = lexer.LexAll();
+
+	Symbol alpha = lexer_output.At(0).GetSymbol();
+	ASSERT_EQ(lexer_output.At(2).GetSymbol(), alpha);
+	ASSERT_NE(lexer_output.At(1).GetSymbol(), alpha);
+	ASSERT_NE(lexer_output.At(4).GetSymbol(), alpha);
+	ASSERT_EQ(lexer_output.At(3).GetSymbol(), NO_SYMBOL);
+	ASSERT_EQ(Symbols().Intern("alpha"), alpha);
+	ASSERT_EQ(SymbolName(alpha), "alpha");
+}
+
+// Long literals, a far jump across a comment and every kind of number
+// literal read back from the packed buffer as Lex() produced them.
+TEST_F(LexerTest, PackedTokenBufferLexer)
+{
+	program = "a = \"" + std::string(300, 's') + "\"; b = 7 + 2147483648 + 0.5 + 99999999999999999999;\n";
+	program += "/*" + std::string(70000, '.') + "*/ c = 1; " + std::string(260, 'i') + " = 3.25;";
+	for (int i = 0; i < 100; i++)
+	{
+		program += " d = d + " + std::to_string(i) + ";";
+	}
+	SetUp();
+	TokenBuffer lexer_output = lexer.LexAll();
+
+	Lexer sequential(program);
+	for (size_t i = 0; i < lexer_output.Size(); i++)
+	{
+		SyntaxToken token = sequential.Lex();
+		ASSERT_EQ(lexer_output.Kind(i), token.GetToken_t());
+		ASSERT_EQ(lexer_output.Offset(i), token.GetPos());
+		ASSERT_EQ(lexer_output.Length(i), token.GetLen());
+		ASSERT_EQ(lexer_output.Text(i), token.GetValue());
+		ASSERT_EQ(lexer_output.At(i).GetSymbol(), token.GetSymbol());
+		if (token.GetToken_t() == NUMBER_LITERAL_TOKEN)
+		{
+			NumberLiteral expected = sequential.GetNumber();
+			NumberLiteral actual = lexer_output.Number(i);
+			ASSERT_EQ(actual.is_floating, expected.is_floating);
+			ASSERT_EQ(actual.integer_fits, expected.integer_fits);
+			ASSERT_EQ(actual.real_fits, expected.real_fits);
+			ASSERT_EQ(actual.integer, expected.integer);
+			ASSERT_EQ(actual.real, expected.real);
+		}
+	}
+	ASSERT_LT(lexer_output.BytesUsed(), lexer_output.Size() * 8);
+}
+
+TEST_F(LexerTest, TokenStreamLexer)
+{
+	program = "int a = 1; /* c */ a = a + 2.5; print \"s\";";
+	SetUp();
+	TokenBuffer lexer_output = lexer.LexAll();
+	TokenStream stream(program);
+
+	for (size_t i = 0; i < lexer_output.Size(); i++)
+	{
+		ASSERT_EQ(stream.Kind(i), lexer_output.Kind(i));
+		ASSERT_EQ(stream.Text(i), lexer_output.Text(i));
+		ASSERT_EQ(stream.Lexed(), i + 1);
+		if (lexer_output.Kind(i) == IDENTIFIER_TOKEN)
+		{
+			ASSERT_EQ(stream.At(i).GetSymbol(), lexer_output.At(i).GetSymbol());
+		}
+		if (lexer_output.Kind(i) == NUMBER_LITERAL_TOKEN)
+		{
+			ASSERT_EQ(stream.Number(i).real, lexer_output.Number(i).real);
+		}
+	}
+	ASSERT_FALSE(stream.Has(lexer_output.Size()));
+	ASSERT_EQ(stream.Kind(lexer_output.Size() + 5), END_OF_FILE_TOKEN);
+	ASSERT_THROW(stream.Kind(0), std::invalid_argument);
+}
+
+// Past the end of a buffer longer than the window, the final token is
+// still the one returned.
+TEST_F(LexerTest, BufferedTokenStreamLexer)
+{
+	program = "{ int a = 1; a = a + 2; print a; }";
+	SetUp();
+	TokenBuffer lexer_output = lexer.LexAll();
+	ASSERT_TRUE(lexer_output.Size() > TokenStream::WINDOW);
+	TokenStream stream("");
+	stream.UseBuffer(lexer_output);
+
+	size_t last = lexer_output.Size() - 1;
+	ASSERT_FALSE(stream.Has(lexer_output.Size()));
+	for (size_t past : { lexer_output.Size(), lexer_output.Size() + 3, lexer_output.Size() + 100 })
+	{
+		ASSERT_EQ(stream.Kind(past), END_OF_FILE_TOKEN);
+		ASSERT_EQ(stream.At(past).GetPos(), lexer_output.Offset(last));
+	}
+	ASSERT_EQ(stream.Kind(0), OPEN_CURLY_BRACKET); // nothing leaves a buffer
+}
+
+static void AssertSameTokens(const TokenBuffer& expected, const TokenBuffer& actual)
+{
+	ASSERT_EQ(actual.Size(), expected.Size());
+	for (size_t i = 0; i < expected.Size(); i++)
+	{
+		ASSERT_EQ(actual.Kind(i), expected.Kind(i));
+		ASSERT_EQ(actual.Offset(i), expected.Offset(i));
+		ASSERT_EQ(actual.Length(i), expected.Length(i));
+		ASSERT_EQ(actual.At(i).GetSymbol(), expected.At(i).GetSymbol());
+		if (expected.Kind(i) == NUMBER_LITERAL_TOKEN)
+		{
+			NumberLiteral expected_number = expected.Number(i);
+			NumberLiteral actual_number = actual.Number(i);
+			ASSERT_EQ(actual_number.is_floating, expected_number.is_floating);
+			ASSERT_EQ(actual_number.integer_fits, expected_number.integer_fits);
+			ASSERT_EQ(actual_number.integer, expected_number.integer);
+			ASSERT_EQ(actual_number.real, expected_number.real);
+		}
+	}
+}
+
+TEST_F(LexerTest, ParallelLexer)
+{
+	std::string body;
+	for (int i = 0; i < 50; i++)
+	{
+		std::string n = std::to_string(i);
+		body += "int v" + n + " = " + n + ";\n";
+		body += "/* comment\n with \"quotes\" and\n newlines " + n + " */ print \"str /* not\n a comment " + n + "\";\n";
+		body += "d" + n + " = d" + n + " * 1.5 / v" + n + ";   \n\n";
+	}
+	std::vector<std::string> programs = {
+		body,
+		body + "print \"unterminated\n" + body,
+		body + "int # = 1;\n" + body,
+		body + "/* unterminated\n" + body,
+		"\n\n\n" + body + "   ",
+		// offsets and lengths past the packed fields, and packed literals
+		body + "print \"" + std::string(300, 's') + "\";\n/*" + std::string(70000, ' ') + "*/\nlong w = 3000000000 * 99999999999999999999;\n" + body
+	};
+	for (std::string& text : programs)
+	{
+		for (size_t threads : { 2, 3, 7 })
+		{
+			Lexer sequential(text);
+			TokenBuffer expected = sequential.LexAll();
+			Lexer parallel(text);
+			TokenBuffer actual = parallel.LexAllParallel(threads, 1);
+			AssertSameTokens(expected, actual);
+			ASSERT_EQ(parallel.GetErrorReports(), sequential.GetErrorReports());
+		}
+	}
+
+	// names seen for the first time get ids in source order, as with LexAll()
+	std::string fresh;
+	for (int i = 0; i < 100; i++)
+	{
+		fresh += "parallel_fresh_" + std::to_string(i) + ";\n";
+	}
+	TokenBuffer tokens = Lexer(fresh).LexAllParallel(4, 1);
+	for (size_t i = 2; i + 1 < tokens.Size(); i += 2)
+	{
+		ASSERT_EQ(tokens.At(i).GetSymbol(), tokens.At(i - 2).GetSymbol() + 1);
+	}
+}
@@ -0,0 +1,119 @@
+#include "pch.h"
+#include "parser.hpp"
+#include "resolver.hpp"
+#include "optimizer.hpp"
+#include "typechecker.hpp"
+#include "inliner.hpp"
+#include "interpret.hpp"
+#include "ast_node_headers.hpp"
+#include <vector>
+
+class OptimizerTest : public testing::Test
+{
+protected:
+	OptimizerStats Optimize()
+	{
+		EnvStack envstack;
+		Parser parser(program, std::move(envstack), function_memory);
+		ast = parser.Parse();
+		EXPECT_TRUE(parser.GetErrorReports().empty());
+		Resolver resolver(function_memory);
+		EXPECT_TRUE(resolver.Resolve(statements).empty());
+		Optimizer optimizer(ast.arena, function_memory, resolver.GetGlobalSlotCount());
+		optimizer.Optimize(statements);
+		return optimizer.GetStats();
+	}
+
+	std::string program;
+	FunctionMemory function_memory;
+	Program ast;
+	std::vector<AstNode*>& statements = ast.statements;
+};
+
+TEST_F(OptimizerTest, FoldsConstantsOptimizer)
+{
+	program = "print 1 + 2 + 4.5; print 1 / 0; int a = 1; print a + 1; a = 2;";
+	OptimizerStats stats = Optimize();
+
+	NumberNode* folded = NodeCast<NumberNode>(NodeCast<PrintStmtNode>(statements.at(0))->expression);
+	ASSERT_NE(folded, nullptr);
+	ASSERT_EQ(folded->number.type, VAL_DOUBLE);
+	ASSERT_DOUBLE_EQ(folded->number.as.d, 7.5);
+
+	// left to throw at run time
+	ASSERT_NE(NodeCast<BinaryExpression>(NodeCast<PrintStmtNode>(statements.at(1))->expression), nullptr);
+	// assigned again
+	ASSERT_NE(NodeCast<BinaryExpression>(NodeCast<PrintStmtNode>(statements.at(3))->expression), nullptr);
+	ASSERT_EQ(stats.folded, 2);
+	ASSERT_EQ(stats.propagated, 0);
+	ASSERT_LT(stats.nodes_after, stats.nodes_before);
+}
+
+TEST_F(OptimizerTest, PropagatesAndPrunesOptimizer)
+{
+	program = "int k = 2 + 2; if (k == 4) { print k; } if (k != 4) { print 0; } int f(int n){ int m = k; print n + m; }";
+	OptimizerStats stats = Optimize();
+
+	// the first if is replaced by its block, the second dropped
+	ASSERT_EQ(statements.size(), 2);
+	BlockStmtNode* block = NodeCast<BlockStmtNode>(statements.at(1));
+	ASSERT_NE(block, nullptr);
+	NumberNode* k = NodeCast<NumberNode>(NodeCast<PrintStmtNode>(block->stmts[0])->expression);
+	ASSERT_NE(k, nullptr);
+	ASSERT_EQ(k->number.as.i, 4);
+	ASSERT_EQ(stats.pruned, 2);
+
+	// a global read from a function, and a parameter, stay reads
+	FuncVariable& f = function_memory.GetRef(Symbols().Intern("f"));
+	BlockStmtNode* body = NodeCast<BlockStmtNode>(f.block_stmt);
+	ASSERT_NE(NodeCast<IdentifierNode>(NodeCast<VarDeclarationNode>(body->stmts[0])->expression), nullptr);
+	ASSERT_NE(NodeCast<BinaryExpression>(NodeCast<PrintStmtNode>(body->stmts[1])->expression), nullptr);
+}
+
+TEST_F(OptimizerTest, PropagatesOnlyOptimizer)
+{
+	// nothing folds before the reads of s are propagated
+	program = "int s = 3; print s; print s;";
+	OptimizerStats stats = Optimize();
+
+	for (size_t i = 1; i < 3; i++)
+	{
+		NumberNode* s = NodeCast<NumberNode>(NodeCast<PrintStmtNode>(statements.at(i))->expression);
+		ASSERT_NE(s, nullptr);
+		ASSERT_EQ(s->number.as.i, 3);
+	}
+	ASSERT_EQ(stats.propagated, 2);
+	ASSERT_EQ(stats.folded, 0);
+}
+
+TEST_F(OptimizerTest, InlinesLeafCallsOptimizer)
+{
+	program = "int total = 0; int add(int a, int b){ int t = a - b; total = total + t; } "
+		"int twice(int a){ add(a, 1); add(a, 2); } int count(int n){ if (n != 0) { count(n - 1); } } "
+		"int a = 10; twice(a); { int b = 1; twice(b); print b; } count(3); print total; print a;";
+	EnvStack envstack;
+	Parser parser(program, std::move(envstack), function_memory);
+	ast = parser.Parse();
+	ASSERT_TRUE(parser.GetErrorReports().empty());
+	Resolver resolver(function_memory);
+	ASSERT_TRUE(resolver.Resolve(statements).empty());
+	TypeChecker type_checker(function_memory, resolver.GetGlobalSlotCount());
+	type_checker.Check(statements);
+	Inliner inliner(ast.arena, function_memory, resolver.GetGlobalSlotCount());
+	inliner.Inline(statements);
+
+	// add goes into twice, then twice into the top level; count is recursive
+	ASSERT_EQ(inliner.GetStats().calls, 4);
+	ASSERT_NE(NodeCast<BlockStmtNode>(statements.at(2)), nullptr);
+	ASSERT_NE(NodeCast<FunctionCallExpr>(statements.at(4)), nullptr);
+	ASSERT_GT(inliner.GetGlobalSlotCount(), resolver.GetGlobalSlotCount());
+
+	Interpreter interpreter(function_memory, inliner.GetGlobalSlotCount());
+	testing::internal::CaptureStdout();
+	for (AstNode* stmt : statements)
+	{
+		interpreter.Interpret(stmt);
+	}
+	ASSERT_EQ(testing::internal::GetCapturedStdout(), "11610");
+	ASSERT_TRUE(interpreter.GetRuntimeErrors().empty());
+}
@@ -1,14 +1,44 @@
 #include "pch.h"
 #include "parser.hpp"
+#include "resolver.hpp"
+#include "flatast.hpp"
 #include "ast_node_headers.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
 #include <vector>
 
+// Every global operator new in the test binary, so a test can check what a
+// stretch of code allocates.
+static std::atomic<size_t> allocation_count{ 0 };
+
+void* operator new(size_t size)
+{
+	allocation_count++;
+	void* memory = std::malloc(size == 0 ? 1 : size);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
 class ParserTest : public testing::Test
 {
 protected:
 	void SetUp() override
 	{
-		
+
 	}
 
 	void TearDown() override
@@ -16,28 +46,360 @@ protected:
 
 	}
 
-	Parser InitParser()
+	Program Parse()
 	{
 		EnvStack envstack;
-		FunctionMemory functionMemory;
-		return Parser(program, std::move(envstack), functionMemory);
+		Parser parser(program, std::move(envstack), function_memory);
+		Program ast = parser.Parse();
+		EXPECT_TRUE(parser.GetErrorReports().empty());
+		return ast;
 	}
 
 	std::string program;
-	
+	FunctionMemory function_memory;
 };
 
 TEST_F(ParserTest, SimpleBinaryExpressionParser)
 {
 	program = "2+3";
-	Parser parser = InitParser();
-	std::vector<std::unique_ptr<AstNode>> statements = parser.Parse();
-	
-	std::unique_ptr<BinaryExpression> expected = std::make_unique<BinaryExpression>(std::make_unique<NumberNode>(2), SyntaxToken(PLUS_TOKEN, "+", 1, 0, 1), std::make_unique<NumberNode>(3));
+	Program ast = Parse();
+
+	ASSERT_EQ(ast.statements.size(), 1);
+	BinaryExpression* stmt_parsed = NodeCast<BinaryExpression>(ast.statements.back());
+	ASSERT_NE(stmt_parsed, nullptr);
+	ASSERT_EQ(stmt_parsed->op, PLUS_TOKEN);
+
+	NumberNode* left = NodeCast<NumberNode>(stmt_parsed->left);
+	NumberNode* right = NodeCast<NumberNode>(stmt_parsed->right);
+	ASSERT_NE(left, nullptr);
+	ASSERT_NE(right, nullptr);
+	ASSERT_EQ(left->number.As<int>(), 2);
+	ASSERT_EQ(right->number.As<int>(), 3);
+}
+
+TEST_F(ParserTest, FunctionBodyInArenaParser)
+{
+	program = "int f(int x){ print x; } f(1);";
+	Program ast = Parse();
+
+	ASSERT_EQ(ast.statements.size(), 1);
+	FunctionCallExpr* call = NodeCast<FunctionCallExpr>(ast.statements.back());
+	ASSERT_NE(call, nullptr);
+	ASSERT_EQ(SymbolName(call->identifier), "f");
+	ASSERT_EQ(call->arguments.size(), 1);
+
+	BlockStmtNode* body = NodeCast<BlockStmtNode>(function_memory.GetRef(Symbols().Intern("f")).block_stmt);
+	ASSERT_NE(body, nullptr);
+	ASSERT_EQ(body->stmts.size(), 1);
+	ASSERT_GT(ast.arena.BytesUsed(), sizeof(BlockStmtNode) + sizeof(FunctionCallExpr));
+}
+
+// The arguments span more tokens than the TokenStream window, so the
+// name of the function has left it by the time the call node is built.
+TEST_F(ParserTest, LongCallArgumentsParser)
+{
+	program = "int f(int a, int b){ print a; } f(1 + 2 + 3 + 4 + 5, 6 * 7 * 8 * 9);";
+	for (ParseMode mode : { PARSE_STREAMING, PARSE_PIPELINED })
+	{
+		FunctionMemory memory;
+		Parser parser(program, EnvStack(), memory, mode);
+		Program ast = parser.Parse();
+		ASSERT_TRUE(parser.GetErrorReports().empty());
+
+		ASSERT_EQ(ast.statements.size(), 1);
+		FunctionCallExpr* call = NodeCast<FunctionCallExpr>(ast.statements.back());
+		ASSERT_NE(call, nullptr);
+		ASSERT_EQ(SymbolName(call->identifier), "f");
+		ASSERT_EQ(call->arguments.size(), 2);
+	}
+}
+
+TEST_F(ParserTest, TypedNumberLiteralsParser)
+{
+	program = "{ short s = 7; int i = 2.9; long l = 40; float f = 2.5; double d = 1; print 3.25; }";
+	Program ast = Parse();
+
+	ASSERT_EQ(ast.statements.size(), 1);
+	BlockStmtNode* block = NodeCast<BlockStmtNode>(ast.statements.back());
+	ASSERT_NE(block, nullptr);
+	ASSERT_EQ(block->stmts.size(), 6);
+
+	std::vector<Value> expected = { Value((short)7), Value(2), Value((long)40), Value(2.5f), Value(1.0) };
+	for (size_t i = 0; i < expected.size(); i++)
+	{
+		VarDeclarationNode* decl = NodeCast<VarDeclarationNode>(block->stmts[i]);
+		ASSERT_NE(decl, nullptr);
+		NumberNode* number = NodeCast<NumberNode>(decl->expression);
+		ASSERT_NE(number, nullptr);
+		ASSERT_EQ(number->number.type, expected[i].type);
+		ASSERT_EQ(number->number.as.l, expected[i].as.l);
+	}
+	PrintStmtNode* print = NodeCast<PrintStmtNode>(block->stmts[5]);
+	ASSERT_NE(print, nullptr);
+	ASSERT_EQ(static_cast<NumberNode*>(print->expression)->number.As<double>(), 3.25);
+}
+
+TEST_F(ParserTest, NumberLiteralOutOfRangeParser)
+{
+	program = "{\nshort s = 40000;\n}";
+	EnvStack envstack;
+	Parser parser(program, std::move(envstack), function_memory);
+	parser.Parse();
+
+	ASSERT_EQ(parser.GetErrorReports().size(), 1);
+	ASSERT_EQ(parser.GetErrorReports()[0], "Number literal '40000' is out of range for short at line 2, column 11");
+}
+
+TEST_F(ParserTest, PipelinedParser)
+{
+	std::string body;
+	for (int i = 0; i < 2000; i++)
+	{
+		std::string n = std::to_string(i);
+		body += "int pipelined_" + n + " = " + n + ";\nprint pipelined_" + n + " * 2.5;\n";
+	}
+	program = "{\n" + body + "}";
+
+	EnvStack envstack;
+	Parser parser(program, std::move(envstack), function_memory, PARSE_PIPELINED);
+	Program ast = parser.Parse();
+	ASSERT_TRUE(parser.GetErrorReports().empty());
+	ASSERT_EQ(ast.statements.size(), 1);
+	BlockStmtNode* block = NodeCast<BlockStmtNode>(ast.statements[0]);
+	ASSERT_NE(block, nullptr);
+	ASSERT_EQ(block->stmts.size(), 4000);
+	ASSERT_GT(parser.GetPipelineStats().batches, 1);
+
+	// lexer errors arrive with the final token
+	FunctionMemory unterminated_memory;
+	Parser unterminated(body + "print \"open", EnvStack(), unterminated_memory, PARSE_PIPELINED);
+	unterminated.Parse();
+	ASSERT_EQ(unterminated.GetErrorReports().size(), 1);
+	ASSERT_EQ(unterminated.GetErrorReports()[0], "Unterminated string literal starting at line 4001, column 7.");
+
+	// a parser that stops early must still stop the lexer thread
+	FunctionMemory early_memory;
+	{
+		Parser early("short s = 40000;\n" + body, EnvStack(), early_memory, PARSE_PIPELINED);
+		early.Parse();
+		ASSERT_FALSE(early.GetErrorReports().empty());
+	}
+}
+
+static void AssertSameStatements(std::span<AstNode*> expected, std::span<AstNode*> actual)
+{
+	ASSERT_EQ(actual.size(), expected.size());
+	for (size_t i = 0; i < expected.size(); i++)
+	{
+		ASSERT_EQ(actual[i]->kind, expected[i]->kind);
+		BlockStmtNode* expected_block = NodeCast<BlockStmtNode>(expected[i]);
+		if (expected_block != nullptr)
+		{
+			AssertSameStatements(expected_block->stmts, static_cast<BlockStmtNode*>(actual[i])->stmts);
+		}
+		VarDeclarationNode* expected_declaration = NodeCast<VarDeclarationNode>(expected[i]);
+		if (expected_declaration != nullptr && expected_declaration->expression != nullptr)
+		{
+			NumberNode* expected_number = NodeCast<NumberNode>(expected_declaration->expression);
+			NumberNode* actual_number = NodeCast<NumberNode>(static_cast<VarDeclarationNode*>(actual[i])->expression);
+			ASSERT_EQ(actual_number == nullptr, expected_number == nullptr);
+			if (expected_number != nullptr)
+			{
+				ASSERT_EQ(actual_number->number.type, expected_number->number.type);
+			}
+		}
+	}
+}
+
+TEST_F(ParserTest, ParallelFunctionsParser)
+{
+	program = "short g = 1;\n";
+	for (int i = 0; i < 300; i++)
+	{
+		std::string n = std::to_string(i);
+		program += "int f" + n + "(int a, double b) { long l = 3; g = 2; if (a == 0) { print l; } print b + a; }\n";
+	}
+	program += "int outer(int a) { int inner(int b) { float x = 1; print b * x; } inner(a); }\n";
+	program += "{ int blockf(int c) { print c; } }\nf3(1, 2.5);\nouter(4);\n";
+
+	FunctionMemory serial_memory;
+	Parser serial(program, EnvStack(), serial_memory);
+	Program serial_ast = serial.Parse();
+	ASSERT_TRUE(serial.GetErrorReports().empty());
+
+	FunctionMemory parallel_memory;
+	Parser parallel(program, EnvStack(), parallel_memory, PARSE_PARALLEL);
+	Program parallel_ast = parallel.Parse();
+	ASSERT_TRUE(parallel.GetErrorReports().empty());
+
+	AssertSameStatements(serial_ast.statements, parallel_ast.statements);
+	std::vector<Symbol> identifiers = serial_memory.GetIdentifiers();
+	ASSERT_EQ(parallel_memory.GetIdentifiers().size(), identifiers.size());
+	for (Symbol identifier : identifiers)
+	{
+		FuncVariable& expected = serial_memory.GetRef(identifier);
+		FuncVariable& actual = parallel_memory.GetRef(identifier);
+		ASSERT_EQ(actual.return_type, expected.return_type);
+		ASSERT_EQ(actual.parameters.size(), expected.parameters.size());
+		for (size_t i = 0; i < expected.parameters.size(); i++)
+		{
+			ASSERT_EQ(actual.parameters[i].identifier, expected.parameters[i].identifier);
+			ASSERT_EQ(actual.parameters[i].dtType, expected.parameters[i].dtType);
+		}
+		std::span<AstNode*> expected_body = static_cast<BlockStmtNode*>(expected.block_stmt)->stmts;
+		AssertSameStatements(expected_body, static_cast<BlockStmtNode*>(actual.block_stmt)->stmts);
+	}
+
+	// errors come from the serial parser, whatever the mode
+	for (std::string broken : { program + "int f7(int a) { print a; }\n", program + "int h(int a) { short s = 40000; }\n" })
+	{
+		FunctionMemory serial_errors_memory;
+		Parser serial_errors(broken, EnvStack(), serial_errors_memory);
+		serial_errors.Parse();
+		FunctionMemory parallel_errors_memory;
+		Parser parallel_errors(broken, EnvStack(), parallel_errors_memory, PARSE_PARALLEL);
+		parallel_errors.Parse();
+		ASSERT_FALSE(parallel_errors.GetErrorReports().empty());
+		ASSERT_EQ(parallel_errors.GetErrorReports(), serial_errors.GetErrorReports());
+	}
+}
+
+// Redeclarations are printed, not reported; the parallel parse must print
+// them in the serial order, and only once when it falls back.
+TEST_F(ParserTest, ParallelNoticesParser)
+{
+	std::string declarations = "int f(){ int a = 1; int a = 2; } int b = 1; int b = 2; int g(){ int c = 1; int c = 2; }\n";
+	for (std::string source : { declarations, declarations + "int h(int a) { short s = 40000; }\n" })
+	{
+		FunctionMemory serial_memory;
+		Parser serial(source, EnvStack(), serial_memory);
+		testing::internal::CaptureStdout();
+		serial.Parse();
+		std::string serial_output = testing::internal::GetCapturedStdout();
+
+		FunctionMemory parallel_memory;
+		Parser parallel(source, EnvStack(), parallel_memory, PARSE_PARALLEL);
+		testing::internal::CaptureStdout();
+		parallel.Parse();
+		std::string parallel_output = testing::internal::GetCapturedStdout();
+
+		ASSERT_EQ(serial_output, "Identifier 'a' already declared.\nIdentifier 'b' already declared.\nIdentifier 'c' already declared.\n");
+		ASSERT_EQ(parallel_output, serial_output);
+	}
+}
+
+TEST_F(ParserTest, LazyFunctionBodiesParser)
+{
+	program = "short g = 1;\n";
+	program += "int f(int a, double b) { long l = 3; g = 2; if (a == 0) { print l; } print b + a; }\n";
+	program += "int broken(int a) { short s = 40000; }\n";
+	program += "int outer(int a) { int inner(int b) { print b; } inner(a); }\n";
+	program += "f(1, 2.5);\n";
+
+	FunctionMemory serial_memory;
+	Parser serial(program, EnvStack(), serial_memory);
+	Program serial_ast = serial.Parse();
+	ASSERT_FALSE(serial.GetErrorReports().empty()); // 'broken' is reported up front
+
+	Parser lazy(program, EnvStack(), function_memory, PARSE_LAZY);
+	Program ast = lazy.Parse();
+	ASSERT_TRUE(lazy.GetErrorReports().empty());
+	ASSERT_EQ(ast.statements.size(), 2);
+
+	FuncVariable& f = function_memory.GetRef(Symbols().Intern("f"));
+	ASSERT_EQ(f.block_stmt, nullptr);
+	ASSERT_NE(f.lazy_body, nullptr);
+	ASSERT_EQ(f.parameters.size(), 2);
+	// a body declaring functions is parsed up front, so 'inner' exists
+	ASSERT_NE(function_memory.GetRef(Symbols().Intern("outer")).block_stmt, nullptr);
+	ASSERT_TRUE(function_memory.Exist(Symbols().Intern("inner")));
+
+	Resolver resolver(function_memory);
+	ASSERT_TRUE(resolver.Resolve(ast.statements).empty());
+	resolver.Materialize(f);
+	ASSERT_NE(f.block_stmt, nullptr);
+	ASSERT_EQ(f.slot_count, 3);
+
+	// same body as the serial parse, literals typed against the global 'g'
+	FuncVariable& expected = serial_memory.GetRef(Symbols().Intern("f"));
+	std::span<AstNode*> expected_body = static_cast<BlockStmtNode*>(expected.block_stmt)->stmts;
+	AssertSameStatements(expected_body, static_cast<BlockStmtNode*>(f.block_stmt)->stmts);
+
+	FuncVariable& broken = function_memory.GetRef(Symbols().Intern("broken"));
+	ASSERT_THROW(resolver.Materialize(broken), std::invalid_argument);
+	ASSERT_EQ(broken.block_stmt, nullptr);
+}
+
+// Statements, blocks, calls and declarations allocate nothing but arena
+// blocks: parsing the same body twice over only adds the few allocations
+// of vectors that double with the input.
+TEST_F(ParserTest, AllocationFreeParser)
+{
+	std::string body;
+	for (int i = 0; i < 2000; i++)
+	{
+		body += "a = a * 3 + 7 - a * 2; d = d * 1.5 - a; if (a == 0) { long l = 3; l = 4; print l; } f(a, 2 + d); s += 1;\n";
+	}
+	auto allocations = [&](ParseMode mode, int repeat)
+	{
+		program = "{\nint a = 1;\ndouble d = 1.5;\nshort s = 0;\n";
+		for (int i = 0; i < repeat; i++)
+		{
+			program += body;
+		}
+		program += "}\n";
+
+		size_t before = allocation_count;
+		FunctionMemory memory;
+		Parser parser(program, EnvStack(), memory, mode);
+		Program ast = parser.Parse();
+		size_t allocated = allocation_count - before;
+		EXPECT_TRUE(parser.GetErrorReports().empty());
+		return allocated - ast.arena.BlockCount();
+	};
+
+	for (ParseMode mode : { PARSE_STREAMING, PARSE_PIPELINED, PARSE_LAZY })
+	{
+		size_t once = allocations(mode, 1);
+		size_t twice = allocations(mode, 2);
+		ASSERT_LE(twice, once + 8);
+	}
+}
+
+TEST_F(ParserTest, FlatAstParser)
+{
+	program = "int f(int x, double y) { print x; } { int a = 1 + 2 - a; print; if (a == 0) { f(a, 2.5); print \"s\"; } }";
+	Program ast = Parse();
+	ASSERT_EQ(ast.statements.size(), 1);
+
+	FlatAst flat = FlatAst::Flatten(ast.statements);
+	std::vector<NodeKind> expected = {
+		NODE_BLOCK,
+		NODE_VAR_DECLARATION, NODE_BINARY, NODE_BINARY, NODE_NUMBER, NODE_NUMBER, NODE_IDENTIFIER,
+		NODE_PRINT, NODE_EMPTY,
+		NODE_IF, NODE_BINARY, NODE_IDENTIFIER, NODE_NUMBER, NODE_BLOCK,
+		NODE_FUNCTION_CALL, NODE_IDENTIFIER, NODE_NUMBER, NODE_PRINT, NODE_STRING
+	};
+	ASSERT_EQ(flat.Size(), expected.size());
+	for (uint32_t node = 0; node < flat.Size(); node++)
+	{
+		ASSERT_EQ(flat.Kind(node), expected[node]) << "node " << node;
+	}
 
-	ASSERT_EQ(statements.size(), 1);
-	std::unique_ptr<AstNode> stmt = std::move(statements.back());
+	// every subtree ends where the pointer tree says it does
+	ASSERT_EQ(flat.End(0), flat.Size());
+	ASSERT_EQ(flat.ChildCount(0), 3);
+	ASSERT_EQ(flat.Child(0, 1), 7);
+	ASSERT_EQ(flat.End(1), 7);
+	ASSERT_EQ(flat.End(7), 9);
+	ASSERT_EQ(flat.ChildCount(14), 2);
 
-	std::unique_ptr<BinaryExpression> stmt_parsed = std::make_unique<BinaryExpression>(dynamic_cast<BinaryExpression*>(stmt.release()));
-	
+	ASSERT_EQ(flat.Payload(1).operand, Symbols().Intern("a"));
+	ASSERT_EQ(flat.Payload(1).type, INT_TYPE);
+	ASSERT_EQ(flat.Payload(2).operand, MINUS_TOKEN); // 'a + b - c' is '(a + b) - c'
+	ASSERT_EQ(flat.End(3), 6);
+	ASSERT_EQ(flat.Payload(10).operand, EQUAL_EQUAL_TOKEN);
+	ASSERT_EQ(flat.Constant(5).As<int>(), 2);
+	ASSERT_EQ(flat.Constant(16).As<double>(), 2.5);
+	ASSERT_EQ(flat.Constant(18).AsString(), "s");
 }
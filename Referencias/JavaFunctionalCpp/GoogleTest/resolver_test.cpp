@@ -0,0 +1,190 @@
+#include "pch.h"
+#include "parser.hpp"
+#include "resolver.hpp"
+#include "typechecker.hpp"
+#include "interpret.hpp"
+#include "ast_node_headers.hpp"
+#include <vector>
+
+class ResolverTest : public testing::Test
+{
+protected:
+	std::vector<std::string> Resolve()
+	{
+		EnvStack envstack;
+		Parser parser(program, std::move(envstack), function_memory);
+		ast = parser.Parse();
+		EXPECT_TRUE(parser.GetErrorReports().empty());
+		return resolver.Resolve(statements);
+	}
+
+	std::string program;
+	FunctionMemory function_memory;
+	Resolver resolver = Resolver(function_memory);
+	Program ast;
+	std::vector<AstNode*>& statements = ast.statements;
+};
+
+TEST_F(ResolverTest, GlobalSlotsResolver)
+{
+	program = "int a = 1; int b = 2; b = a;";
+	ASSERT_TRUE(Resolve().empty());
+	ASSERT_EQ(statements.size(), 3);
+
+	VarDeclarationNode* a = NodeCast<VarDeclarationNode>(statements.at(0));
+	VarDeclarationNode* b = NodeCast<VarDeclarationNode>(statements.at(1));
+	ASSERT_NE(a, nullptr);
+	ASSERT_NE(b, nullptr);
+	ASSERT_EQ(a->depth, 0);
+	ASSERT_EQ(a->slot, 0);
+	ASSERT_EQ(b->depth, 0);
+	ASSERT_EQ(b->slot, 1);
+
+	VarAssignmentStmtNode* assign = NodeCast<VarAssignmentStmtNode>(statements.at(2));
+	ASSERT_NE(assign, nullptr);
+	ASSERT_EQ(assign->slot, 1);
+	IdentifierNode* read = NodeCast<IdentifierNode>(assign->expression);
+	ASSERT_NE(read, nullptr);
+	ASSERT_EQ(read->depth, 0);
+	ASSERT_EQ(read->slot, 0);
+	ASSERT_EQ(resolver.GetGlobalSlotCount(), 2);
+}
+
+TEST_F(ResolverTest, SiblingBlocksShareSlotsResolver)
+{
+	program = "int a = 1; { int b = 2; int c = 3; } { int d = 4; }";
+	ASSERT_TRUE(Resolve().empty());
+
+	BlockStmtNode* second = NodeCast<BlockStmtNode>(statements.at(2));
+	ASSERT_NE(second, nullptr);
+	VarDeclarationNode* d = NodeCast<VarDeclarationNode>(second->stmts[0]);
+	ASSERT_EQ(d->slot, 1);
+	ASSERT_EQ(resolver.GetGlobalSlotCount(), 3);
+}
+
+TEST_F(ResolverTest, FunctionFrameResolver)
+{
+	program = "int g = 1; int f(int x, int y){ int z = x; g = z; } f(1, 2);";
+	ASSERT_TRUE(Resolve().empty());
+
+	FuncVariable& f = function_memory.GetRef(Symbols().Intern("f"));
+	ASSERT_EQ(f.slot_count, 3);
+	BlockStmtNode* body = NodeCast<BlockStmtNode>(f.block_stmt);
+	VarDeclarationNode* z = NodeCast<VarDeclarationNode>(body->stmts[0]);
+	ASSERT_EQ(z->slot, 2);
+	IdentifierNode* x = NodeCast<IdentifierNode>(z->expression);
+	ASSERT_EQ(x->depth, 0);
+	ASSERT_EQ(x->slot, 0);
+	VarAssignmentStmtNode* g = NodeCast<VarAssignmentStmtNode>(body->stmts[1]);
+	ASSERT_EQ(g->depth, 1);
+	ASSERT_EQ(g->slot, 0);
+}
+
+TEST_F(ResolverTest, ErrorsResolver)
+{
+	program = "{ int a = 1; int a = 2; } print b;";
+	std::vector<std::string> errors = Resolve();
+	ASSERT_EQ(errors.size(), 2);
+	ASSERT_EQ(errors.at(0), "Identifier 'a' already declared.");
+	ASSERT_EQ(errors.at(1), "Variable Identifier 'b' not found.");
+}
+
+TEST_F(ResolverTest, StaticTypesResolver)
+{
+	program = "int a = 1; a = a + 2; short s = 2; s = s * s; int f(double x){ print x + 1; } f(1.5); print a * 2.0;";
+	ASSERT_TRUE(Resolve().empty());
+	TypeChecker type_checker(function_memory, resolver.GetGlobalSlotCount());
+	type_checker.Check(statements);
+
+	VarAssignmentStmtNode* a = NodeCast<VarAssignmentStmtNode>(statements.at(1));
+	ASSERT_EQ(a->expression->static_type, VAL_INT);
+	BinaryExpression* sum = NodeCast<BinaryExpression>(a->expression);
+	ASSERT_EQ(sum->left->static_type, VAL_INT);
+
+	// stored as a short, then as the int 's * s' evaluates to
+	VarAssignmentStmtNode* s = NodeCast<VarAssignmentStmtNode>(statements.at(3));
+	BinaryExpression* product = NodeCast<BinaryExpression>(s->expression);
+	ASSERT_EQ(product->left->static_type, VAL_EMPTY);
+	ASSERT_EQ(product->static_type, VAL_EMPTY);
+
+	FuncVariable& f = function_memory.GetRef(Symbols().Intern("f"));
+	PrintStmtNode* print_x = NodeCast<PrintStmtNode>(NodeCast<BlockStmtNode>(f.block_stmt)->stmts[0]);
+	ASSERT_EQ(print_x->expression->static_type, VAL_DOUBLE);
+
+	PrintStmtNode* print_a = NodeCast<PrintStmtNode>(statements.back());
+	ASSERT_EQ(print_a->expression->static_type, VAL_DOUBLE);
+}
+
+TEST_F(ResolverTest, FunctionHandlesResolver)
+{
+	program = "int g(int n){ print n; } int f(int n){ print n; if (n != 0) { f(n - 1); } } f(2); f(1); g(7);";
+	ASSERT_TRUE(Resolve().empty());
+	FunctionHandle f = function_memory.Find(Symbols().Intern("f"));
+	ASSERT_EQ(function_memory.Find(Symbols().Intern("g")), 0);
+	ASSERT_EQ(f, 1);
+	ASSERT_EQ(&function_memory.At(f), &function_memory.GetRef(Symbols().Intern("f")));
+	ASSERT_THROW(function_memory.Find(Symbols().Intern("h")), std::invalid_argument);
+
+	// each call site keeps the handle of its first call; the body is there
+	// for every later one
+	Interpreter interpreter(function_memory, resolver.GetGlobalSlotCount());
+	testing::internal::CaptureStdout();
+	for (AstNode* stmt : statements)
+	{
+		interpreter.Interpret(stmt);
+	}
+	ASSERT_EQ(testing::internal::GetCapturedStdout(), "210107");
+	ASSERT_TRUE(interpreter.GetRuntimeErrors().empty());
+	ASSERT_EQ(NodeCast<FunctionCallExpr>(statements.at(0))->handle, f);
+	ASSERT_EQ(NodeCast<FunctionCallExpr>(statements.at(1))->handle, f);
+	ASSERT_NE(function_memory.At(f).block_stmt, nullptr);
+}
+
+TEST_F(ResolverTest, GlobalReadBeforeDeclarationResolver)
+{
+	program = "int f(){ print g + 1; } f(); int g = 2;";
+	ASSERT_TRUE(Resolve().empty());
+	TypeChecker type_checker(function_memory, resolver.GetGlobalSlotCount());
+	type_checker.Check(statements);
+
+	// g may not be declared yet when f runs
+	FuncVariable& f = function_memory.GetRef(Symbols().Intern("f"));
+	PrintStmtNode* print_g = NodeCast<PrintStmtNode>(NodeCast<BlockStmtNode>(f.block_stmt)->stmts[0]);
+	ASSERT_EQ(NodeCast<BinaryExpression>(print_g->expression)->left->static_type, VAL_EMPTY);
+
+	Interpreter interpreter(function_memory, resolver.GetGlobalSlotCount());
+	testing::internal::CaptureStdout();
+	interpreter.Interpret(statements.at(0));
+	ASSERT_EQ(testing::internal::GetCapturedStdout(), "");
+	ASSERT_EQ(interpreter.GetRuntimeErrors().size(), 1);
+}
+
+TEST_F(ResolverTest, BlockLocalsPastGlobalsResolver)
+{
+	// f addresses c by slot, so b must not take c's slot
+	program = "int f(){ print c; } { int b = 5; f(); } int c = 7; f();";
+	ASSERT_TRUE(Resolve().empty());
+	VarDeclarationNode* b = NodeCast<VarDeclarationNode>(NodeCast<BlockStmtNode>(statements.at(0))->stmts[0]);
+	VarDeclarationNode* c = NodeCast<VarDeclarationNode>(statements.at(1));
+	ASSERT_NE(b->slot, c->slot);
+
+	Interpreter interpreter(function_memory, resolver.GetGlobalSlotCount());
+	testing::internal::CaptureStdout();
+	interpreter.Interpret(statements.at(0));
+	ASSERT_EQ(testing::internal::GetCapturedStdout(), "");
+	ASSERT_EQ(interpreter.GetRuntimeErrors().size(), 1);
+	ASSERT_EQ(interpreter.GetRuntimeErrors().at(0), "Variable Identifier 'c' not found.");
+
+	// nor may a write to c reach b
+	FunctionMemory lazy_memory;
+	Parser parser("int f(){ c = 1; } { int b = 5; f(); print b; } int c = 7;", EnvStack(), lazy_memory, PARSE_LAZY);
+	Program lazy_ast = parser.Parse();
+	ASSERT_TRUE(parser.GetErrorReports().empty());
+	Resolver lazy_resolver(lazy_memory);
+	ASSERT_TRUE(lazy_resolver.Resolve(lazy_ast.statements).empty());
+	Interpreter lazy_interpreter(lazy_memory, lazy_resolver.GetGlobalSlotCount(), &lazy_resolver);
+	testing::internal::CaptureStdout();
+	lazy_interpreter.Interpret(lazy_ast.statements.at(0));
+	ASSERT_EQ(testing::internal::GetCapturedStdout(), "");
+	ASSERT_EQ(lazy_interpreter.GetRuntimeErrors().size(), 1);
+}
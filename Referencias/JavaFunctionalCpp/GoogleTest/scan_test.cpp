@@ -0,0 +1,60 @@
+#include "pch.h"
+#include "scan.hpp"
+#include <string>
+
+// Inputs long enough to cross several vector blocks, with every interesting
+// byte at every offset of a block.
+static std::string Pattern(std::string filler, char marker, size_t position, size_t size)
+{
+	std::string text;
+	while (text.size() < size)
+	{
+		text += filler;
+	}
+	text.resize(size);
+	if (position < size)
+	{
+		text[position] = marker;
+	}
+	return text;
+}
+
+TEST(ScanTest, KernelsMatchScalarScan)
+{
+	for (size_t size = 0; size < 80; size++)
+	{
+		for (size_t position = 0; position <= size; position++)
+		{
+			for (size_t from = 0; from <= position && from < 40; from++)
+			{
+				std::string spaces = Pattern(" \t\n\r\v\f", 'x', position, size);
+				ASSERT_EQ(SkipWhitespace(spaces, from), SkipWhitespaceScalar(spaces, from));
+
+				std::string comment = Pattern("*a/ *", '/', position, size);
+				if (position > 0 && position < size)
+				{
+					comment[position - 1] = '*';
+				}
+				ASSERT_EQ(FindCommentEnd(comment, from), FindCommentEndScalar(comment, from));
+
+				std::string literal = Pattern("text \x80\xff", '"', position, size);
+				ASSERT_EQ(FindQuote(literal, from), FindQuoteScalar(literal, from));
+
+				std::string any = Pattern("text \x80\xff", position % 2 == 0 ? '/' : '\n', position, size);
+				ASSERT_EQ(FindAnyOf(any, from, '"', '/'), FindAnyOfScalar(any, from, '"', '/'));
+				ASSERT_EQ(FindAnyOf(any, from, '"', '/', '\n'), FindAnyOfScalar(any, from, '"', '/', '\n'));
+			}
+		}
+	}
+}
+
+TEST(ScanTest, MissingTerminatorScan)
+{
+	std::string text(100, ' ');
+	ASSERT_EQ(SkipWhitespace(text, 0), text.size());
+	ASSERT_EQ(FindCommentEnd(text + "*", 0), std::string_view::npos);
+	ASSERT_EQ(FindQuote(text, 0), std::string_view::npos);
+	ASSERT_EQ(FindQuote(text, text.size()), std::string_view::npos);
+	ASSERT_EQ(FindAnyOf(text, 0, '"', '/'), std::string_view::npos);
+	ASSERT_EQ(FindAnyOf(text, 0, '"', '/', '\n'), std::string_view::npos);
+}
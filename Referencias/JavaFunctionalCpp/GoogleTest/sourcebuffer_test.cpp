@@ -0,0 +1,44 @@
+#include "pch.h"
+#include "sourcebuffer.hpp"
+#include "parser.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+static std::string WriteTemp(std::string name, std::string text)
+{
+	std::string path = (std::filesystem::temp_directory_path() / name).string();
+	std::ofstream(path, std::ios::binary) << text;
+	return path;
+}
+
+TEST(SourceBufferTest, OpenFile)
+{
+	std::string text = "int a = 1;\nprint a;\n";
+	std::string path = WriteTemp("jpp_sourcebuffer_test.jpp", text);
+	{
+		SourceBuffer source = SourceBuffer::Open(path);
+		ASSERT_EQ(source.Text(), text);
+
+		SourceBuffer moved = std::move(source);
+		ASSERT_EQ(moved.Text(), text);
+		ASSERT_TRUE(source.Text().empty());
+
+		FunctionMemory function_memory;
+		Parser parser(std::move(moved), EnvStack(), function_memory);
+		Program ast = parser.Parse();
+		ASSERT_TRUE(parser.GetErrorReports().empty());
+		ASSERT_EQ(ast.statements.size(), 2);
+	}
+	std::remove(path.c_str());
+}
+
+TEST(SourceBufferTest, EmptyAndMissingFile)
+{
+	std::string path = WriteTemp("jpp_sourcebuffer_empty.jpp", "");
+	ASSERT_TRUE(SourceBuffer::Open(path).Text().empty());
+	std::remove(path.c_str());
+
+	ASSERT_THROW(SourceBuffer::Open(path), std::ios_base::failure);
+}
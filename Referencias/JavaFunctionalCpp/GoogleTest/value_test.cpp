@@ -0,0 +1,60 @@
+#include "pch.h"
+#include "value.hpp"
+#include "quicken.hpp"
+#include <sstream>
+
+TEST(ValueTest, PromotesMixedOperands)
+{
+	Value sum = NumberBinary(PLUS_TOKEN, Value((short)2), Value((short)3));
+	ASSERT_EQ(sum.type, VAL_INT);
+	ASSERT_EQ(sum.as.i, 5);
+
+	Value product = NumberBinary(STAR_TOKEN, Value(2), Value(1.5));
+	ASSERT_EQ(product.type, VAL_DOUBLE);
+	ASSERT_DOUBLE_EQ(product.as.d, 3.0);
+
+	Value difference = NumberBinary(MINUS_TOKEN, Value((long)10), Value(4));
+	ASSERT_EQ(difference.type, VAL_LONG);
+	ASSERT_EQ(difference.as.l, 6);
+}
+
+TEST(ValueTest, ComparisonsYieldBool)
+{
+	Value equal = NumberBinary(EQUAL_EQUAL_TOKEN, Value(2), Value(2.0));
+	ASSERT_TRUE(equal.IsBool());
+	ASSERT_TRUE(equal.AsBool());
+}
+
+TEST(ValueTest, IntegerDivisionByZeroThrows)
+{
+	ASSERT_THROW(NumberBinary(SLASH_TOKEN, Value(1), Value(0)), std::invalid_argument);
+}
+
+TEST(ValueTest, PrintsValues)
+{
+	std::stringstream out;
+	out << Value(true) << " " << Value(7) << " " << Value::String("text");
+	ASSERT_EQ(out.str(), "true 7 text");
+}
+
+TEST(ValueTest, QuickenedOperationsGuardTypes)
+{
+	uint8_t add = SpecializeBinary(PLUS_TOKEN, VAL_SHORT, VAL_DOUBLE);
+	ASSERT_NE(add, QUICK_GENERIC);
+	Value sum = BINARY_EXECUTORS[add](Value((short)2), Value(1.5));
+	ASSERT_EQ(sum.type, VAL_DOUBLE);
+	ASSERT_DOUBLE_EQ(sum.as.d, 3.5);
+	ASSERT_TRUE(BINARY_EXECUTORS[add](Value(2), Value(1.5)).IsEmpty());
+	uint8_t divide = SpecializeBinary(SLASH_TOKEN, VAL_INT, VAL_INT);
+	ASSERT_THROW(BINARY_EXECUTORS[divide](Value(1), Value(0)), std::invalid_argument);
+	uint8_t either = SpecializeBinary(PIPE_PIPE_TOKEN, VAL_BOOL, VAL_BOOL);
+	ASSERT_TRUE(BINARY_EXECUTORS[either](Value(false), Value(true)).AsBool());
+	ASSERT_EQ(SpecializeBinary(AMPERSAND_AMPERSAND_TOKEN, VAL_INT, VAL_INT), QUICK_GENERIC);
+
+	uint8_t negate = SpecializeUnary(MINUS_TOKEN, VAL_SHORT);
+	Value negated = UNARY_EXECUTORS[negate](Value((short)3));
+	ASSERT_EQ(negated.type, VAL_INT);
+	ASSERT_EQ(negated.as.i, -3);
+	ASSERT_TRUE(UNARY_EXECUTORS[negate](Value(3)).IsEmpty());
+	ASSERT_EQ(SpecializeUnary(MINUS_TOKEN, VAL_BOOL), QUICK_GENERIC);
+}
@@ -0,0 +1,126 @@
+#include "pch.h"
+#include "parser.hpp"
+#include "resolver.hpp"
+#include "interpret.hpp"
+#include "compiler.hpp"
+#include "vm.hpp"
+#include <vector>
+
+// Runs 'program' through both back ends and returns (output, errors).
+class VirtualMachineTest : public testing::Test
+{
+protected:
+	std::string RunTree()
+	{
+		Prepare();
+		Interpreter interpreter(function_memory, resolver->GetGlobalSlotCount());
+		testing::internal::CaptureStdout();
+		for (auto& stmt : statements)
+		{
+			if (stmt == nullptr)
+			{
+				continue;
+			}
+			interpreter.Interpret(stmt);
+			if (not interpreter.GetRuntimeErrors().empty())
+			{
+				break;
+			}
+		}
+		errors = interpreter.GetRuntimeErrors();
+		return testing::internal::GetCapturedStdout();
+	}
+
+	std::string RunVM()
+	{
+		Prepare();
+		Compiler compiler(function_memory, resolver->GetGlobalSlotCount());
+		EXPECT_TRUE(compiler.Compile(statements).empty());
+		VirtualMachine vm(compiler.GetChunks());
+		testing::internal::CaptureStdout();
+		vm.Run();
+		errors = vm.GetRuntimeErrors();
+		return testing::internal::GetCapturedStdout();
+	}
+
+	void ExpectSameOutput()
+	{
+		std::string tree = RunTree();
+		std::vector<std::string> tree_errors = errors;
+		std::string vm = RunVM();
+		ASSERT_EQ(vm, tree);
+		ASSERT_EQ(errors, tree_errors);
+	}
+
+	std::string program;
+	std::vector<std::string> errors;
+
+private:
+	void Prepare()
+	{
+		function_memory = FunctionMemory();
+		EnvStack envstack;
+		Parser parser(program, std::move(envstack), function_memory);
+		ast = parser.Parse();
+		ASSERT_TRUE(parser.GetErrorReports().empty());
+		resolver = std::make_unique<Resolver>(function_memory);
+		ASSERT_TRUE(resolver->Resolve(statements).empty());
+	}
+
+	FunctionMemory function_memory;
+	std::unique_ptr<Resolver> resolver;
+	Program ast;
+	std::vector<AstNode*>& statements = ast.statements;
+};
+
+TEST_F(VirtualMachineTest, ArithmeticVM)
+{
+	program = "short s = 3; long l = 100000; float f = 1.5; double d = 2.25; int i = 7;"
+		"print s + s; print l * s; print f * 2; print d / 2; print i / 2; print -d; print i == 7; print 1 != 1;";
+	ExpectSameOutput();
+	ASSERT_EQ(RunVM(), "630000031.1253-2.25truefalse");
+}
+
+TEST_F(VirtualMachineTest, ScopesAndCallsVM)
+{
+	program = "int g = 10; int f(int n) { int local = n * 2; print local; if (n != 0) { f(n - 1); } g += 1; }"
+		"f(3); print g; { int a = 1; { int a = 2; print a; } print a; }";
+	ExpectSameOutput();
+	ASSERT_EQ(RunVM(), "64201421");
+}
+
+TEST_F(VirtualMachineTest, RuntimeErrorsVM)
+{
+	program = "print 1; print 1 / 0; print 2;";
+	ExpectSameOutput();
+	ASSERT_EQ(errors.size(), 1);
+
+	program = "int f(int n) { print n; } f(1, 2);";
+	ExpectSameOutput();
+	ASSERT_EQ(errors.size(), 1);
+
+	program = "int f(int n) { print n; } print f(2);";
+	ExpectSameOutput();
+	ASSERT_EQ(errors.size(), 1);
+
+	program = "int f() { print c; } { int b = 5; f(); } int c = 7; f();";
+	ExpectSameOutput();
+	ASSERT_EQ(errors.size(), 1);
+}
+
+// Generated expressions far deeper than the native stack could recurse.
+TEST_F(VirtualMachineTest, LongExpressionVM)
+{
+	const int terms = 1000000;
+	std::string sum = "print 1";
+	std::string difference = "x = x";
+	for (int i = 0; i < terms; i++)
+	{
+		sum += " + " + std::to_string(i % 3);
+		difference += " - 1";
+	}
+	program = "int x = 0;\n" + sum + ";\n" + difference + ";\nprint x;";
+	ExpectSameOutput();
+	ASSERT_TRUE(errors.empty());
+	ASSERT_EQ(RunVM(), std::to_string(1 + terms - 1) + std::to_string(-terms));
+}
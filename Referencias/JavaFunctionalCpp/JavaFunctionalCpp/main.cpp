@@ -1,6 +1,5 @@
 ﻿
 #include <iostream>
-#include <fstream>
 #include <vector>
 #include <string>
 
@@ -10,13 +9,20 @@
 
 #include "lexer.hpp"
 #include "parser.hpp"
+#include "sourcebuffer.hpp"
 #include "nodes/astnode.hpp"
 #include "nodes/numbernode.hpp"
 #include "nodes/binaryexpression.hpp"
 #include "nodes/unarynode.hpp"
 #include "syntaxtoken.hpp"
 #include "semantic.hpp"
+#include "typechecker.hpp"
+#include "optimizer.hpp"
+#include "inliner.hpp"
+#include "resolver.hpp"
 #include "interpret.hpp"
+#include "compiler.hpp"
+#include "vm.hpp"
 
 
 
@@ -24,6 +30,9 @@
 #include <cstdio>
 
 bool showtree = false;
+bool use_vm = false;
+bool optimize = false;
+ParseMode parse_mode = PARSE_STREAMING;
 
 void print_errors(std::vector<std::string> errors)
 {
@@ -33,41 +42,27 @@ void print_errors(std::vector<std::string> errors)
 	}
 }
 
-auto read_file(std::string_view path) -> std::string 
-{
-	constexpr auto read_size = std::size_t(4096);
-	auto stream = std::ifstream(path.data());
-	stream.exceptions(std::ios_base::badbit);
-
-	if (not stream)
-	{
-		throw std::ios_base::failure("file does not exist");
-	}
-
-	auto out = std::string();
-	auto buf = std::string(read_size, '\0');
-	while (stream.read(&buf[0], read_size))
-	{
-		out.append(buf, 0, stream.gcount());
-	}
-	out.append(buf, 0, stream.gcount());
-	return out;
-}
-
 int realMain(int argc, char* argv[])
 {
 	SetConsoleOutputCP(65001);
 
 	std::string program_path = argv[1];
 
-	std::string program = read_file(program_path);
-	//std::string program = read_file("main.jpp");
+	SourceBuffer program = SourceBuffer::Open(program_path);
+	//SourceBuffer program = SourceBuffer::Open("main.jpp");
 
 	EnvStack p_env;
 	FunctionMemory function_memory;
-	Parser parser(program, std::move(p_env), function_memory);
+	Parser parser(std::move(program), std::move(p_env), function_memory, parse_mode);
 
-	std::vector<std::unique_ptr<AstNode>> statements = std::move(parser.Parse());
+	Program ast = parser.Parse();
+	if (parse_mode == PARSE_PIPELINED)
+	{
+		PipelineStats stats = parser.GetPipelineStats();
+		std::cerr << "Front end: " << stats.batches << " token batches, lexer stalled " << stats.lexer_stalls
+			<< " times, parser stalled " << stats.parser_stalls << " times" << std::endl;
+	}
+	std::vector<AstNode*>& statements = ast.statements;
 
 	std::vector<std::string> error_reports = parser.GetErrorReports();
 
@@ -99,15 +94,65 @@ int realMain(int argc, char* argv[])
 		return 64;
 	}
 
-	EnvStack env;
-	Interpreter interpreter(std::move(env), function_memory);
-	for (std::unique_ptr<AstNode>& stmt : statements)
+	Resolver resolver(function_memory);
+	std::vector<std::string> resolver_errors = resolver.Resolve(statements);
+	if (not resolver_errors.empty())
+	{
+		std::cout << "Semantic Analysis Error:" << std::endl;
+		print_errors(resolver_errors);
+		return 64;
+	}
+
+	if (optimize)
+	{
+		Optimizer optimizer(ast.arena, function_memory, resolver.GetGlobalSlotCount());
+		optimizer.Optimize(statements);
+		OptimizerStats stats = optimizer.GetStats();
+		std::cerr << "Optimizer: " << stats.nodes_before << " -> " << stats.nodes_after << " nodes, " << stats.folded
+			<< " operations folded, " << stats.propagated << " constants propagated, " << stats.pruned << " ifs pruned" << std::endl;
+	}
+
+	if (use_vm)
+	{
+		Compiler compiler(function_memory, resolver.GetGlobalSlotCount(), &resolver);
+		std::vector<std::string> compiler_errors = compiler.Compile(statements);
+		if (not compiler_errors.empty())
+		{
+			std::cout << "Compiler Errors:" << std::endl;
+			print_errors(compiler_errors);
+			return 64;
+		}
+		VirtualMachine vm(compiler.GetChunks());
+		vm.Run();
+		if (not vm.GetRuntimeErrors().empty())
+		{
+			std::cout << "Runtime Errors" << std::endl;
+			print_errors(vm.GetRuntimeErrors());
+		}
+		return 0;
+	}
+
+	TypeChecker type_checker(function_memory, resolver.GetGlobalSlotCount());
+	type_checker.Check(statements);
+
+	int global_slot_count = resolver.GetGlobalSlotCount();
+	if (optimize)
+	{
+		Inliner inliner(ast.arena, function_memory, global_slot_count);
+		inliner.Inline(statements);
+		global_slot_count = inliner.GetGlobalSlotCount();
+		InlinerStats stats = inliner.GetStats();
+		std::cerr << "Inliner: " << stats.calls << " calls inlined, " << stats.nodes_before << " -> " << stats.nodes_after << " nodes" << std::endl;
+	}
+
+	Interpreter interpreter(function_memory, global_slot_count, &resolver);
+	for (AstNode* stmt : statements)
 	{
 		if (stmt == nullptr)
 		{
 			continue;
 		}
-		interpreter.Interpret(std::move(stmt));
+		interpreter.Interpret(stmt);
 		if (not interpreter.GetRuntimeErrors().empty())
 		{
 			std::cout << "Runtime Errors" << std::endl;
@@ -124,12 +169,36 @@ int main(int argc, char* argv[])
 {
 	if (argc < 2)
 	{
-		std::cout << "Usage: jpp <file.jpp> [--showtree]" << std::endl;
+		std::cout << "Usage: jpp <file.jpp | -> [--showtree] [--vm] [-O1] [--pipeline | --parallel | --lazy]" << std::endl;
 		return 64;
 	}
-	if (argc == 3 && std::string(argv[2]) == "--showtree")
+	for (int i = 2; i < argc; i++)
 	{
-		showtree = true;
+		std::string option = argv[i];
+		if (option == "--showtree")
+		{
+			showtree = true;
+		}
+		else if (option == "--vm")
+		{
+			use_vm = true;
+		}
+		else if (option == "-O1")
+		{
+			optimize = true;
+		}
+		else if (option == "--pipeline")
+		{
+			parse_mode = PARSE_PIPELINED;
+		}
+		else if (option == "--parallel")
+		{
+			parse_mode = PARSE_PARALLEL;
+		}
+		else if (option == "--lazy")
+		{
+			parse_mode = PARSE_LAZY;
+		}
 	}
 	int result = realMain(argc, argv);
 	if (result != 0)
@@ -0,0 +1,87 @@
+#include <cstdint>
+#include <cstring>
+
+#include "arena.hpp"
+
+Arena::Arena(Arena&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+Arena& Arena::operator=(Arena&& other) noexcept
+{
+	this->blocks = std::move(other.blocks);
+	this->current = std::exchange(other.current, nullptr);
+	this->end = std::exchange(other.end, nullptr);
+	this->bytes_used = std::exchange(other.bytes_used, 0);
+	other.blocks.clear();
+	return *this;
+}
+
+static char* Align(char* pointer, size_t alignment)
+{
+	return (char*)(((uintptr_t)pointer + alignment - 1) & ~(uintptr_t)(alignment - 1));
+}
+
+void* Arena::Allocate(size_t size, size_t alignment)
+{
+	if (this->current != nullptr)
+	{
+		char* aligned = Align(this->current, alignment);
+		if (aligned + size <= this->end)
+		{
+			this->current = aligned + size;
+			this->bytes_used += size;
+			return aligned;
+		}
+	}
+	this->bytes_used += size;
+
+	// large requests get a block of their own so the current block keeps
+	// its free tail
+	if (size + alignment > BLOCK_SIZE / 4)
+	{
+		this->blocks.push_back(std::make_unique_for_overwrite<char[]>(size + alignment));
+		return Align(this->blocks.back().get(), alignment);
+	}
+
+	this->blocks.push_back(std::make_unique_for_overwrite<char[]>(BLOCK_SIZE));
+	char* aligned = Align(this->blocks.back().get(), alignment);
+	this->current = aligned + size;
+	this->end = this->blocks.back().get() + BLOCK_SIZE;
+	return aligned;
+}
+
+std::string_view Arena::CopyString(std::string_view text)
+{
+	if (text.empty())
+	{
+		return {};
+	}
+	char* data = static_cast<char*>(Allocate(text.size(), 1));
+	std::memcpy(data, text.data(), text.size());
+	return std::string_view(data, text.size());
+}
+
+void Arena::Adopt(Arena&& other)
+{
+	// the current block stays the one to allocate from
+	for (std::unique_ptr<char[]>& block : other.blocks)
+	{
+		this->blocks.push_back(std::move(block));
+	}
+	this->bytes_used += std::exchange(other.bytes_used, 0);
+	other.blocks.clear();
+	other.current = nullptr;
+	other.end = nullptr;
+}
+
+size_t Arena::BytesUsed()
+{
+	return this->bytes_used;
+}
+
+size_t Arena::BlockCount()
+{
+	return this->blocks.size();
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bump allocator for everything that lives exactly as long as a Program:
+// AST nodes, their child lists and identifier/string text. Objects are laid
+// out back to back in large blocks and are never destroyed one by one, so
+// only trivially destructible types may be placed in it and freeing the
+// whole program is a handful of block deallocations.
+class Arena
+{
+public:
+	Arena() = default;
+	Arena(Arena&& other) noexcept;
+	Arena& operator=(Arena&& other) noexcept;
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	void* Allocate(size_t size, size_t alignment);
+
+	template <class T, class... Args>
+	T* New(Args&&... args)
+	{
+		static_assert(std::is_trivially_destructible_v<T>, "Arena objects are never destroyed");
+		return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+	}
+
+	template <class T>
+	std::span<T> CopyArray(std::span<const T> items)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Arena arrays are copied bytewise");
+		if (items.empty())
+		{
+			return {};
+		}
+		T* data = static_cast<T*>(Allocate(sizeof(T) * items.size(), alignof(T)));
+		std::copy(items.begin(), items.end(), data);
+		return std::span<T>(data, items.size());
+	}
+	template <class T>
+	std::span<T> CopyArray(const std::vector<T>& items)
+	{
+		return CopyArray(std::span<const T>(items));
+	}
+
+	std::string_view CopyString(std::string_view text);
+
+	// Takes over the blocks of 'other', which was filled separately (on
+	// another thread, say); its objects now live as long as this arena.
+	void Adopt(Arena&& other);
+
+	size_t BytesUsed();
+	size_t BlockCount();
+
+private:
+	static const size_t BLOCK_SIZE = 64 * 1024;
+
+	std::vector<std::unique_ptr<char[]>> blocks;
+	char* current = nullptr;
+	char* end = nullptr;
+	size_t bytes_used = 0;
+};
@@ -12,3 +12,57 @@
 #include "nodes/vardeclarationnode.hpp"
 #include "nodes/varassignmentstmtnode.hpp"
 #include "nodes/blockstmtnode.hpp"
+
+// Every node class with its NodeKind and Visitor method, the one list that
+// Dispatch and NodeCast are generated from.
+#define AST_NODE_LIST(X) \
+	X(NODE_BINARY, BinaryExpression, VisitBinaryExpression) \
+	X(NODE_BOOL, BoolNode, VisitBoolNode) \
+	X(NODE_NUMBER, NumberNode, VisitNumberNode) \
+	X(NODE_STRING, StringNode, VisitStringNode) \
+	X(NODE_IDENTIFIER, IdentifierNode, VisitIdentifierNode) \
+	X(NODE_UNARY, UnaryNode, VisitUnaryNode) \
+	X(NODE_IF, IfStmtNode, VisitIfStmtNode) \
+	X(NODE_PRINT, PrintStmtNode, VisitPrintStmt) \
+	X(NODE_VAR_DECLARATION, VarDeclarationNode, VisitVarDeclarationStmt) \
+	X(NODE_VAR_ASSIGNMENT, VarAssignmentStmtNode, VisitVarAssignmentStmt) \
+	X(NODE_FUNCTION_CALL, FunctionCallExpr, VisitFunctionCallNode) \
+	X(NODE_BLOCK, BlockStmtNode, VisitBlockStmtNode)
+
+// Calls the visitor's method for the node's class. With V a final class
+// the call is direct and may be inlined; AstNode::Accept is Dispatch with
+// V = Visitor, one virtual call. V needs every Visit method accessible from
+// here (a pass with private ones befriends Dispatch).
+template <class V>
+inline Value Dispatch(V& visitor, AstNode& node)
+{
+	switch (node.kind)
+	{
+#define AST_NODE_DISPATCH(kind, type, visit) \
+		case kind: \
+			return visitor.visit(static_cast<type&>(node));
+		AST_NODE_LIST(AST_NODE_DISPATCH)
+#undef AST_NODE_DISPATCH
+		default:
+			return Value();
+	}
+}
+
+template <class T>
+struct NodeKindOf;
+#define AST_NODE_KIND_OF(kind, type, visit) \
+	template <> \
+	struct NodeKindOf<type> { static constexpr NodeKind value = kind; };
+AST_NODE_LIST(AST_NODE_KIND_OF)
+#undef AST_NODE_KIND_OF
+
+// The node as a T, or nullptr if it is null or of another class.
+template <class T>
+inline T* NodeCast(AstNode* node)
+{
+	if (node == nullptr || node->kind != NodeKindOf<T>::value)
+	{
+		return nullptr;
+	}
+	return static_cast<T*>(node);
+}
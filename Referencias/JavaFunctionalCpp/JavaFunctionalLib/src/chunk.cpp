@@ -0,0 +1,70 @@
+#include <stdexcept>
+
+#include "chunk.hpp"
+
+Chunk::Chunk(std::string name)
+	: name(name)
+{
+}
+
+void Chunk::Write(uint8_t byte)
+{
+	this->code.push_back(byte);
+}
+
+void Chunk::WriteShort(uint16_t operand)
+{
+	uint8_t bytes[sizeof(operand)];
+	std::memcpy(bytes, &operand, sizeof(operand));
+	this->code.insert(this->code.end(), bytes, bytes + sizeof(operand));
+}
+
+void Chunk::WriteInt(uint32_t operand)
+{
+	uint8_t bytes[sizeof(operand)];
+	std::memcpy(bytes, &operand, sizeof(operand));
+	this->code.insert(this->code.end(), bytes, bytes + sizeof(operand));
+}
+
+void Chunk::PatchInt(size_t offset, uint32_t operand)
+{
+	std::memcpy(&this->code[offset], &operand, sizeof(operand));
+}
+
+// Equal literals share one pool entry. Every Value constructor clears the
+// whole payload first, so the 8 payload bytes identify the literal.
+int Chunk::AddConstant(Value value)
+{
+	auto key = std::make_tuple((int)value.type, value.length, value.as.l);
+	auto found = this->constant_index.find(key);
+	if (found != this->constant_index.end())
+	{
+		return found->second;
+	}
+	if (this->constants.size() > UINT16_MAX)
+	{
+		throw std::invalid_argument("Too many constants in function '" + this->name + "'.");
+	}
+	this->constants.push_back(value);
+	int index = (int)this->constants.size() - 1;
+	this->constant_index[key] = index;
+	return index;
+}
+
+// Equal messages share one entry, as every access to a global carries one.
+int Chunk::AddMessage(std::string message)
+{
+	auto found = this->message_index.find(message);
+	if (found != this->message_index.end())
+	{
+		return found->second;
+	}
+	if (this->messages.size() > UINT16_MAX)
+	{
+		throw std::invalid_argument("Too many messages in function '" + this->name + "'.");
+	}
+	this->messages.push_back(message);
+	int index = (int)this->messages.size() - 1;
+	this->message_index[message] = index;
+	return index;
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "value.hpp"
+
+// Instruction set of the bytecode VM. Operands follow the opcode inline:
+// u16 for constant/slot/function indices, u32 for jump offsets, u8 for a
+// Token_t. Arithmetic opcodes have inline int/int and double/double paths
+// and fall back to BinaryOperation() for every other combination.
+enum OpCode : uint8_t
+{
+	OP_CONSTANT,      // u16 constant -> push
+	OP_NULL,
+	OP_TRUE,
+	OP_FALSE,
+	OP_POP,
+
+	OP_GET_LOCAL,     // u16 slot in the current frame
+	OP_SET_LOCAL,
+	OP_GET_GLOBAL,    // u16 slot in the global frame, u16 message raised while it is not declared
+	OP_SET_GLOBAL,
+
+	OP_ADD,
+	OP_SUBTRACT,
+	OP_MULTIPLY,
+	OP_DIVIDE,
+	OP_EQUAL,
+	OP_NOT_EQUAL,
+	OP_BINARY,        // u8 Token_t, any other operator
+	OP_NEGATE,
+	OP_NOT,
+	OP_UNARY,         // u8 Token_t, any other operator
+
+	OP_PRINT,
+	OP_JUMP_IF_FALSE, // u32 forward offset, pops the condition
+	OP_CHECK_ARGUMENT,// u16 function, validates the argument on top
+	OP_CALL,          // u16 function
+	OP_FAIL,          // u16 index into messages, raises that runtime error
+	OP_RETURN,
+
+	OP_COUNT
+};
+
+// Bytecode of one function (chunk 0 is the top-level program). String
+// constants are views into the AST, which must outlive the chunk.
+class Chunk
+{
+public:
+	Chunk(std::string name = "main");
+
+	void Write(uint8_t byte);
+	void WriteShort(uint16_t operand);
+	void WriteInt(uint32_t operand);
+	void PatchInt(size_t offset, uint32_t operand);
+	int AddConstant(Value value);
+	int AddMessage(std::string message);
+
+	std::string name;
+	std::vector<uint8_t> code;
+	std::vector<Value> constants;
+	std::vector<std::string> messages; // storage for OP_FAIL strings
+	int arity = 0;
+	int slot_count = 0;
+	int max_stack = 0;                 // deepest operand stack, set by the Compiler
+
+private:
+	std::map<std::tuple<int, uint32_t, long long>, int> constant_index;
+	std::map<std::string, int> message_index;
+};
+
+inline uint16_t ReadShort(const uint8_t* ip)
+{
+	uint16_t operand;
+	std::memcpy(&operand, ip, sizeof(operand));
+	return operand;
+}
+
+inline uint32_t ReadInt(const uint8_t* ip)
+{
+	uint32_t operand;
+	std::memcpy(&operand, ip, sizeof(operand));
+	return operand;
+}
@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "compiler.hpp"
+#include "ast_node_headers.hpp"
+
+Compiler::Compiler(FunctionMemory& function_memory, int global_slot_count, Resolver* resolver)
+	: function_memory(function_memory), resolver(resolver)
+{
+	this->chunks.push_back(Chunk("main"));
+	this->chunks[0].slot_count = global_slot_count;
+}
+
+std::vector<std::string> Compiler::Compile(std::vector<AstNode*>& statements)
+{
+	try
+	{
+		for (auto& stmt : statements)
+		{
+			if (stmt == nullptr)
+			{
+				continue;
+			}
+			CompileStatement(*stmt);
+		}
+		Emit(OP_RETURN);
+
+		// compiling a body can queue further callees
+		for (size_t i = 0; i < this->pending_functions.size(); i++)
+		{
+			CompileFunction(this->pending_functions[i]);
+		}
+	}
+	catch (std::invalid_argument& e)
+	{
+		Report(e.what());
+		this->chain.clear();
+	}
+	return this->errors;
+}
+
+std::vector<Chunk>& Compiler::GetChunks()
+{
+	return this->chunks;
+}
+
+void Compiler::Report(std::string error)
+{
+	this->errors.push_back(error);
+}
+
+Chunk& Compiler::Current()
+{
+	return this->chunks[this->current];
+}
+
+void Compiler::Emit(uint8_t byte, int stack_effect)
+{
+	Current().Write(byte);
+	this->stack_depth += stack_effect;
+	Current().max_stack = std::max(Current().max_stack, this->stack_depth);
+}
+
+void Compiler::EmitShort(uint8_t op, int operand, int stack_effect)
+{
+	if (operand < 0 || operand > UINT16_MAX)
+	{
+		throw std::invalid_argument("Operand out of range in function '" + Current().name + "'.");
+	}
+	Emit(op, stack_effect);
+	Current().WriteShort((uint16_t)operand);
+}
+
+// OP_GET_GLOBAL and OP_SET_GLOBAL carry the error raised when a function
+// reaches the global before its declaration has run.
+void Compiler::EmitGlobal(uint8_t op, int slot, Symbol identifier, int stack_effect)
+{
+	EmitShort(op, slot, stack_effect);
+	Current().WriteShort((uint16_t)Current().AddMessage("Variable Identifier '" + SymbolName(identifier) + "' not found."));
+}
+
+// A statement leaves the operand stack as it found it; the value of an
+// expression statement (e.g. a bare call) is discarded.
+void Compiler::CompileStatement(AstNode& stmt)
+{
+	int depth = this->stack_depth;
+	Dispatch(*this, stmt);
+	while (this->stack_depth > depth)
+	{
+		Emit(OP_POP, -1);
+	}
+}
+
+void Compiler::CompileFunction(Symbol identifier)
+{
+	FuncVariable& func_var = this->function_memory.GetRef(identifier);
+	this->current = this->function_index[identifier];
+	this->stack_depth = 0;
+
+	BlockStmtNode& body = static_cast<BlockStmtNode&>(*func_var.block_stmt);
+	for (auto& stmt : body.stmts)
+	{
+		CompileStatement(*stmt);
+	}
+	Emit(OP_RETURN);
+}
+
+int Compiler::FunctionIndex(FuncVariable& func_var)
+{
+	auto found = this->function_index.find(func_var.identifier);
+	if (found != this->function_index.end())
+	{
+		return found->second;
+	}
+	if (func_var.block_stmt == nullptr && this->resolver != nullptr)
+	{
+		this->resolver->Materialize(func_var); // sets slot_count
+	}
+	Chunk chunk(SymbolName(func_var.identifier));
+	chunk.arity = (int)func_var.parameters.size();
+	chunk.slot_count = func_var.slot_count;
+	this->chunks.push_back(std::move(chunk));
+
+	int index = (int)this->chunks.size() - 1;
+	this->function_index[func_var.identifier] = index;
+	this->pending_functions.push_back(func_var.identifier);
+	return index;
+}
+
+// A left-leaning chain is compiled in a loop, innermost operator first.
+Value Compiler::VisitBinaryExpression(BinaryExpression& binaryExpression)
+{
+	size_t first = this->chain.size();
+	binaryExpression.Chain(this->chain);
+	Dispatch(*this, *this->chain[first]->left);
+	for (size_t i = first; i < this->chain.size(); i++)
+	{
+		BinaryExpression* node = this->chain[i];
+		Dispatch(*this, *node->right);
+		EmitBinary(node->op);
+	}
+	this->chain.resize(first);
+	return Value();
+}
+
+void Compiler::EmitBinary(Token_t op)
+{
+	switch (op)
+	{
+		case PLUS_TOKEN:
+			Emit(OP_ADD, -1);
+			break;
+		case MINUS_TOKEN:
+			Emit(OP_SUBTRACT, -1);
+			break;
+		case STAR_TOKEN:
+			Emit(OP_MULTIPLY, -1);
+			break;
+		case SLASH_TOKEN:
+			Emit(OP_DIVIDE, -1);
+			break;
+		case EQUAL_EQUAL_TOKEN:
+			Emit(OP_EQUAL, -1);
+			break;
+		case BANG_EQUAL_TOKEN:
+			Emit(OP_NOT_EQUAL, -1);
+			break;
+		default:
+			Emit(OP_BINARY, -1);
+			Current().Write((uint8_t)op);
+			break;
+	}
+}
+
+Value Compiler::VisitBoolNode(BoolNode& boolNode)
+{
+	Emit(boolNode.value ? OP_TRUE : OP_FALSE, 1);
+	return Value();
+}
+
+Value Compiler::VisitNumberNode(NumberNode& numberNode)
+{
+	EmitShort(OP_CONSTANT, Current().AddConstant(numberNode.number), 1);
+	return Value();
+}
+
+Value Compiler::VisitStringNode(StringNode& stringNode)
+{
+	EmitShort(OP_CONSTANT, Current().AddConstant(Value::String(stringNode.value)), 1);
+	return Value();
+}
+
+Value Compiler::VisitIdentifierNode(IdentifierNode& identifierNode)
+{
+	if (identifierNode.depth == 0)
+	{
+		EmitShort(OP_GET_LOCAL, identifierNode.slot, 1);
+	}
+	else
+	{
+		EmitGlobal(OP_GET_GLOBAL, identifierNode.slot, identifierNode.identifier, 1);
+	}
+	return Value();
+}
+
+Value Compiler::VisitUnaryNode(UnaryNode& unaryNode)
+{
+	Dispatch(*this, *unaryNode.left);
+	switch (unaryNode.token)
+	{
+		case MINUS_TOKEN:
+			Emit(OP_NEGATE);
+			break;
+		case BANG_TOKEN:
+			Emit(OP_NOT);
+			break;
+		default:
+			Emit(OP_UNARY);
+			Current().Write((uint8_t)unaryNode.token);
+			break;
+	}
+	return Value();
+}
+
+Value Compiler::VisitIfStmtNode(IfStmtNode& ifStmtNode)
+{
+	Dispatch(*this, *ifStmtNode.expression);
+	Emit(OP_JUMP_IF_FALSE, -1);
+	size_t jump = Current().code.size();
+	Current().WriteInt(0);
+
+	CompileStatement(*ifStmtNode.blockStmt);
+	Current().PatchInt(jump, (uint32_t)(Current().code.size() - jump - sizeof(uint32_t)));
+	return Value();
+}
+
+Value Compiler::VisitPrintStmt(PrintStmtNode& printStmtNode)
+{
+	Dispatch(*this, *printStmtNode.expression);
+	Emit(OP_PRINT, -1);
+	return Value();
+}
+
+Value Compiler::VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode)
+{
+	if (varDeclarationNode.expression != nullptr)
+	{
+		Dispatch(*this, *varDeclarationNode.expression);
+	}
+	else
+	{
+		Emit(OP_NULL, 1);
+	}
+	EmitShort(OP_SET_LOCAL, varDeclarationNode.slot, -1); // declarations are always in the current frame
+	return Value();
+}
+
+Value Compiler::VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode)
+{
+	Dispatch(*this, *varAssignmentNode.expression);
+	if (varAssignmentNode.depth == 0)
+	{
+		EmitShort(OP_SET_LOCAL, varAssignmentNode.slot, -1);
+	}
+	else
+	{
+		EmitGlobal(OP_SET_GLOBAL, varAssignmentNode.slot, varAssignmentNode.identifier, -1);
+	}
+	return Value();
+}
+
+Value Compiler::VisitFunctionCallNode(FunctionCallExpr& functionCallExpr)
+{
+	FuncVariable& func_var = this->function_memory.GetRef(functionCallExpr.identifier);
+	if (func_var.parameters.size() != functionCallExpr.arguments.size())
+	{
+		// the tree interpreter raises this when the call runs, before any
+		// argument is evaluated; keep the same observable behaviour
+		Current().messages.push_back("Parameter size for funciton '" + SymbolName(func_var.identifier) + "' is invalid for its arguments.");
+		EmitShort(OP_FAIL, (int)Current().messages.size() - 1, 1);
+		return Value();
+	}
+
+	int index = FunctionIndex(func_var);
+	for (auto& arg : functionCallExpr.arguments)
+	{
+		Dispatch(*this, *arg);
+		EmitShort(OP_CHECK_ARGUMENT, index, 0);
+	}
+	EmitShort(OP_CALL, index, 1 - (int)functionCallExpr.arguments.size());
+	return Value();
+}
+
+Value Compiler::VisitBlockStmtNode(BlockStmtNode& blockStmtNode)
+{
+	for (auto& stmt : blockStmtNode.stmts)
+	{
+		CompileStatement(*stmt);
+	}
+	return Value();
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "visitor.hpp"
+#include "nodes/astnode.hpp"
+#include "functionmemory.hpp"
+#include "chunk.hpp"
+#include "resolver.hpp"
+
+// Lowers a resolved AST into bytecode for the VirtualMachine. Runs after the
+// Resolver: variables are emitted by their (depth, slot) address. Chunk 0 is
+// the top-level program; every called function gets its own chunk, compiled
+// the first time a call to it is seen.
+class Compiler final : public Visitor
+{
+public:
+	Compiler(FunctionMemory& function_memory, int global_slot_count, Resolver* resolver = nullptr);
+
+	std::vector<std::string> Compile(std::vector<AstNode*>& statements);
+	std::vector<Chunk>& GetChunks();
+
+private:
+	template <class V>
+	friend Value Dispatch(V& visitor, AstNode& node);
+
+	FunctionMemory& function_memory;
+	Resolver* resolver; // builds PARSE_LAZY bodies of called functions
+	std::vector<Chunk> chunks;
+	std::unordered_map<Symbol, int> function_index;
+	std::vector<Symbol> pending_functions;
+	std::vector<BinaryExpression*> chain; // BinaryExpression::Chain of the expressions being compiled
+	int current = 0;     // chunk being emitted
+	int stack_depth = 0; // operand stack depth at this point of the chunk
+
+	std::vector<std::string> errors;
+	void Report(std::string error);
+
+	Chunk& Current();
+	void Emit(uint8_t byte, int stack_effect = 0);
+	void EmitShort(uint8_t op, int operand, int stack_effect);
+	void EmitGlobal(uint8_t op, int slot, Symbol identifier, int stack_effect);
+	void CompileStatement(AstNode& stmt);
+	void CompileFunction(Symbol identifier);
+	void EmitBinary(Token_t op);
+	int FunctionIndex(FuncVariable& func_var);
+
+	Value VisitBinaryExpression(BinaryExpression& binaryExpression);
+	Value VisitBoolNode(BoolNode& boolNode);
+	Value VisitNumberNode(NumberNode& numberNode);
+	Value VisitStringNode(StringNode& stringNode);
+	Value VisitIdentifierNode(IdentifierNode& identifierNode);
+	Value VisitUnaryNode(UnaryNode& unaryNode);
+
+	Value VisitIfStmtNode(IfStmtNode& ifStmtNode);
+	Value VisitPrintStmt(PrintStmtNode& printStmtNode);
+	Value VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode);
+	Value VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode);
+
+	Value VisitFunctionCallNode(FunctionCallExpr& functionCallExpr);
+	Value VisitBlockStmtNode(BlockStmtNode& blockStmtNode);
+};
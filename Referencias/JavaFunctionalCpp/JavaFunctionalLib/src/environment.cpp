@@ -4,7 +4,7 @@ Environment::Environment()
 {
 }
 
-std::optional<Variable> Environment::EnvrionmentVariable::Get(std::string identifier)
+std::optional<Variable> Environment::EnvrionmentVariable::Get(Symbol identifier)
 {
     if (this->variables.contains(identifier))
     {
@@ -13,20 +13,35 @@ std::optional<Variable> Environment::EnvrionmentVariable::Get(std::string identi
     return std::nullopt;
 }
 
+Variable* Environment::EnvrionmentVariable::Find(Symbol identifier)
+{
+    auto found = this->variables.find(identifier);
+    if (found == this->variables.end())
+    {
+        return nullptr;
+    }
+    return &found->second;
+}
+
 void Environment::EnvrionmentVariable::Set(Variable variable)
 {
     if (this->variables.contains(variable.identifier))
     {
-        throw std::invalid_argument("Identifier '" + variable.identifier + "' already declared.");
+        throw std::invalid_argument("Identifier '" + SymbolName(variable.identifier) + "' already declared.");
     }
     this->variables[variable.identifier] = variable;
 }
 
-void Environment::EnvrionmentVariable::Assign(std::string identifier, std::any value)
+const std::unordered_map<Symbol, Variable>& Environment::EnvrionmentVariable::GetAll() const
+{
+    return this->variables;
+}
+
+void Environment::EnvrionmentVariable::Assign(Symbol identifier, Value value)
 {
     if (not this->variables.contains(identifier))
     {
-        throw std::invalid_argument("Identifier '" + identifier + "' not found.");
+        throw std::invalid_argument("Identifier '" + SymbolName(identifier) + "' not found.");
     }
     Variable var = this->variables[identifier];
     var.value = value;
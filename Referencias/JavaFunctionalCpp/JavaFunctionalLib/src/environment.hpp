@@ -17,11 +17,13 @@ public:
 	class EnvrionmentVariable
 	{
 	public:
-		std::optional<Variable> Get(std::string identifier);
+		std::optional<Variable> Get(Symbol identifier);
+		Variable* Find(Symbol identifier);
 		void Set(Variable variable);
-		void Assign(std::string identifier, std::any value);
+		void Assign(Symbol identifier, Value value);
+		const std::unordered_map<Symbol, Variable>& GetAll() const;
 	private:
-		std::unordered_map<std::string, Variable> variables;
+		std::unordered_map<Symbol, Variable> variables;
 	};
 
 	EnvrionmentVariable env_var;
@@ -19,15 +19,15 @@ Environment& EnvStack::GetRef()
     {
         return this->envs.at(current--);
     }
-    throw new std::invalid_argument("No Environment Found.");
+    throw std::invalid_argument("No Environment Found.");
 }
 
-std::pair<Variable, Environment> EnvStack::Get(std::string identifier)
+std::pair<Variable, Environment> EnvStack::Get(Symbol identifier)
 {
     std::optional<Environment> env_op = Get();
     if (env_op == std::nullopt)
     {
-        throw std::invalid_argument("Variable Identifier '" + identifier + "' not found.");
+        throw std::invalid_argument("Variable Identifier '" + SymbolName(identifier) + "' not found.");
     }
     Environment env = env_op.value();
     if (env.env_var.Get(identifier) == std::nullopt)
@@ -38,6 +38,21 @@ std::pair<Variable, Environment> EnvStack::Get(std::string identifier)
     return { env.env_var.Get(identifier).value(), env};
 }
 
+// Type of the innermost visible 'identifier', found in place: unlike Get()
+// it copies no Environment.
+DataType EnvStack::GetDataType(Symbol identifier)
+{
+    for (auto env = this->envs.rbegin(); env != this->envs.rend(); env++)
+    {
+        Variable* var = env->env_var.Find(identifier);
+        if (var != nullptr)
+        {
+            return var->dtType;
+        }
+    }
+    throw std::invalid_argument("Variable Identifier '" + SymbolName(identifier) + "' not found.");
+}
+
 void EnvStack::Push(Environment env)
 {
     this->envs.push_back(std::move(env));
@@ -73,10 +88,10 @@ void EnvStack::Add(Variable var)
      Reset();
 }
 
-void EnvStack::Assign(std::string identifier, std::any value)
+void EnvStack::Assign(Symbol identifier, Value value)
 {
     std::pair<Variable, Environment> var_op = std::move(Get(identifier));
-    var_op.second.env_var.Assign(identifier, std::move(var_op.first));
+    var_op.second.env_var.Assign(identifier, value);
 }
 
 void EnvStack::Reset()
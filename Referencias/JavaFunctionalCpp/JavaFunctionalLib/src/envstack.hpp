@@ -18,10 +18,11 @@ public:
 
 	std::optional<Environment> Get();
 	Environment& GetRef();
-	std::pair<Variable, Environment> Get(std::string identifier);
+	std::pair<Variable, Environment> Get(Symbol identifier);
+	DataType GetDataType(Symbol identifier);
 	void Push(Environment env);
 	std::optional<Environment> Pop();
 	void Add(Variable var);
-	void Assign(std::string identifier, std::any value);
+	void Assign(Symbol identifier, Value value);
 	void Reset();
 };
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include "flatast.hpp"
+
+#include "ast_node_headers.hpp"
+
+// Appends the pointer tree to a FlatAst node by node in pre-order.
+class FlatAstBuilder final : public Visitor
+{
+public:
+	FlatAstBuilder(FlatAst& flat) : flat(flat) {}
+
+	void Add(AstNode* node)
+	{
+		if (node == nullptr)
+		{
+			this->flat.Close(this->flat.Open(NODE_EMPTY));
+			return;
+		}
+		Dispatch(*this, *node);
+	}
+
+private:
+	template <class V>
+	friend Value Dispatch(V& visitor, AstNode& node);
+
+	FlatAst& flat;
+	std::vector<BinaryExpression*> chain; // BinaryExpression::Chain of the expressions being added
+	std::vector<uint32_t> chain_ids;
+
+	// A chain 'a + b + c' is every operator first, outermost to innermost,
+	// then the innermost left operand and the right operands back out, so
+	// it is added in a loop rather than one native call per operator.
+	Value VisitBinaryExpression(BinaryExpression& binaryExpression)
+	{
+		size_t first = this->chain.size();
+		binaryExpression.Chain(this->chain);
+		this->chain_ids.resize(this->chain.size());
+		for (size_t i = this->chain.size(); i-- > first;)
+		{
+			this->chain_ids[i] = this->flat.Open(NODE_BINARY, { (uint32_t)this->chain[i]->op });
+		}
+		Add(this->chain[first]->left);
+		for (size_t i = first; i < this->chain.size(); i++)
+		{
+			Add(this->chain[i]->right);
+			this->flat.Close(this->chain_ids[i]);
+		}
+		this->chain.resize(first);
+		this->chain_ids.resize(first);
+		return Value();
+	}
+
+	Value VisitBoolNode(BoolNode& boolNode)
+	{
+		this->flat.Close(this->flat.Open(NODE_BOOL, { (uint32_t)boolNode.value }));
+		return Value();
+	}
+
+	Value VisitNumberNode(NumberNode& numberNode)
+	{
+		this->flat.AddConstant(NODE_NUMBER, numberNode.number);
+		return Value();
+	}
+
+	Value VisitStringNode(StringNode& stringNode)
+	{
+		this->flat.AddConstant(NODE_STRING, Value::String(stringNode.value));
+		return Value();
+	}
+
+	Value VisitIdentifierNode(IdentifierNode& identifierNode)
+	{
+		FlatPayload payload = { identifierNode.identifier, 0, identifierNode.depth, identifierNode.slot };
+		this->flat.Close(this->flat.Open(NODE_IDENTIFIER, payload));
+		return Value();
+	}
+
+	Value VisitUnaryNode(UnaryNode& unaryNode)
+	{
+		uint32_t node = this->flat.Open(NODE_UNARY, { (uint32_t)unaryNode.token });
+		Add(unaryNode.left);
+		this->flat.Close(node);
+		return Value();
+	}
+
+	Value VisitIfStmtNode(IfStmtNode& ifStmtNode)
+	{
+		uint32_t node = this->flat.Open(NODE_IF);
+		Add(ifStmtNode.expression);
+		Add(ifStmtNode.blockStmt);
+		this->flat.Close(node);
+		return Value();
+	}
+
+	Value VisitPrintStmt(PrintStmtNode& printStmtNode)
+	{
+		uint32_t node = this->flat.Open(NODE_PRINT);
+		Add(printStmtNode.expression);
+		this->flat.Close(node);
+		return Value();
+	}
+
+	Value VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode)
+	{
+		FlatPayload payload = { varDeclarationNode.identifier, (uint32_t)varDeclarationNode.variableType, varDeclarationNode.depth, varDeclarationNode.slot };
+		uint32_t node = this->flat.Open(NODE_VAR_DECLARATION, payload);
+		Add(varDeclarationNode.expression);
+		this->flat.Close(node);
+		return Value();
+	}
+
+	Value VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode)
+	{
+		FlatPayload payload = { varAssignmentNode.identifier, 0, varAssignmentNode.depth, varAssignmentNode.slot };
+		uint32_t node = this->flat.Open(NODE_VAR_ASSIGNMENT, payload);
+		Add(varAssignmentNode.expression);
+		this->flat.Close(node);
+		return Value();
+	}
+
+	Value VisitFunctionCallNode(FunctionCallExpr& functionCallExpr)
+	{
+		uint32_t node = this->flat.Open(NODE_FUNCTION_CALL, { functionCallExpr.identifier });
+		for (AstNode* argument : functionCallExpr.arguments)
+		{
+			Add(argument);
+		}
+		this->flat.Close(node);
+		return Value();
+	}
+
+	Value VisitBlockStmtNode(BlockStmtNode& blockStmtNode)
+	{
+		uint32_t node = this->flat.Open(NODE_BLOCK);
+		for (AstNode* stmt : blockStmtNode.stmts)
+		{
+			Add(stmt);
+		}
+		this->flat.Close(node);
+		return Value();
+	}
+};
+
+FlatAst FlatAst::Flatten(std::span<AstNode* const> statements)
+{
+	FlatAst flat;
+	FlatAstBuilder builder(flat);
+	for (AstNode* statement : statements)
+	{
+		// the parser leaves a null statement where it recovered from an error
+		if (statement != nullptr)
+		{
+			builder.Add(statement);
+		}
+	}
+	return flat;
+}
+
+uint32_t FlatAst::Open(NodeKind kind, FlatPayload payload)
+{
+	uint32_t node = Size();
+	this->kinds.push_back(kind);
+	this->payloads.push_back(payload);
+	this->ends.push_back(node + 1);
+	return node;
+}
+
+uint32_t FlatAst::AddConstant(NodeKind kind, Value value)
+{
+	uint32_t node = Open(kind, { (uint32_t)this->constants.size() });
+	this->constants.push_back(value);
+	return node;
+}
+
+uint32_t FlatAst::ChildCount(uint32_t node) const
+{
+	uint32_t count = 0;
+	for (uint32_t child = node + 1; child < End(node); child = End(child))
+	{
+		count++;
+	}
+	return count;
+}
+
+uint32_t FlatAst::Child(uint32_t node, uint32_t index) const
+{
+	uint32_t child = node + 1;
+	for (; index > 0; index--)
+	{
+		child = End(child);
+	}
+	return child;
+}
+
+size_t FlatAst::BytesUsed() const
+{
+	return this->kinds.capacity() * sizeof(uint8_t)
+		+ this->payloads.capacity() * sizeof(FlatPayload)
+		+ this->ends.capacity() * sizeof(uint32_t)
+		+ this->constants.capacity() * sizeof(Value);
+}
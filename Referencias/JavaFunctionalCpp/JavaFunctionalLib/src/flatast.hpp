@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "nodes/astnode.hpp"
+#include "symboltable.hpp"
+#include "token.hpp"
+#include "value.hpp"
+
+// The fixed 16 bytes every flat node carries. 'operand' is the operator
+// token of a binary or unary node, the Symbol of a named node, the value of
+// a bool or the index of a number or string in FlatAst::Constant. 'type' is
+// the declared type of a NODE_VAR_DECLARATION. 'depth' and 'slot' are the
+// Resolver's addressing of a variable, -1 elsewhere.
+struct FlatPayload
+{
+	uint32_t operand = 0;
+	uint32_t type = 0;
+	int32_t depth = -1;
+	int32_t slot = -1;
+};
+
+// The AST as parallel arrays of kind, payload and subtree end, indexed by
+// 32-bit node ids in pre-order: a node's first child is the next id and
+// End() of a node is one past its subtree, so also its next sibling. A
+// pre-order walk is a plain loop over the ids, and skipping a subtree is a
+// single jump. Children in order:
+//   if:          condition, block
+//   print:       expression or NODE_EMPTY
+//   declaration: initializer or NODE_EMPTY
+//   assignment:  expression
+//   binary:      left, right
+//   unary:       operand
+//   call, block: arguments, statements
+// Flatten() copies a parsed (and usually resolved) pointer AST, which the
+// other passes keep using; strings still view the Program that owns it.
+class FlatAst
+{
+public:
+	static FlatAst Flatten(std::span<AstNode* const> statements);
+
+	uint32_t Size() const { return (uint32_t)this->kinds.size(); }
+	NodeKind Kind(uint32_t node) const { return (NodeKind)this->kinds[node]; }
+	const FlatPayload& Payload(uint32_t node) const { return this->payloads[node]; }
+	uint32_t End(uint32_t node) const { return this->ends[node]; }
+	const Value& Constant(uint32_t node) const { return this->constants[this->payloads[node].operand]; }
+
+	uint32_t ChildCount(uint32_t node) const;
+	uint32_t Child(uint32_t node, uint32_t index) const; // walks the earlier siblings
+
+	// Appends a node whose children are appended next; Close() once they are.
+	uint32_t Open(NodeKind kind, FlatPayload payload = {});
+	uint32_t AddConstant(NodeKind kind, Value value);
+	void Close(uint32_t node) { this->ends[node] = Size(); }
+
+	size_t BytesUsed() const;
+
+private:
+	std::vector<uint8_t> kinds;
+	std::vector<FlatPayload> payloads;
+	std::vector<uint32_t> ends;
+	std::vector<Value> constants;
+};
+
+static_assert(sizeof(FlatPayload) == 16, "flat nodes carry a fixed 16-byte payload");
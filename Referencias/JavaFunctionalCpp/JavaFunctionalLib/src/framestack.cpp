@@ -0,0 +1,54 @@
+#include <stdexcept>
+
+#include "framestack.hpp"
+
+FrameStack::FrameStack()
+{
+}
+
+// Arguments are evaluated in the caller's frame and parked right above it;
+// the following Push() adopts them as the first slots of the callee.
+void FrameStack::PushArgument(Value value)
+{
+    this->slots.push_back(std::move(value));
+}
+
+void FrameStack::Push(int slot_count, int argument_count)
+{
+    size_t base = this->slots.size() - argument_count;
+    this->bases.push_back(base);
+    this->slots.resize(base + slot_count);
+}
+
+void FrameStack::Pop()
+{
+    if (this->bases.empty())
+    {
+        throw std::invalid_argument("No Frame Found.");
+    }
+    this->slots.resize(this->bases.back());
+    this->bases.pop_back();
+}
+
+// Unwinds everything above the global frame (used after a runtime error).
+void FrameStack::Reset()
+{
+    while (this->bases.size() > 1)
+    {
+        Pop();
+    }
+}
+
+// Functions are only declared globally, so the frame enclosing a call frame
+// is always the global one: depth 0 is the current frame, anything else the
+// bottom of the stack.
+Value& FrameStack::At(int depth, int slot)
+{
+    size_t base = depth == 0 ? this->bases.back() : this->bases.front();
+    return this->slots[base + slot];
+}
+
+size_t FrameStack::Size()
+{
+    return this->bases.size();
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <vector>
+
+#include "value.hpp"
+
+// Runtime storage for resolved variables. Every live call frame is a window
+// of 'slots' starting at its base offset, so a (depth, slot) address from the
+// Resolver is a single indexed load: no lookup by name, no copy.
+class FrameStack
+{
+public:
+	FrameStack();
+
+	void PushArgument(Value value);
+	void Push(int slot_count, int argument_count = 0);
+	void Pop();
+	void Reset();
+	Value& At(int depth, int slot);
+	size_t Size();
+
+private:
+	std::vector<Value> slots;
+	std::vector<size_t> bases;
+};
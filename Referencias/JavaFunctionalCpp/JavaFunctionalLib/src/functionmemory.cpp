@@ -1,27 +1,42 @@
-
 #include "functionmemory.hpp"
 
-void FunctionMemory::Add(FuncVariable func_var)
+FunctionHandle FunctionMemory::Add(FuncVariable func_var)
 {
-	if (this->func_vars.contains(func_var.identifier))
+	FunctionHandle handle = (FunctionHandle)this->functions.size();
+	if (not this->handles.emplace(func_var.identifier, handle).second)
 	{
-		throw std::invalid_argument("Function identifier '" + func_var.identifier + "' already declared.");
+		throw std::invalid_argument("Function identifier '" + SymbolName(func_var.identifier) + "' already declared.");
 	}
-	this->func_vars[func_var.identifier] = std::move(func_var);
+	this->functions.push_back(std::move(func_var));
+	return handle;
 }
 
-FuncVariable FunctionMemory::Get(std::string identifier)
+FunctionHandle FunctionMemory::Find(Symbol identifier)
 {
-	if (this->func_vars.contains(identifier))
+	auto found = this->handles.find(identifier);
+	if (found != this->handles.end())
 	{
-		return std::move(this->func_vars[identifier]);
+		return found->second;
 	}
-	throw std::invalid_argument("Function identifier '" + identifier + "' not declared.");
+	throw std::invalid_argument("Function identifier '" + SymbolName(identifier) + "' not declared.");
 }
 
-bool FunctionMemory::Exist(std::string identifier)
+FuncVariable& FunctionMemory::GetRef(Symbol identifier)
 {
-	return this->func_vars.contains(identifier);
+	return this->functions[Find(identifier)];
 }
 
+std::vector<Symbol> FunctionMemory::GetIdentifiers()
+{
+	std::vector<Symbol> identifiers;
+	for (FuncVariable& func_var : this->functions)
+	{
+		identifiers.push_back(func_var.identifier);
+	}
+	return identifiers;
+}
 
+bool FunctionMemory::Exist(Symbol identifier)
+{
+	return this->handles.contains(identifier);
+}
@@ -1,15 +1,28 @@
 #pragma once
+#include <cstdint>
 #include <unordered_map>
+#include <vector>
 
 #include "variable.hpp"
 
+// Index of a function in FunctionMemory. It stays valid for the lifetime
+// of the FunctionMemory, so a call site can keep it instead of looking its
+// name up again.
+typedef uint32_t FunctionHandle;
+static const FunctionHandle NO_FUNCTION = UINT32_MAX;
 
+// Functions are stored once, in declaration order, and looked up by name
+// only to find their handle.
 class FunctionMemory
 {
 public:
-	void Add(FuncVariable func_var);
-	FuncVariable Get(std::string identifier);
-	bool Exist(std::string identifier);
+	FunctionHandle Add(FuncVariable func_var);
+	FunctionHandle Find(Symbol identifier);
+	FuncVariable& At(FunctionHandle handle) { return this->functions[handle]; }
+	FuncVariable& GetRef(Symbol identifier);
+	std::vector<Symbol> GetIdentifiers();
+	bool Exist(Symbol identifier);
 private:
-	std::unordered_map<std::string, FuncVariable> func_vars;
-};
\ No newline at end of file
+	std::vector<FuncVariable> functions;
+	std::unordered_map<Symbol, FunctionHandle> handles;
+};
@@ -0,0 +1,284 @@
+#include <algorithm>
+
+#include "inliner.hpp"
+#include "ast_node_headers.hpp"
+#include "flatast.hpp"
+
+Inliner::Inliner(Arena& arena, FunctionMemory& function_memory, int global_slot_count)
+	: arena(arena), function_memory(function_memory), global_slot_count(global_slot_count), global_region(global_slot_count)
+{
+	for (Symbol identifier : this->function_memory.GetIdentifiers())
+	{
+		this->regions[identifier] = this->function_memory.GetRef(identifier).slot_count;
+	}
+}
+
+void Inliner::Inline(std::vector<AstNode*>& statements)
+{
+	this->stats.nodes_before = CountNodes(statements);
+	do
+	{
+		this->changed = false;
+		this->inlinable.clear();
+
+		this->slot_count = &this->global_slot_count;
+		this->region = this->global_region;
+		InlineStatements(statements);
+
+		for (Symbol identifier : this->function_memory.GetIdentifiers())
+		{
+			FuncVariable& func_var = this->function_memory.GetRef(identifier);
+			BlockStmtNode* body = NodeCast<BlockStmtNode>(func_var.block_stmt);
+			if (body != nullptr)
+			{
+				this->slot_count = &func_var.slot_count;
+				this->region = this->regions[identifier];
+				InlineStatements(body->stmts);
+			}
+		}
+	} while (this->changed);
+	this->stats.nodes_after = CountNodes(statements);
+}
+
+int Inliner::GetGlobalSlotCount()
+{
+	return this->global_slot_count;
+}
+
+InlinerStats Inliner::GetStats()
+{
+	return this->stats;
+}
+
+size_t Inliner::CountNodes(std::vector<AstNode*>& statements)
+{
+	size_t nodes = FlatAst::Flatten(statements).Size();
+	for (Symbol identifier : this->function_memory.GetIdentifiers())
+	{
+		FuncVariable& func_var = this->function_memory.GetRef(identifier);
+		if (func_var.block_stmt != nullptr)
+		{
+			nodes += FlatAst::Flatten(std::span<AstNode* const>(&func_var.block_stmt, 1)).Size();
+		}
+	}
+	return nodes;
+}
+
+// Within BUDGET and without calls, as the function is at the start of this
+// round: a body that inlines something this round is only considered in the
+// next one.
+bool Inliner::Inlinable(FuncVariable& func_var)
+{
+	auto found = this->inlinable.find(func_var.identifier);
+	if (found != this->inlinable.end())
+	{
+		return found->second;
+	}
+	bool inlinable = NodeCast<BlockStmtNode>(func_var.block_stmt) != nullptr;
+	if (inlinable)
+	{
+		FlatAst flat = FlatAst::Flatten(std::span<AstNode* const>(&func_var.block_stmt, 1));
+		inlinable = flat.Size() <= BUDGET;
+		for (uint32_t node = 0; inlinable && node < flat.Size(); node++)
+		{
+			inlinable = flat.Kind(node) != NODE_FUNCTION_CALL;
+		}
+	}
+	this->inlinable[func_var.identifier] = inlinable;
+	return inlinable;
+}
+
+void Inliner::InlineStatements(std::span<AstNode*> stmts)
+{
+	for (AstNode*& stmt : stmts)
+	{
+		if (stmt == nullptr)
+		{
+			continue;
+		}
+		switch (stmt->kind)
+		{
+			case NODE_FUNCTION_CALL:
+				stmt = InlineCall(*static_cast<FunctionCallExpr*>(stmt));
+				break;
+			case NODE_BLOCK:
+				InlineStatements(static_cast<BlockStmtNode*>(stmt)->stmts);
+				break;
+			case NODE_IF:
+				if (BlockStmtNode* block = NodeCast<BlockStmtNode>(static_cast<IfStmtNode*>(stmt)->blockStmt))
+				{
+					InlineStatements(block->stmts);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+// Returns the block replacing the call, or the call itself.
+AstNode* Inliner::InlineCall(FunctionCallExpr& functionCallExpr)
+{
+	if (not this->function_memory.Exist(functionCallExpr.identifier))
+	{
+		return &functionCallExpr;
+	}
+	FuncVariable& func_var = this->function_memory.GetRef(functionCallExpr.identifier);
+	if (func_var.parameters.size() != functionCallExpr.arguments.size())
+	{
+		return &functionCallExpr;
+	}
+	for (AstNode* argument : functionCallExpr.arguments)
+	{
+		if (not IsNumberType(argument->static_type) && argument->static_type != VAL_BOOL)
+		{
+			return &functionCallExpr;
+		}
+	}
+	if (not Inlinable(func_var))
+	{
+		return &functionCallExpr;
+	}
+
+	std::vector<AstNode*> stmts;
+	for (size_t i = 0; i < func_var.parameters.size(); i++)
+	{
+		Variable& parameter = func_var.parameters[i];
+		VarDeclarationNode* declaration = this->arena.New<VarDeclarationNode>(FromDataTypeToToken_t(parameter.dtType), parameter.identifier, functionCallExpr.arguments[i]);
+		declaration->depth = 0;
+		declaration->slot = this->region + (int)i;
+		stmts.push_back(declaration);
+	}
+	for (AstNode* stmt : static_cast<BlockStmtNode*>(func_var.block_stmt)->stmts)
+	{
+		stmts.push_back(Copy(stmt));
+	}
+	*this->slot_count = std::max(*this->slot_count, this->region + func_var.slot_count);
+	this->stats.calls++;
+	this->changed = true;
+	return this->arena.New<BlockStmtNode>(this->arena.CopyArray(stmts));
+}
+
+// Copies a node of the callee's body, addressed from the caller's frame. The
+// body is at most BUDGET nodes, so recursing is fine.
+AstNode* Inliner::Copy(AstNode* node)
+{
+	if (node == nullptr)
+	{
+		return nullptr;
+	}
+	Dispatch(*this, *node);
+	AstNode* copy = this->copied;
+	copy->static_type = node->static_type;
+	return copy;
+}
+
+// The callee's frame is the caller's region. Its globals stay global
+// reads, even from top-level code: they fail while not yet declared.
+void Inliner::Relocate(int& depth, int& slot)
+{
+	if (depth == 0)
+	{
+		slot += this->region;
+	}
+}
+
+Value Inliner::VisitBinaryExpression(BinaryExpression& binaryExpression)
+{
+	AstNode* left = Copy(binaryExpression.left);
+	AstNode* right = Copy(binaryExpression.right);
+	this->copied = this->arena.New<BinaryExpression>(left, binaryExpression.op, right);
+	return Value();
+}
+
+Value Inliner::VisitBoolNode(BoolNode& boolNode)
+{
+	this->copied = this->arena.New<BoolNode>(boolNode.value);
+	return Value();
+}
+
+Value Inliner::VisitNumberNode(NumberNode& numberNode)
+{
+	this->copied = this->arena.New<NumberNode>(numberNode.number);
+	return Value();
+}
+
+Value Inliner::VisitStringNode(StringNode& stringNode)
+{
+	this->copied = this->arena.New<StringNode>(stringNode.value);
+	return Value();
+}
+
+Value Inliner::VisitIdentifierNode(IdentifierNode& identifierNode)
+{
+	IdentifierNode* copy = this->arena.New<IdentifierNode>(identifierNode.identifier);
+	copy->depth = identifierNode.depth;
+	copy->slot = identifierNode.slot;
+	Relocate(copy->depth, copy->slot);
+	this->copied = copy;
+	return Value();
+}
+
+Value Inliner::VisitUnaryNode(UnaryNode& unaryNode)
+{
+	this->copied = this->arena.New<UnaryNode>(unaryNode.token, Copy(unaryNode.left));
+	return Value();
+}
+
+Value Inliner::VisitIfStmtNode(IfStmtNode& ifStmtNode)
+{
+	AstNode* expression = Copy(ifStmtNode.expression);
+	AstNode* block = Copy(ifStmtNode.blockStmt);
+	this->copied = this->arena.New<IfStmtNode>(expression, block);
+	return Value();
+}
+
+Value Inliner::VisitPrintStmt(PrintStmtNode& printStmtNode)
+{
+	this->copied = this->arena.New<PrintStmtNode>(Copy(printStmtNode.expression));
+	return Value();
+}
+
+Value Inliner::VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode)
+{
+	VarDeclarationNode* copy = this->arena.New<VarDeclarationNode>(varDeclarationNode.variableType, varDeclarationNode.identifier, Copy(varDeclarationNode.expression));
+	copy->depth = varDeclarationNode.depth;
+	copy->slot = varDeclarationNode.slot;
+	Relocate(copy->depth, copy->slot);
+	this->copied = copy;
+	return Value();
+}
+
+Value Inliner::VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode)
+{
+	VarAssignmentStmtNode* copy = this->arena.New<VarAssignmentStmtNode>(varAssignmentNode.identifier, Copy(varAssignmentNode.expression));
+	copy->depth = varAssignmentNode.depth;
+	copy->slot = varAssignmentNode.slot;
+	Relocate(copy->depth, copy->slot);
+	this->copied = copy;
+	return Value();
+}
+
+Value Inliner::VisitFunctionCallNode(FunctionCallExpr& functionCallExpr)
+{
+	std::vector<AstNode*> arguments;
+	for (AstNode* argument : functionCallExpr.arguments)
+	{
+		arguments.push_back(Copy(argument));
+	}
+	FunctionCallExpr* copy = this->arena.New<FunctionCallExpr>(functionCallExpr.identifier, this->arena.CopyArray(arguments));
+	copy->handle = functionCallExpr.handle;
+	this->copied = copy;
+	return Value();
+}
+
+Value Inliner::VisitBlockStmtNode(BlockStmtNode& blockStmtNode)
+{
+	std::vector<AstNode*> stmts;
+	for (AstNode* stmt : blockStmtNode.stmts)
+	{
+		stmts.push_back(Copy(stmt));
+	}
+	this->copied = this->arena.New<BlockStmtNode>(this->arena.CopyArray(stmts));
+	return Value();
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "arena.hpp"
+#include "visitor.hpp"
+#include "nodes/astnode.hpp"
+#include "variable.hpp"
+#include "functionmemory.hpp"
+
+struct InlinerStats
+{
+	size_t nodes_before = 0;
+	size_t nodes_after = 0;
+	size_t calls = 0; // call statements replaced by a copy of the body
+};
+
+// Static pass (-O1) run after the TypeChecker. A call statement 'f(a, b);'
+// whose callee calls nothing and has at most BUDGET nodes becomes the block
+// '{ <param 0> = a; <param 1> = b; <copy of the body> }' in the caller's
+// own frame. The copied locals and parameters get slots past the caller's
+// own: calls are statements, so two copies are never live at once and all
+// of a caller's copies share that region. Names play no part once resolved,
+// so a callee variable shadowing a caller's one is not a problem.
+// A function whose calls were all inlined may become inlinable itself, so
+// this repeats until no call changes; a recursive function never calls
+// nothing. A call is only inlined where the argument count matches and the
+// TypeChecker found every argument to be a number or a bool, the checks the
+// call would make at run time. Bodies built later by
+// Resolver::Materialize are not inlined.
+class Inliner final : public Visitor
+{
+public:
+	static const size_t BUDGET = 48;
+
+	Inliner(Arena& arena, FunctionMemory& function_memory, int global_slot_count);
+
+	void Inline(std::vector<AstNode*>& statements);
+	int GetGlobalSlotCount(); // grown by the slots of inlined locals
+	InlinerStats GetStats();
+
+private:
+	template <class V>
+	friend Value Dispatch(V& visitor, AstNode& node);
+
+	Arena& arena;
+	FunctionMemory& function_memory;
+	int global_slot_count;
+	int global_region;
+	std::unordered_map<Symbol, int> regions; // per function: first slot past its own
+	std::unordered_map<Symbol, bool> inlinable;
+	InlinerStats stats;
+	bool changed = false;
+
+	// the caller being rewritten
+	int* slot_count = nullptr;
+	int region = 0;
+
+	AstNode* copied = nullptr; // by the last Visit
+
+	size_t CountNodes(std::vector<AstNode*>& statements);
+	bool Inlinable(FuncVariable& func_var);
+	void InlineStatements(std::span<AstNode*> stmts);
+	AstNode* InlineCall(FunctionCallExpr& functionCallExpr);
+	AstNode* Copy(AstNode* node);
+	void Relocate(int& depth, int& slot);
+
+	Value VisitBinaryExpression(BinaryExpression& binaryExpression);
+	Value VisitBoolNode(BoolNode& boolNode);
+	Value VisitNumberNode(NumberNode& numberNode);
+	Value VisitStringNode(StringNode& stringNode);
+	Value VisitIdentifierNode(IdentifierNode& identifierNode);
+	Value VisitUnaryNode(UnaryNode& unaryNode);
+
+	Value VisitIfStmtNode(IfStmtNode& ifStmtNode);
+	Value VisitPrintStmt(PrintStmtNode& printStmtNode);
+	Value VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode);
+	Value VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode);
+
+	Value VisitFunctionCallNode(FunctionCallExpr& functionCallExpr);
+	Value VisitBlockStmtNode(BlockStmtNode& blockStmtNode);
+};
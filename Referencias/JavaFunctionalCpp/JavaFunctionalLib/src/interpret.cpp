@@ -1,26 +1,42 @@
-#include <variant>
-
 #include "interpret.hpp"
 
 #include "ast_node_headers.hpp"
 
-Interpreter::Interpreter(EnvStack env_stack, FunctionMemory& function_memory)
-    : function_memory(function_memory)
+// Evaluate() is the switch every node goes through. Inlining the visitors
+// that recurse into it would make every leaf pay their register saves, so
+// only the leaves are left for the compiler to inline.
+#if defined(__GNUC__) || defined(__clang__)
+#define OUT_OF_LINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define OUT_OF_LINE __declspec(noinline)
+#else
+#define OUT_OF_LINE
+#endif
+
+Interpreter::Interpreter(FunctionMemory& function_memory, int global_slot_count, Resolver* resolver)
+    : function_memory(function_memory), resolver(resolver)
 {
-    this->env_stack = std::move(env_stack);
+    this->frames.Push(global_slot_count);
 }
 
-std::any Interpreter::Interpret(std::unique_ptr<AstNode> root)
+Value Interpreter::Interpret(AstNode* root)
 {
     try
     {
-        return root->Accept(*this);
+        return Evaluate(root);
     }
     catch (std::invalid_argument& e)
     {
         Report(e.what());
+        this->frames.Reset();
+        this->chain.clear();
     }
-    return std::any();
+    return Value();
+}
+
+Value Interpreter::Evaluate(AstNode* node)
+{
+    return Dispatch(*this, *node);
 }
 
 void Interpreter::Report(std::string error)
@@ -33,245 +49,212 @@ std::vector<std::string> Interpreter::GetRuntimeErrors()
     return this->runtime_errors;
 }
 
-std::any Interpreter::VisitNumberNode(NumberNode& numberNode)
+Value Interpreter::VisitNumberNode(NumberNode& numberNode)
 {
     return numberNode.number;
 }
 
-std::any Interpreter::VisitStringNode(StringNode& stringNode)
+Value Interpreter::VisitStringNode(StringNode& stringNode)
 {
-    return stringNode.value;
+    return Value::String(stringNode.value);
 }
 
-std::any Interpreter::VisitIdentifierNode(IdentifierNode& identifierNode)
+// A function may run before a global it uses is declared: its slot is
+// still empty then.
+[[noreturn]] OUT_OF_LINE static void NotDeclared(Symbol identifier)
 {
-    std::pair<Variable, Environment> var = this->env_stack.Get(identifierNode.identifier);
-    return var.first.value;
+    throw std::invalid_argument("Variable Identifier '" + SymbolName(identifier) + "' not found.");
 }
 
-std::any Interpreter::VisitUnaryNode(UnaryNode& unaryNode)
+Value Interpreter::VisitIdentifierNode(IdentifierNode& identifierNode)
 {
-    std::any unary_expr = unaryNode.left->Accept(*this);
-    if (unary_expr.type() == typeid(NUMBER_DT))
+    Value& value = this->frames.At(identifierNode.depth, identifierNode.slot);
+    if (identifierNode.depth != 0 && value.IsEmpty())
     {
-        NUMBER_DT expr_unary = std::any_cast<NUMBER_DT>(unary_expr);
-        return std::visit([]<class T>(T var) -> NUMBER_DT
-        {
-            return -(T)var;
-        }, expr_unary);
+        NotDeclared(identifierNode.identifier);
     }
-    if (unary_expr.type() == typeid(bool))
-    {
-        bool expr_bool_result = std::any_cast<bool>(unary_expr);
-        if (unaryNode.token == BANG_TOKEN)
-        {
-            return !expr_bool_result;
-        }
-        throw std::invalid_argument("Runtime Error: Expected BANG TOKEN.");
-    }
-    std::string unary_err = unary_expr.type().name();
-    throw std::invalid_argument("Runtime Error: Invalid unary value type (found type '" + unary_err + "')");
+    return value;
 }
 
-std::any Interpreter::VisitIfStmtNode(IfStmtNode& ifStmtNode)
+OUT_OF_LINE Value Interpreter::VisitUnaryNode(UnaryNode& unaryNode)
 {
-    std::any expr_value = ifStmtNode.expression->Accept(*this);
-    std::string expr_typename = expr_value.type().name();
-    if (expr_value.type() == typeid(bool))
+    Value unary_expr = Evaluate(unaryNode.left);
+    if (unaryNode.quick == QUICK_NONE)
     {
-        bool if_result = std::any_cast<bool>(expr_value);
-        if (if_result)
-        {
-            ifStmtNode.blockStmt->Accept(*this);
-        }
+        unaryNode.quick = SpecializeUnary(unaryNode.token, unary_expr.type);
     }
-    else if (expr_value.type() == typeid(NUMBER_DT))
+    if (unaryNode.quick != QUICK_GENERIC)
     {
-        NUMBER_DT expr_number = std::any_cast<NUMBER_DT>(expr_value);
-        bool if_result = std::visit([]<class T>(T var) -> bool
+        Value value = UNARY_EXECUTORS[unaryNode.quick](unary_expr);
+        if (not value.IsEmpty())
         {
-            if (var == 1)
-            {
-                return true;
-            }
-            return false;
-        }, expr_number);
-        if (if_result)
-        {
-            ifStmtNode.blockStmt->Accept(*this);
+            return value;
         }
+        unaryNode.quick = QUICK_GENERIC;
     }
-    else
-    {
-        throw std::invalid_argument("Runtime Error: If expressions must return a bool (found type '" + expr_typename + "')");
-    }
-    return std::any();
+    return UnaryOperation(unaryNode.token, unary_expr);
 }
 
-std::any Interpreter::VisitPrintStmt(PrintStmtNode& printStmtNode)
+OUT_OF_LINE Value Interpreter::VisitIfStmtNode(IfStmtNode& ifStmtNode)
 {
-    std::any expr_r = printStmtNode.expression->Accept(*this);
-
-    if (expr_r.type() == typeid(NUMBER_DT))
-    {
-        NUMBER_DT expr_num = std::any_cast<NUMBER_DT>(expr_r);
-        std::visit([]<class T>(T value)
-        {
-            std::cout << value;
-        }, expr_num);
-    }
-    else if (expr_r.type() == typeid(bool))
-    {
-        bool r = std::any_cast<bool>(expr_r);
-        std::cout << r ? "true" : "false";
-    }
-    else if (expr_r.type() == typeid(std::string))
-    {
-        std::cout << std::any_cast<std::string>(expr_r);
-    }
-    else if (expr_r.type() == typeid(nullptr))
+    Value expr_value = Evaluate(ifStmtNode.expression);
+    bool condition = ifStmtNode.expression->static_type == VAL_BOOL ? expr_value.AsBool() : IfCondition(expr_value);
+    if (condition)
     {
-        std::cout << "null";
+        Evaluate(ifStmtNode.blockStmt);
     }
-    else
+    return Value();
+}
+
+OUT_OF_LINE Value Interpreter::VisitPrintStmt(PrintStmtNode& printStmtNode)
+{
+    Value expr_r = Evaluate(printStmtNode.expression);
+    if (expr_r.IsEmpty())
     {
-        std::string expr_err = expr_r.type().name();
-        throw std::invalid_argument("Runtime Error: Invalid expression (found: " + expr_err + ") in print statement.");
+        throw std::invalid_argument("Runtime Error: Invalid expression (found: " + ValueTypeName(expr_r.type) + ") in print statement.");
     }
-    return std::any();
+    std::cout << expr_r;
+    return Value();
 }
 
-std::any Interpreter::VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode)
+OUT_OF_LINE Value Interpreter::VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode)
 {
-    Variable var;
-    var.dtType = FromToken_tToDataType(varDeclarationNode.variableType);
-    var.identifier = varDeclarationNode.identifier;
-    var.value = nullptr;
+    Value value = nullptr;
     if (varDeclarationNode.expression != nullptr)
     {
-        var.value = varDeclarationNode.expression->Accept(*this);
+        value = Evaluate(varDeclarationNode.expression);
     }
-    this->env_stack.Add(var);
-    
-    return std::any();
+    this->frames.At(varDeclarationNode.depth, varDeclarationNode.slot) = std::move(value);
+
+    return Value();
 }
 
-std::any Interpreter::VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode)
+OUT_OF_LINE Value Interpreter::VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode)
 {
-    std::string identifier = varAssignmentNode.identifier;
-    std::any value = varAssignmentNode.expression->Accept(*this);
-    this->env_stack.Assign(identifier, value);
-    
-    return std::any();
+    Value value = Evaluate(varAssignmentNode.expression);
+    Value& variable = this->frames.At(varAssignmentNode.depth, varAssignmentNode.slot);
+    if (varAssignmentNode.depth != 0 && variable.IsEmpty())
+    {
+        NotDeclared(varAssignmentNode.identifier);
+    }
+    variable = std::move(value);
+
+    return Value();
 }
 
-std::any Interpreter::VisitFunctionCallNode(FunctionCallExpr& functionCallExpr)
+OUT_OF_LINE Value Interpreter::VisitFunctionCallNode(FunctionCallExpr& functionCallExpr)
 {
-    FuncVariable func_var = this->function_memory.Get(functionCallExpr.identifier);
+    // a monomorphic cache: functions are never redeclared, so the handle
+    // found on the first call holds for every later one
+    if (functionCallExpr.handle == NO_FUNCTION)
+    {
+        functionCallExpr.handle = this->function_memory.Find(functionCallExpr.identifier);
+    }
+    FuncVariable& func_var = this->function_memory.At(functionCallExpr.handle);
     if (func_var.parameters.size() != functionCallExpr.arguments.size())
     {
-        throw std::invalid_argument("Parameter size for funciton '" + func_var.identifier + "' is invalid for its arguments.");
+        throw std::invalid_argument("Parameter size for funciton '" + SymbolName(func_var.identifier) + "' is invalid for its arguments.");
+    }
+    if (func_var.block_stmt == nullptr && this->resolver != nullptr)
+    {
+        this->resolver->Materialize(func_var);
     }
     for (int i = 0; i < func_var.parameters.size(); i++)
     {
-        Variable& var = func_var.parameters.at(i);
-        std::any par_expr = functionCallExpr.arguments.at(i)->Accept(*this);
+        Value par_expr = Evaluate(functionCallExpr.arguments[i]);
 
-        if (par_expr.type() == typeid(NUMBER_DT))
-        {
-            var.value = std::any_cast<NUMBER_DT>(par_expr);
-        }
-        else if (par_expr.type() == typeid(bool))
+        if (not par_expr.IsNumber() && not par_expr.IsBool())
         {
-            var.value = std::any_cast<bool>(par_expr);
-        }
-        else
-        {
-            throw std::invalid_argument("Function '" + func_var.identifier + "' have an invalid parameter: " + par_expr.type().name());
+            throw std::invalid_argument("Function '" + SymbolName(func_var.identifier) + "' have an invalid parameter: " + ValueTypeName(par_expr.type));
         }
+        this->frames.PushArgument(std::move(par_expr));
     }
-    this->buffer_function_parameters = func_var.parameters;
-    func_var.block_stmt->Accept(*this);
-    this->env_stack.Pop();
+    this->frames.Push(func_var.slot_count, (int)func_var.parameters.size());
+    Evaluate(func_var.block_stmt);
+    this->frames.Pop();
     return {};
 }
 
-std::any Interpreter::VisitBlockStmtNode(BlockStmtNode& blockStmtNode)
+OUT_OF_LINE Value Interpreter::VisitBlockStmtNode(BlockStmtNode& blockStmtNode)
 {
-    Environment block_env;
-    std::vector<Variable> args = this->buffer_function_parameters;
-    this->buffer_function_parameters = {};
-    for (Variable var : args)
-    {
-        block_env.env_var.Set(var);
-    }
-    this->env_stack.Push(std::move(block_env));
     for (auto& stmt : blockStmtNode.stmts)
     {
-        stmt->Accept(*this);
+        Evaluate(stmt);
     }
     return {};
 }
 
-std::any Interpreter::VisitBinaryExpression(BinaryExpression& binaryExpression)
+// Evaluates 'left op right' through the executor the node specializes
+// itself for on its first evaluation (quicken.hpp), or generically once the
+// executor's guard has failed.
+OUT_OF_LINE static Value Quickened(BinaryExpression& binaryExpression, Value left, Value right)
 {
-    std::any left = binaryExpression.left->Accept(*this);
-    std::any right = binaryExpression.right->Accept(*this);
-    Token_t op = binaryExpression.op;
-
-    if (left.type() == typeid(NUMBER_DT) && right.type() == typeid(NUMBER_DT))
+    if (binaryExpression.quick == QUICK_NONE)
     {
-        NUMBER_DT left_num = std::any_cast<NUMBER_DT>(left);
-        NUMBER_DT right_num = std::any_cast<NUMBER_DT>(right);
-
-        NUMBER_DT result = std::visit([op]<class T1, class T2>(T1 lvar, T2 rvar) -> NUMBER_DT
+        binaryExpression.quick = SpecializeBinary(binaryExpression.op, left.type, right.type);
+    }
+    if (binaryExpression.quick != QUICK_GENERIC)
+    {
+        Value value = BINARY_EXECUTORS[binaryExpression.quick](left, right);
+        if (not value.IsEmpty())
         {
-            switch (op)
-            {
-                case PLUS_TOKEN:
-                    return (T1)lvar + (T2)rvar;
-                case MINUS_TOKEN:
-                    return (T1)lvar - (T2)rvar;
-                case STAR_TOKEN:
-                    return (T1)lvar * (T2)rvar;
-                case SLASH_TOKEN:
-                    return (T1)lvar / (T2)rvar;
-
-                case EQUAL_EQUAL_TOKEN:
-                    return (bool)((T1)lvar == (T2)rvar);
-                case BANG_EQUAL_TOKEN:
-                    return (bool)((T1)lvar != (T2)rvar);
-                default:
-                    std::string left_err = typeid(lvar).name();
-                    std::string right_err = typeid(rvar).name();
-                    throw std::invalid_argument("Runtime Error: couldn't evaluate type '" + left_err + "' with type '" + right_err + "'");
-            }
-        }, left_num, right_num);
-
-        return result;
+            return value;
+        }
+        binaryExpression.quick = QUICK_GENERIC;
     }
+    return BinaryOperation(binaryExpression.op, left, right);
+}
 
-    if (left.type() == typeid(bool) && right.type() == typeid(bool))
+// With both operand types known statically (TypeChecker), the operation is
+// picked from them and the operands read without checking their tags.
+static Value Binary(BinaryExpression& binaryExpression, Value left, Value right)
+{
+    ValueType left_type = binaryExpression.left->static_type;
+    ValueType right_type = binaryExpression.right->static_type;
+    if (IsNumberType(left_type) && IsNumberType(right_type))
     {
-        bool lvar = std::any_cast<bool>(left);
-        bool rvar = std::any_cast<bool>(right);
-
-        switch (op)
+        Token_t op = binaryExpression.op;
+        switch (PromoteNumbers(left_type, right_type))
         {
-            case AMPERSAND_AMPERSAND_TOKEN:
-                return lvar && rvar;
-            case PIPE_PIPE_TOKEN:
-                return lvar || rvar;
+            case VAL_INT:
+                return Arithmetic<int>(op, left.Unbox<int>(left_type), right.Unbox<int>(right_type));
+            case VAL_LONG:
+                return Arithmetic<long>(op, left.Unbox<long>(left_type), right.Unbox<long>(right_type));
+            case VAL_FLOAT:
+                return Arithmetic<float>(op, left.Unbox<float>(left_type), right.Unbox<float>(right_type));
+            case VAL_DOUBLE:
+                return Arithmetic<double>(op, left.Unbox<double>(left_type), right.Unbox<double>(right_type));
+            default:
+                break;
         }
-        std::string op_err = TokenName(op);
-        throw std::invalid_argument("Runtime Error: Invalid value type (found type '" + op_err + "')");
     }
-    std::string left_err = left.type().name();
-    std::string right_err = right.type().name();
-    throw std::invalid_argument("Runtime Error: couldn't evaluate type '" + left_err + "' with type '" + right_err + "'");
+    return Quickened(binaryExpression, left, right);
+}
+
+OUT_OF_LINE Value Interpreter::VisitBinaryExpression(BinaryExpression& binaryExpression)
+{
+    if (binaryExpression.chain == 0)
+    {
+        Value left = Evaluate(binaryExpression.left);
+        Value right = Evaluate(binaryExpression.right);
+        return Binary(binaryExpression, left, right);
+    }
+
+    // a left-leaning chain is folded in a loop, innermost operator first
+    size_t first = this->chain.size();
+    binaryExpression.Chain(this->chain);
+    Value value = Evaluate(this->chain[first]->left);
+    for (size_t i = first; i < this->chain.size(); i++)
+    {
+        BinaryExpression* node = this->chain[i];
+        Value right = Evaluate(node->right);
+        value = Binary(*node, value, right);
+    }
+    this->chain.resize(first);
+    return value;
 }
 
-std::any Interpreter::VisitBoolNode(BoolNode& boolNode)
+Value Interpreter::VisitBoolNode(BoolNode& boolNode)
 {
     return boolNode.value;
 }
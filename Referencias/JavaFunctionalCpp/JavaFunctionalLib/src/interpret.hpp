@@ -1,45 +1,50 @@
 #pragma once
 #include <iostream>
-#include <any>
 #include "visitor.hpp"
 #include "token.hpp"
 #include "variable.hpp"
 
 #include "ast_node_headers.hpp"
 
-#include "environment.hpp"
 #include "functionmemory.hpp"
-#include "envstack.hpp"
+#include "framestack.hpp"
+#include "resolver.hpp"
 
-class Interpreter : public Visitor {
+class Interpreter final : public Visitor {
 public:
-	Interpreter(EnvStack env_stack, FunctionMemory& function_memory);
-	std::any Interpret(std::unique_ptr<AstNode> root);
+	Interpreter(FunctionMemory& function_memory, int global_slot_count, Resolver* resolver = nullptr);
+	Value Interpret(AstNode* root);
 	std::vector<std::string> GetRuntimeErrors();
 
 
 private:
-	EnvStack env_stack;
+	FrameStack frames;
 	FunctionMemory& function_memory;
-	std::vector<Variable> buffer_function_parameters;
+	Resolver* resolver; // builds PARSE_LAZY bodies on their first call
+	std::vector<BinaryExpression*> chain; // BinaryExpression::Chain of the expressions being evaluated
 
 	std::vector<std::string> runtime_errors;
 	void Report(std::string error);
 
-	std::any VisitBinaryExpression(BinaryExpression& binaryExpression);
-	std::any VisitBoolNode(BoolNode& boolNode);
-	std::any VisitNumberNode(NumberNode& numberNode);
-	std::any VisitStringNode(StringNode& stringNode);
-	std::any VisitIdentifierNode(IdentifierNode& identifierNode);
-	std::any VisitUnaryNode(UnaryNode& unaryNode);
-
-	std::any VisitIfStmtNode(IfStmtNode& ifStmtNode);
-	std::any VisitPrintStmt(PrintStmtNode& printStmtNode);
-	std::any VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode);
-	std::any VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode);
-
-	std::any VisitFunctionCallNode(FunctionCallExpr& functionCallExpr);
-	std::any VisitBlockStmtNode(BlockStmtNode& blockStmtNode);
+	// children are evaluated through a switch on their kind, not Accept
+	template <class V>
+	friend Value Dispatch(V& visitor, AstNode& node);
+	Value Evaluate(AstNode* node);
+
+	Value VisitBinaryExpression(BinaryExpression& binaryExpression);
+	Value VisitBoolNode(BoolNode& boolNode);
+	Value VisitNumberNode(NumberNode& numberNode);
+	Value VisitStringNode(StringNode& stringNode);
+	Value VisitIdentifierNode(IdentifierNode& identifierNode);
+	Value VisitUnaryNode(UnaryNode& unaryNode);
+
+	Value VisitIfStmtNode(IfStmtNode& ifStmtNode);
+	Value VisitPrintStmt(PrintStmtNode& printStmtNode);
+	Value VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode);
+	Value VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode);
+
+	Value VisitFunctionCallNode(FunctionCallExpr& functionCallExpr);
+	Value VisitBlockStmtNode(BlockStmtNode& blockStmtNode);
 };
 
 
@@ -0,0 +1,19 @@
+#pragma once
+#include <memory>
+
+#include "program.hpp"
+#include "scopetable.hpp"
+#include "sourcebuffer.hpp"
+
+// A top-level function body PARSE_LAZY only brace-matched: its byte range
+// in the source, which it keeps alive. Parser::ParseLazyBody builds the
+// body into 'program' the first time the function is needed; until then
+// the FuncVariable has no block_stmt.
+struct LazyBody
+{
+	std::shared_ptr<const SourceBuffer> source;
+	size_t begin = 0; // offset of the body's '{'
+	size_t end = 0;   // one past its matching '}'
+	std::shared_ptr<const ScopeTable> scopes; // the top-level scopes once the whole source is parsed
+	Program program;
+};
@@ -2,12 +2,148 @@
 
 #include "lexer.hpp"
 #include "syntaxtoken.hpp"
+#include "scan.hpp"
+#include "tokenbuffer.hpp"
+#include "workers.hpp"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
 #include <iostream>
 #include <map>
 
-Lexer::Lexer(std::string program)
+// Character classes, one table lookup per byte instead of the locale-aware
+// <cctype> calls. Bytes outside ASCII belong to no class.
+enum CharClass : uint8_t
+{
+	CHAR_SPACE = 1 << 0,
+	CHAR_DIGIT = 1 << 1,
+	CHAR_IDENTIFIER_START = 1 << 2, // letter or '_'
+	CHAR_IDENTIFIER = 1 << 3        // letter, digit or '_'
+};
+
+static constexpr std::array<uint8_t, 256> MakeCharClasses()
+{
+	std::array<uint8_t, 256> classes{};
+	for (char c : { ' ', '\t', '\n', '\v', '\f', '\r' })
+	{
+		classes[(unsigned char)c] |= CHAR_SPACE;
+	}
+	for (int c = '0'; c <= '9'; c++)
+	{
+		classes[c] |= CHAR_DIGIT | CHAR_IDENTIFIER;
+	}
+	for (int c = 'a'; c <= 'z'; c++)
+	{
+		classes[c] |= CHAR_IDENTIFIER_START | CHAR_IDENTIFIER;
+		classes[c - 'a' + 'A'] |= CHAR_IDENTIFIER_START | CHAR_IDENTIFIER;
+	}
+	classes['_'] |= CHAR_IDENTIFIER_START | CHAR_IDENTIFIER;
+	return classes;
+}
+
+static constexpr std::array<uint8_t, 256> char_classes = MakeCharClasses();
+
+static bool IsSpace(char c)
+{
+	return char_classes[(unsigned char)c] & CHAR_SPACE;
+}
+
+static bool IsDigit(char c)
+{
+	return char_classes[(unsigned char)c] & CHAR_DIGIT;
+}
+
+static bool IsIdentifierStart(char c)
+{
+	return char_classes[(unsigned char)c] & CHAR_IDENTIFIER_START;
+}
+
+static bool IsIdentifier(char c)
+{
+	return char_classes[(unsigned char)c] & CHAR_IDENTIFIER;
+}
+
+// Keywords and type names, dispatched on length and first character so a
+// word is compared against at most two candidates. Anything else is an
+// identifier.
+static constexpr Token_t KeywordToken(std::string_view text)
+{
+	switch (text.size())
+	{
+	case 2:
+		return text == "if" ? IF_KW : IDENTIFIER_TOKEN;
+	case 3:
+		return text == "int" ? INT_TYPE : IDENTIFIER_TOKEN;
+	case 4:
+		switch (text[0])
+		{
+		case 'b':
+			return text == "bool" ? BOOL_TYPE : IDENTIFIER_TOKEN;
+		case 'l':
+			return text == "long" ? LONG_TYPE : IDENTIFIER_TOKEN;
+		case 't':
+			return text == "true" ? TRUE_TOKEN : IDENTIFIER_TOKEN;
+		}
+		return IDENTIFIER_TOKEN;
+	case 5:
+		switch (text[0])
+		{
+		case 'p':
+			return text == "print" ? PRINT_KW : IDENTIFIER_TOKEN;
+		case 's':
+			return text == "short" ? SHORT_TYPE : IDENTIFIER_TOKEN;
+		case 'f':
+			return text == "float" ? FLOAT_TYPE : text == "false" ? FALSE_TOKEN : IDENTIFIER_TOKEN;
+		}
+		return IDENTIFIER_TOKEN;
+	case 6:
+		switch (text[0])
+		{
+		case 'd':
+			return text == "double" ? DOUBLE_TYPE : IDENTIFIER_TOKEN;
+		case 'r':
+			return text == "return" ? RETURN_KW : IDENTIFIER_TOKEN;
+		}
+		return IDENTIFIER_TOKEN;
+	}
+	return IDENTIFIER_TOKEN;
+}
+
+struct Keyword
+{
+	std::string_view text;
+	Token_t token;
+};
+
+// must agree with DisplayToken()
+static constexpr Keyword keywords[] = {
+	{ "bool", BOOL_TYPE }, { "short", SHORT_TYPE }, { "int", INT_TYPE }, { "long", LONG_TYPE },
+	{ "float", FLOAT_TYPE }, { "double", DOUBLE_TYPE }, { "print", PRINT_KW }, { "false", FALSE_TOKEN },
+	{ "true", TRUE_TOKEN }, { "if", IF_KW }, { "return", RETURN_KW }
+};
+
+static constexpr bool KeywordTokenMatchesKeywords()
+{
+	for (const Keyword& keyword : keywords)
+	{
+		if (KeywordToken(keyword.text) != keyword.token ||
+			KeywordToken(keyword.text.substr(1)) != IDENTIFIER_TOKEN ||
+			KeywordToken(keyword.text.substr(0, keyword.text.size() - 1)) != IDENTIFIER_TOKEN)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static_assert(KeywordTokenMatchesKeywords(), "KeywordToken() is out of sync with the keyword list");
+
+Lexer::Lexer(std::string_view program, size_t start, SymbolTable& symbols)
 {
 	this->program = program;
+	this->index = start;
+	this->symbols = &symbols;
 }
 
 char Lexer::Current()
@@ -40,119 +176,282 @@ void Lexer::advance()
 	}
 }
 
-std::vector<SyntaxToken> Lexer::LexAll()
+TokenBuffer Lexer::LexAll()
+{
+	TokenBuffer tokens(this->program);
+	LexInto(tokens);
+	tokens.ShrinkToFit();
+	return tokens;
+}
+
+void Lexer::LexInto(TokenBuffer& tokens)
+{
+	while (true)
+	{
+		SyntaxToken token = Lex();
+		tokens.Push(token);
+		if (token.GetToken_t() == NUMBER_LITERAL_TOKEN)
+		{
+			tokens.PushNumber(this->number);
+		}
+		if (token.GetToken_t() == END_OF_FILE_TOKEN || token.GetToken_t() == BAD_TOKEN)
+		{
+			break;
+		}
+	}
+}
+
+// Chunk boundaries for LexAllParallel: the first newline at or after each
+// of the 'count' - 1 evenly spaced targets that lies outside any string
+// literal or comment. Skipping those follows the Lexer's own rules (no
+// escapes in strings, comments end at the first "*" "/"), so the lexer is
+// between tokens at every boundary. An unterminated literal or comment ends
+// the search; the rest goes to the last chunk. Only quotes, slashes and,
+// past the target, newlines matter, so the scan jumps between them.
+static std::vector<size_t> SplitPoints(std::string_view text, size_t count)
+{
+	std::vector<size_t> splits = { 0 };
+	size_t i = 0;
+	for (size_t k = 1; k < count; k++)
+	{
+		size_t target = text.size() / count * k;
+		while (i < text.size())
+		{
+			if (i < target)
+			{
+				i = FindAnyOf(text.substr(0, target), i, '"', '/');
+				if (i == std::string_view::npos)
+				{
+					i = target;
+					continue;
+				}
+			}
+			else
+			{
+				i = FindAnyOf(text, i, '"', '/', '\n');
+				if (i == std::string_view::npos)
+				{
+					i = text.size();
+					break;
+				}
+			}
+			char c = text[i];
+			if (c == '"')
+			{
+				i = FindQuote(text, i + 1);
+				if (i == std::string_view::npos)
+				{
+					return splits;
+				}
+			}
+			else if (c == '/' && i + 1 < text.size() && text[i + 1] == '*')
+			{
+				i = FindCommentEnd(text, i + 2);
+				if (i == std::string_view::npos)
+				{
+					return splits;
+				}
+				i++; // past the '*'
+			}
+			else if (c == '\n' && i >= target)
+			{
+				i++;
+				break;
+			}
+			i++;
+		}
+		if (i >= text.size())
+		{
+			break;
+		}
+		splits.push_back(i);
+	}
+	return splits;
+}
+
+// Source bytes per token, for sizing a chunk's buffer before it is lexed.
+// Below what real programs average, so a chunk rarely grows its arrays.
+static constexpr size_t BYTES_PER_TOKEN = 4;
+
+// Lexes newline-aligned chunks on worker threads and stitches them in
+// order. Each chunk lexer sees the whole source up to its chunk's end, so
+// offsets and error positions are already absolute. Workers intern into
+// private tables; their names are re-interned chunk by chunk, in first-seen
+// order, so tokens and Symbols are identical to LexAll(). As in LexAll(),
+// nothing after the first BAD_TOKEN is kept.
+TokenBuffer Lexer::LexAllParallel(size_t threads, size_t min_chunk)
 {
-	std::vector<SyntaxToken> tokens;
-	//temp 'token' will be overwritten.
-	SyntaxToken token = SyntaxToken::SyntaxToken(END_OF_FILE_TOKEN, "", 0, 0, 0);
-	while (token.GetToken_t() != BAD_TOKEN)
+	if (threads == 0)
 	{
-		token = Lex();
-		if (token.GetToken_t() == END_OF_FILE_TOKEN)
+		threads = DefaultThreads();
+	}
+	std::string_view rest = this->program.substr(this->index);
+	size_t count = std::min(threads, std::max<size_t>(1, rest.size() / std::max<size_t>(1, min_chunk)));
+	if (count <= 1)
+	{
+		return LexAll();
+	}
+
+	std::vector<size_t> splits = SplitPoints(rest, count);
+	for (size_t& split : splits)
+	{
+		split += this->index;
+	}
+	splits.push_back(this->program.size());
+	size_t chunks = splits.size() - 1;
+
+	std::vector<SymbolTable> tables(chunks);
+	std::vector<TokenChunk> lexed(chunks);
+	std::vector<std::vector<std::string>> errors(chunks);
+	RunWorkers(chunks, [&](size_t c)
+	{
+		Lexer lexer(this->program.substr(0, splits[c + 1]), splits[c], tables[c]);
+		lexed[c].tokens = TokenBuffer(this->program);
+		lexed[c].tokens.Reserve((splits[c + 1] - splits[c]) / BYTES_PER_TOKEN);
+		lexer.LexInto(lexed[c].tokens);
+		errors[c] = lexer.GetErrorReports();
+	});
+
+	// Sequential part: global Symbols in chunk order. Every chunk but the
+	// last ends in an END_OF_FILE_TOKEN of its own, which is dropped.
+	size_t used = 0; // chunks up to and including the first BAD_TOKEN
+	for (size_t c = 0; c < chunks; c++)
+	{
+		used = c + 1;
+		lexed[c].symbols.reserve(tables[c].Size());
+		for (Symbol local = 0; local < tables[c].Size(); local++)
+		{
+			lexed[c].symbols.push_back(this->symbols->Intern(tables[c].Name(local)));
+		}
+		this->error_reports.insert(this->error_reports.end(), errors[c].begin(), errors[c].end());
+
+		const TokenBuffer& chunk = lexed[c].tokens;
+		bool last = used == chunks || chunk.Kind(chunk.Size() - 1) == BAD_TOKEN;
+		lexed[c].count = last ? chunk.Size() : chunk.Size() - 1;
+		if (last)
 		{
-			tokens.push_back(token); // pushing END_OF_FILE_TOKEN
 			break;
 		}
-		tokens.push_back(token);
 	}
+	lexed.resize(used);
+
+	TokenBuffer tokens(this->program);
+	tokens.Resize(lexed);
+	RunWorkers(used, [&](size_t c)
+	{
+		tokens.Place(lexed, c);
+	});
+	this->index = this->program.size();
 	return tokens;
 }
 
-SyntaxToken Lexer::Lex()
+const NumberLiteral& Lexer::GetNumber()
 {
-	if (Current() == '\0')
+	return this->number;
+}
+
+// Literals are decoded once, here, with std::from_chars: no allocation and no
+// dependence on the C locale. Range problems are only flagged; whether a
+// value fits depends on the type the parser gives the literal.
+static NumberLiteral DecodeNumber(std::string_view text)
+{
+	NumberLiteral number;
+	const char* begin = text.data();
+	const char* end = begin + text.size();
+	const char* dot = std::find(begin, end, '.');
+	number.is_floating = dot != end;
+
+	std::from_chars_result integer = std::from_chars(begin, dot, number.integer);
+	number.integer_fits = integer.ec == std::errc();
+
+	// over the whole text even without a '.': an integer too long for a
+	// long long can still be a double
+	std::from_chars_result real = std::from_chars(begin, end, number.real);
+	number.real_fits = real.ec == std::errc();
+	return number;
+}
+
+std::vector<std::string> Lexer::GetErrorReports()
+{
+	return this->error_reports;
+}
+
+void Lexer::Report(std::string error)
+{
+	this->error_reports.push_back(error);
+}
+
+// Skips whitespace and /* */ comments in runs.
+// Returns false on an unterminated comment.
+bool Lexer::SkipTrivia()
+{
+	while (true)
 	{
-		return SyntaxToken(END_OF_FILE_TOKEN, "", this->index, 0, this->row);
+		if (IsSpace(Current()))
+		{
+			this->index = SkipWhitespace(this->program, this->index);
+		}
+		if (Current() != '/' || PeekNext() != '*')
+		{
+			return true;
+		}
+		size_t end = FindCommentEnd(this->program, this->index + 2);
+		if (end == std::string_view::npos)
+		{
+			Report("Unterminated comment starting at " + LineTable(this->program).Describe(this->index) + ".");
+			return false;
+		}
+		this->index = end + 2;
 	}
-	while (Current() == '\n')
+}
+
+SyntaxToken Lexer::Lex()
+{
+	if (not SkipTrivia())
 	{
-		this->row++;
-		advance();
+		size_t start = this->index;
+		this->index = this->program.size();
+		return SyntaxToken(BAD_TOKEN, "", start, 0);
 	}
-	while (isspace(Current()))
+	if (this->index >= this->program.size())
 	{
-		advance();
+		return SyntaxToken(END_OF_FILE_TOKEN, "", this->index, 0);
 	}
-	if (isdigit(Current()))
+	if (IsDigit(Current()))
 	{
 		size_t start = this->index;
-		while (isdigit(Current()))
+		while (IsDigit(Current()))
 		{
 			advance();
 		}
 		if (Current() == '.')
 		{
 			advance();
-			while (isdigit(Current()))
+			while (IsDigit(Current()))
 			{
 				advance();
 			}
 		}
 		size_t length = this->index - start;
-		std::string text = this->program.substr(start, length);
-		return SyntaxToken(NUMBER_LITERAL_TOKEN, text, start, this->row, length);
+		std::string_view text = this->program.substr(start, length);
+		this->number = DecodeNumber(text);
+		return SyntaxToken(NUMBER_LITERAL_TOKEN, text, start, length);
 	}
-	if (isalpha(Current()) || Current() == '_')
+	if (IsIdentifierStart(Current()))
 	{
 		size_t start = this->index;
-		while (Current() == '_' || isalpha(Current()))
+		while (IsIdentifier(Current()))
 		{
 			advance();
-			while (isdigit(Current()))
-			{
-				advance();
-			}
 		}
 		size_t length = this->index - start;
-		std::string text = this->program.substr(start, length);
-		if (text == DisplayToken(PRINT_KW))
-		{
-			return SyntaxToken(PRINT_KW, DisplayToken(PRINT_KW), start, this->row, length);
-		}
-		if (text == DisplayToken(FALSE_TOKEN))
-		{
-			return SyntaxToken(FALSE_TOKEN, DisplayToken(FALSE_TOKEN), start, this->row, length);
-		}
-		if (text == DisplayToken(TRUE_TOKEN))
-		{
-			return SyntaxToken(TRUE_TOKEN, DisplayToken(TRUE_TOKEN), start, this->row, length);
-		}
-
-		if (text == DisplayToken(BOOL_TYPE))
-		{
-			return SyntaxToken(BOOL_TYPE, DisplayToken(BOOL_TYPE), start, this->row, length);
-		}
-		if (text == DisplayToken(SHORT_TYPE))
-		{
-			return SyntaxToken(SHORT_TYPE, DisplayToken(SHORT_TYPE), start, this->row, length);
-		}
-		if (text == DisplayToken(INT_TYPE))
-		{
-			return SyntaxToken(INT_TYPE, DisplayToken(INT_TYPE), start, this->row, length);
-		}
-		if (text == DisplayToken(LONG_TYPE))
-		{
-			return SyntaxToken(LONG_TYPE, DisplayToken(LONG_TYPE), start, this->row, length);
-		}
-		if (text == DisplayToken(FLOAT_TYPE))
-		{
-			return SyntaxToken(FLOAT_TYPE, DisplayToken(FLOAT_TYPE), start, this->row, length);
-		}
-		if (text == DisplayToken(DOUBLE_TYPE))
+		std::string_view text = this->program.substr(start, length);
+		Token_t keyword = KeywordToken(text);
+		if (keyword != IDENTIFIER_TOKEN)
 		{
-			return SyntaxToken(DOUBLE_TYPE, DisplayToken(DOUBLE_TYPE), start, this->row, length);
+			return SyntaxToken(keyword, text, start, length);
 		}
-
-		if (text == DisplayToken(IF_KW))
-		{
-			return SyntaxToken(IF_KW, DisplayToken(IF_KW), start, this->row, length);
-		}
-		if (text == DisplayToken(RETURN_KW))
-		{
-			return SyntaxToken(RETURN_KW, DisplayToken(RETURN_KW), start, this->row, length);
-		}
-
-		return SyntaxToken(IDENTIFIER_TOKEN, text, start, this->row, length);
+		return SyntaxToken(IDENTIFIER_TOKEN, text, start, length, this->symbols->Intern(text));
 	}
 
 	switch (Current())
@@ -161,118 +460,106 @@ SyntaxToken Lexer::Lex()
 		if (PeekNext() == '+' && LookAhead(2) == '+')
 		{
 			this->index += 3;
-			return SyntaxToken(TRIPLE_PLUS_TOKEN, "+++", this->index - 3, this->row, 3);
+			return SyntaxToken(TRIPLE_PLUS_TOKEN, "+++", this->index - 3, 3);
 		}
 		if (PeekNext() == '+')
 		{
 			this->index += 2;
-			return SyntaxToken(PLUS_PLUS_TOKEN, "++", this->index - 2, this->row, 2);
+			return SyntaxToken(PLUS_PLUS_TOKEN, "++", this->index - 2, 2);
 		}
 		if (PeekNext() == '=')
 		{
 			this->index += 2;
-			return SyntaxToken(PLUS_EQUAL_TOKEN, "+=", this->index - 2, this->row, 2);
+			return SyntaxToken(PLUS_EQUAL_TOKEN, "+=", this->index - 2, 2);
 		}
-		return SyntaxToken(PLUS_TOKEN, "+", this->index++, this->row, 1);
+		return SyntaxToken(PLUS_TOKEN, "+", this->index++, 1);
 	case '-':
 		if (PeekNext() == '-')
 		{
 			this->index += 2;
-			return SyntaxToken(MINUS_MINUS_TOKEN, "--", this->index - 2, this->row, 2);
+			return SyntaxToken(MINUS_MINUS_TOKEN, "--", this->index - 2, 2);
 		}
 		if (PeekNext() == '=')
 		{
 			this->index += 2;
-			return SyntaxToken(MINUS_EQUAL_TOKEN, "-=", this->index - 2, this->row, 2);
+			return SyntaxToken(MINUS_EQUAL_TOKEN, "-=", this->index - 2, 2);
 		}
-		return SyntaxToken(MINUS_TOKEN, "-", this->index++, this->row, 1);
+		return SyntaxToken(MINUS_TOKEN, "-", this->index++, 1);
 	case '*':
 		if (PeekNext() == '=')
 		{
 			this->index += 2;
-			return SyntaxToken(STAR_EQUAL_TOKEN, "*=", this->index - 2, this->row, 2);
+			return SyntaxToken(STAR_EQUAL_TOKEN, "*=", this->index - 2, 2);
 		}
-		return SyntaxToken(STAR_TOKEN, "*", this->index++, this->row, 1);
+		return SyntaxToken(STAR_TOKEN, "*", this->index++, 1);
 	case '/':
 		if (PeekNext() == '=')
 		{
 			this->index += 2;
-			return SyntaxToken(SLASH_EQUAL_TOKEN, "/=", this->index - 2, this->row, 2);
-		}
-		if (PeekNext() == '*')
-		{
-			advance();
-			advance();
-
-			while (Current() != '*' || PeekNext() != '/')
-			{
-				advance();
-			}
-			advance();
-			advance();
-			return Lex();
+			return SyntaxToken(SLASH_EQUAL_TOKEN, "/=", this->index - 2, 2);
 		}
-		return SyntaxToken(SLASH_TOKEN, "/", this->index++, this->row, 1);
+		return SyntaxToken(SLASH_TOKEN, "/", this->index++, 1);
 
 	case ',':
-		return SyntaxToken(COMMA_TOKEN, ",", this->index++, this->row, 1);
+		return SyntaxToken(COMMA_TOKEN, ",", this->index++, 1);
 
 	case '(':
-		return SyntaxToken(OPEN_PAREN, "(", this->index++, this->row, 1);
+		return SyntaxToken(OPEN_PAREN, "(", this->index++, 1);
 	case ')':
-		return SyntaxToken(CLOSE_PAREN, ")", this->index++, this->row, 1);
+		return SyntaxToken(CLOSE_PAREN, ")", this->index++, 1);
 	case '{':
-		return SyntaxToken(OPEN_CURLY_BRACKET, "{", this->index++, this->row, 1);
+		return SyntaxToken(OPEN_CURLY_BRACKET, "{", this->index++, 1);
 	case '}':
-		return SyntaxToken(CLOSE_CURLY_BRACKET, "}", this->index++, this->row, 1);
+		return SyntaxToken(CLOSE_CURLY_BRACKET, "}", this->index++, 1);
 
 	case '=':
 		if (PeekNext() == '=')
 		{
 			this->index += 2;
-			return SyntaxToken(EQUAL_EQUAL_TOKEN, "==", this->index - 2, this->row, 2);
+			return SyntaxToken(EQUAL_EQUAL_TOKEN, "==", this->index - 2, 2);
 		}
-		return SyntaxToken(EQUAL_TOKEN, "=", this->index++, this->row, 1);
+		return SyntaxToken(EQUAL_TOKEN, "=", this->index++, 1);
 	case '!':
 		if (PeekNext() == '=')
 		{
 			this->index += 2;
-			return SyntaxToken(BANG_EQUAL_TOKEN, "!=", this->index - 2, this->row, 2);
+			return SyntaxToken(BANG_EQUAL_TOKEN, "!=", this->index - 2, 2);
 		}
-		return SyntaxToken(BANG_TOKEN, "!", this->index - 1, this->row, 1);
+		return SyntaxToken(BANG_TOKEN, "!", this->index++, 1);
 	case '&':
 		if (PeekNext() == '&')
 		{
 			this->index += 2;
-			return SyntaxToken(AMPERSAND_AMPERSAND_TOKEN, "&&", this->index - 2, this->row, 2);
+			return SyntaxToken(AMPERSAND_AMPERSAND_TOKEN, "&&", this->index - 2, 2);
 		}
 		break;
 	case '|':
 		if (PeekNext() == '|')
 		{
 			this->index += 2;
-			return SyntaxToken(PIPE_PIPE_TOKEN, "||", this->index - 2, this->row, 2);
+			return SyntaxToken(PIPE_PIPE_TOKEN, "||", this->index - 2, 2);
 		}
 		break;
 
 	case '"':
 	{
-		advance();
-		size_t start = this->index;
-		while (Current() != '"')
+		size_t start = this->index + 1;
+		size_t end = FindQuote(this->program, start);
+		if (end == std::string_view::npos)
 		{
-			advance();
+			Report("Unterminated string literal starting at " + LineTable(this->program).Describe(start - 1) + ".");
+			this->index = this->program.size();
+			return SyntaxToken(BAD_TOKEN, "", start - 1, 0);
 		}
-		size_t length = this->index - start;
-		std::string text = this->program.substr(start, length);
-		advance(); // deleting the last "
-		return SyntaxToken(STRING_LITERAL_TOKEN, text, start, this->row, length);
+		size_t length = end - start;
+		std::string_view text = this->program.substr(start, length);
+		this->index = end + 1; // past the closing "
+		return SyntaxToken(STRING_LITERAL_TOKEN, text, start, length);
 	}
-		break;
 	case ';':
-		return SyntaxToken(SEMICOLON_TOKEN, ";", this->index++, this->row, 1);
+		return SyntaxToken(SEMICOLON_TOKEN, ";", this->index++, 1);
 	default:
-		return SyntaxToken(BAD_TOKEN, "", this->index++, 0, this->row);
+		return SyntaxToken(BAD_TOKEN, "", this->index++, 0);
 	}
-	return SyntaxToken(BAD_TOKEN, "", this->index++, 0, this->row);
+	return SyntaxToken(BAD_TOKEN, "", this->index++, 0);
 }
\ No newline at end of file
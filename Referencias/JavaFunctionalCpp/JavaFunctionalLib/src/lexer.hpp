@@ -1,25 +1,38 @@
 #pragma once
 #include <iostream>
 #include <map>
+#include <string>
+#include <string_view>
 #include <vector>
 #include "syntaxtoken.hpp"
+#include "tokenbuffer.hpp"
 
 class LexerTest;
 
 class Lexer {
 public:
-	Lexer(std::string program);
-	std::vector<SyntaxToken> LexAll();
+	// Lexes 'program' from byte 'start'; identifiers are interned into 'symbols'.
+	Lexer(std::string_view program, size_t start = 0, SymbolTable& symbols = Symbols());
+	TokenBuffer LexAll();
+	TokenBuffer LexAllParallel(size_t threads = 0, size_t min_chunk = PARALLEL_MIN_CHUNK);
+	static constexpr size_t PARALLEL_MIN_CHUNK = 1 << 20;
 	SyntaxToken Lex();
+	const NumberLiteral& GetNumber(); // value of the last NUMBER_LITERAL_TOKEN
+	std::vector<std::string> GetErrorReports();
+	bool HasErrors() const { return not this->error_reports.empty(); }
 private:
 	char Current();
 	char PeekNext();
 	char LookAhead(int offset);
 	void advance();
-	int index = 0;
-	std::string program;
-
-	unsigned int row = 0;
+	bool SkipTrivia();
+	void Report(std::string error);
+	void LexInto(TokenBuffer& tokens);
+	std::vector<std::string> error_reports;
+	size_t index = 0;
+	NumberLiteral number;
+	std::string_view program; // owned by the caller, tokens point into it
+	SymbolTable* symbols;
 };
 
 
@@ -0,0 +1,6 @@
+#include "ast_node_headers.hpp"
+
+Value AstNode::Accept(Visitor& visitor)
+{
+	return Dispatch(visitor, *this);
+}
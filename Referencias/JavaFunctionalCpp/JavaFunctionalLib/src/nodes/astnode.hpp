@@ -1,9 +1,35 @@
 #pragma once
+#include <cstdint>
+
 #include "visitor.hpp"
 
+// The concrete class of an AstNode. Nodes carry no vtable: Accept and
+// Dispatch (ast_node_headers.hpp) switch on the kind instead.
+enum NodeKind : uint8_t
+{
+	NODE_EMPTY, // only in a FlatAst: a missing child
+	NODE_BINARY,
+	NODE_BOOL,
+	NODE_NUMBER,
+	NODE_STRING,
+	NODE_IDENTIFIER,
+	NODE_UNARY,
+	NODE_IF,
+	NODE_PRINT,
+	NODE_VAR_DECLARATION,
+	NODE_VAR_ASSIGNMENT,
+	NODE_FUNCTION_CALL,
+	NODE_BLOCK
+};
+
 class AstNode
 {
 public:
-	virtual	std::any Accept(Visitor& visitor) = 0;
+	AstNode(NodeKind kind) : kind(kind) {}
+
+	const NodeKind kind;
+	ValueType static_type = VAL_EMPTY; // set by the TypeChecker; VAL_EMPTY if only known at run time
+
+	Value Accept(Visitor& visitor);
 };
 
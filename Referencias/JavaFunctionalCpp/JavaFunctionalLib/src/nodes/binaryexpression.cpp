@@ -2,14 +2,29 @@
 #include "token.hpp"
 #include "binaryexpression.hpp"
 
-BinaryExpression::BinaryExpression(std::unique_ptr<AstNode> left, Token_t op, std::unique_ptr<AstNode> right)
+BinaryExpression::BinaryExpression(AstNode* left, Token_t op, AstNode* right)
+	: AstNode(NODE_BINARY)
 {
-	this->left = std::move(left);
+	this->left = left;
 	this->op = op;
-	this->right = std::move(right);
+	this->right = right;
+	if (left != nullptr && left->kind == NODE_BINARY)
+	{
+		this->chain = static_cast<BinaryExpression*>(left)->chain + 1;
+	}
 }
 
-std::any BinaryExpression::Accept(Visitor& visitor)
+// Appends the left-leaning chain 'a + b + c ...' rooted here, innermost
+// node first. Only the innermost node's left operand is outside the chain,
+// so a visitor can walk a generated expression of any length in a loop
+// instead of recursing once per operator.
+void BinaryExpression::Chain(std::vector<BinaryExpression*>& nodes)
 {
-	return visitor.VisitBinaryExpression(*this);
-}
\ No newline at end of file
+	size_t first = nodes.size();
+	nodes.resize(first + this->chain + 1);
+	BinaryExpression* node = this;
+	for (size_t i = nodes.size(); i-- > first; node = static_cast<BinaryExpression*>(node->left))
+	{
+		nodes[i] = node;
+	}
+}
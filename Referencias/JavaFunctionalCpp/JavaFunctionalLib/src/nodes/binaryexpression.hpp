@@ -1,18 +1,22 @@
 #pragma once
 
 #include <iostream>
+#include <vector>
 #include "lexer.hpp"
 #include "astnode.hpp"
+#include "quicken.hpp"
 
 class BinaryExpression : public AstNode
 {
 public:
-	std::unique_ptr<AstNode> left;
-	std::unique_ptr<AstNode> right;
+	uint8_t quick = QUICK_NONE; // executor the Interpreter specialized this node for; first, to fill AstNode's padding
+	AstNode* left;
+	AstNode* right;
 	Token_t op;
+	uint32_t chain = 0; // BinaryExpressions down the left operands: 2 for 'a + b + c + d'
 
-	BinaryExpression(std::unique_ptr<AstNode> left, Token_t op, std::unique_ptr<AstNode> right);
-	BinaryExpression(std::unique_ptr<AstNode> left);
+	BinaryExpression(AstNode* left, Token_t op, AstNode* right);
+	BinaryExpression(AstNode* left);
 
-	std::any Accept(Visitor& visitor);
+	void Chain(std::vector<BinaryExpression*>& nodes);
 };
@@ -1,10 +1,6 @@
 #include "blockstmtnode.hpp"
-BlockStmtNode::BlockStmtNode(std::vector<std::unique_ptr<AstNode>> stmts)
+BlockStmtNode::BlockStmtNode(std::span<AstNode*> stmts)
+	: AstNode(NODE_BLOCK)
 {
-	this->stmts = std::move(stmts);
-}
-
-std::any BlockStmtNode::Accept(Visitor& visitor)
-{
-	return visitor.VisitBlockStmtNode(*this);
+	this->stmts = stmts;
 }
\ No newline at end of file
@@ -1,5 +1,5 @@
 #pragma once
-#include <vector>
+#include <span>
 
 #include "astnode.hpp"
 #include "environment.hpp"
@@ -7,9 +7,8 @@
 class BlockStmtNode : public AstNode
 {
 public:
-	BlockStmtNode(std::vector<std::unique_ptr<AstNode>> stmts);
-	std::any Accept(Visitor& visitor);
+	BlockStmtNode(std::span<AstNode*> stmts);
 
-	std::vector<std::unique_ptr<AstNode>> stmts;
+	std::span<AstNode*> stmts;
 };
 
@@ -2,11 +2,7 @@
 #include "boolnode.hpp"
 
 BoolNode::BoolNode(bool value)
+	: AstNode(NODE_BOOL)
 {
 	this->value = value;
-}
-
-std::any BoolNode::Accept(Visitor& visitor)
-{
-	return visitor.VisitBoolNode(*this);
 }
\ No newline at end of file
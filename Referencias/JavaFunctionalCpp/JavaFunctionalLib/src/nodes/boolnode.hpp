@@ -4,6 +4,5 @@ class BoolNode : public AstNode {
 public:
 	bool value;
 	BoolNode(bool value);
-	std::any Accept(Visitor& visitor);
 };
 
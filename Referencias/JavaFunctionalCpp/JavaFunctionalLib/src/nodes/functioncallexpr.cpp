@@ -2,13 +2,9 @@
 
 #include "functioncallexpr.hpp"
 
-FunctionCallExpr::FunctionCallExpr(std::string identifier, std::vector<std::unique_ptr<AstNode>> arguments)
+FunctionCallExpr::FunctionCallExpr(Symbol identifier, std::span<AstNode*> arguments)
+    : AstNode(NODE_FUNCTION_CALL)
 {
-    this->arguments = std::move(arguments);
+    this->arguments = arguments;
     this->identifier = identifier;
 }
-
-std::any FunctionCallExpr::Accept(Visitor& visitor)
-{
-    return visitor.VisitFunctionCallNode(*this);
-}
@@ -1,14 +1,16 @@
 #pragma once
-#include <vector>
+#include "symboltable.hpp"
+#include <span>
 
 #include "astnode.hpp"
+#include "functionmemory.hpp"
 class FunctionCallExpr : public AstNode
 {
 public:
-	std::string identifier;
-	std::vector<std::unique_ptr<AstNode>> arguments;
+	Symbol identifier;
+	FunctionHandle handle = NO_FUNCTION; // cached by the Interpreter on the first call
+	std::span<AstNode*> arguments;
 
-	FunctionCallExpr(std::string identifier, std::vector<std::unique_ptr<AstNode>> arguments);
+	FunctionCallExpr(Symbol identifier, std::span<AstNode*> arguments);
 
-	std::any Accept(Visitor& visitor);
 };
\ No newline at end of file
@@ -2,12 +2,8 @@
 
 #include "identifiernode.hpp"
 
-IdentifierNode::IdentifierNode(std::string identifier)
+IdentifierNode::IdentifierNode(Symbol identifier)
+	: AstNode(NODE_IDENTIFIER)
 {
 	this->identifier = identifier;
 }
-
-std::any IdentifierNode::Accept(Visitor& visitor)
-{
-	return visitor.VisitIdentifierNode(*this);
-}
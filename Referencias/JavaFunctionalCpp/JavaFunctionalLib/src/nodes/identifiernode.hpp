@@ -1,10 +1,12 @@
 #pragma once
+#include "symboltable.hpp"
 #include "astnode.hpp"
 
 class IdentifierNode : public AstNode
 {
 public:
-	std::string identifier;
-	IdentifierNode(std::string identifier);
-	std::any Accept(Visitor& visitor);
+	Symbol identifier;
+	int depth = -1; // frame hops, filled in by the Resolver
+	int slot = -1;
+	IdentifierNode(Symbol identifier);
 };
\ No newline at end of file
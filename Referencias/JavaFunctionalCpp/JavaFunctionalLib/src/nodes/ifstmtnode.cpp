@@ -2,14 +2,9 @@
 
 #include "ifstmtnode.hpp"
 
-IfStmtNode::IfStmtNode(std::unique_ptr<AstNode> expression, std::unique_ptr<AstNode> blockStmt)
+IfStmtNode::IfStmtNode(AstNode* expression, AstNode* blockStmt)
+	: AstNode(NODE_IF)
 {
-	this->expression = std::move(expression);
-	this->blockStmt = std::move(blockStmt);
+	this->expression = expression;
+	this->blockStmt = blockStmt;
 }
-
-std::any IfStmtNode::Accept(Visitor& visitor)
-{
-	return visitor.VisitIfStmtNode(*this);
-}
-
@@ -4,9 +4,8 @@
 class IfStmtNode : public AstNode
 {
 public:
-	std::unique_ptr<AstNode> expression;
-	std::unique_ptr<AstNode> blockStmt;
+	AstNode* expression;
+	AstNode* blockStmt;
 
-	IfStmtNode(std::unique_ptr<AstNode> expression, std::unique_ptr<AstNode> blockStmt);
-	std::any Accept(Visitor& visitor);
+	IfStmtNode(AstNode* expression, AstNode* blockStmt);
 };
\ No newline at end of file
@@ -5,12 +5,8 @@
 #include "numbernode.hpp"
 
 
-NumberNode::NumberNode(NUMBER_DT number)
+NumberNode::NumberNode(Value number)
+	: AstNode(NODE_NUMBER)
 {
 	this->number = number;
 }
-
-std::any NumberNode::Accept(Visitor& visitor)
-{
-	return visitor.VisitNumberNode(*this);
-}
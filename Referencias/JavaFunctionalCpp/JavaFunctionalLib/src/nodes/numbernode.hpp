@@ -1,16 +1,10 @@
 #pragma once
-#ifndef NUMBER_DT
-#define NUMBER_DT std::variant<short, int, long, float, double>
-#endif // !NUMBER_DT
-
 #include "astnode.hpp"
-#include <variant>
 
 class NumberNode : public AstNode
 {
 public:
-	NUMBER_DT number;
-	NumberNode(NUMBER_DT number);
+	Value number;
+	NumberNode(Value number);
 
-	std::any Accept(Visitor& visitor);
 };
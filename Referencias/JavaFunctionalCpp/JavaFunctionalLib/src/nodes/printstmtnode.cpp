@@ -1,11 +1,7 @@
 #include "printstmtnode.hpp"
 
-PrintStmtNode::PrintStmtNode(std::unique_ptr<AstNode> expression)
+PrintStmtNode::PrintStmtNode(AstNode* expression)
+	: AstNode(NODE_PRINT)
 {
-	this->expression = std::move(expression);
-}
-
-std::any PrintStmtNode::Accept(Visitor& visitor)
-{
-	return visitor.VisitPrintStmt(*this);
+	this->expression = expression;
 }
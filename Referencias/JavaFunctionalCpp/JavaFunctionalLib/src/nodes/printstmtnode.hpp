@@ -4,10 +4,9 @@
 class PrintStmtNode : public AstNode
 {
 public:
-	std::unique_ptr<AstNode> expression;
+	AstNode* expression;
 
-	PrintStmtNode(std::unique_ptr<AstNode> expression);
-	std::any Accept(Visitor& visitor);
+	PrintStmtNode(AstNode* expression);
 };
 
 
@@ -1,12 +1,7 @@
 #include "stringnode.hpp"
 
-StringNode::StringNode(std::string value)
+StringNode::StringNode(std::string_view value)
+	: AstNode(NODE_STRING)
 {
 	this->value = value;
 }
-
-
-std::any StringNode::Accept(Visitor& visitor)
-{
-	return visitor.VisitStringNode(*this);
-}
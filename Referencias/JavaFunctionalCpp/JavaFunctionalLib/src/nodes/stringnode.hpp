@@ -1,13 +1,13 @@
 #pragma once
+#include <string_view>
 #include <iostream>
 #include "astnode.hpp"
 
 class StringNode : public AstNode
 {
 public:
-	std::string value;
+	std::string_view value;
 
-	StringNode(std::string value);
-	std::any Accept(Visitor& visitor);
+	StringNode(std::string_view value);
 };
 
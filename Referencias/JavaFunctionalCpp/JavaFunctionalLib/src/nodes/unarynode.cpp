@@ -1,12 +1,8 @@
 #include "unarynode.hpp"
 
-UnaryNode::UnaryNode(Token_t token, std::unique_ptr<AstNode> left)
+UnaryNode::UnaryNode(Token_t token, AstNode* left)
+	: AstNode(NODE_UNARY)
 {
 	this->token = token;
-	this->left = std::move(left);
-}
-
-std::any UnaryNode::Accept(Visitor& visitor)
-{
-	return visitor.VisitUnaryNode(*this);
+	this->left = left;
 }
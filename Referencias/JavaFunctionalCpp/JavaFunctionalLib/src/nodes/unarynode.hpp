@@ -2,15 +2,16 @@
 #include <iostream>
 
 #include "astnode.hpp"
+#include "quicken.hpp"
 #include "token.hpp"
 
 class UnaryNode : public AstNode {
 public:
-	UnaryNode(Token_t token, std::unique_ptr<AstNode> left);
+	UnaryNode(Token_t token, AstNode* left);
 
-	std::any Accept(Visitor& visitor);
 
-	std::unique_ptr<AstNode> left;
+	uint8_t quick = QUICK_NONE; // executor the Interpreter specialized this node for; first, to fill AstNode's padding
+	AstNode* left;
 	Token_t token;
 
 };
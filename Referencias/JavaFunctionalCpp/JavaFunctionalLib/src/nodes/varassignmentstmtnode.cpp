@@ -1,12 +1,8 @@
 #include "varassignmentstmtnode.hpp"
 
-VarAssignmentStmtNode::VarAssignmentStmtNode(std::string identifier, std::unique_ptr<AstNode> expression)
+VarAssignmentStmtNode::VarAssignmentStmtNode(Symbol identifier, AstNode* expression)
+	: AstNode(NODE_VAR_ASSIGNMENT)
 {
 	this->identifier = identifier;
-	this->expression = std::move(expression);
-}
-
-std::any VarAssignmentStmtNode::Accept(Visitor& visitor)
-{
-	return visitor.VisitVarAssignmentStmt(*this);
+	this->expression = expression;
 }
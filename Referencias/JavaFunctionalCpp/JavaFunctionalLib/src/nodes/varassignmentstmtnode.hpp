@@ -1,12 +1,14 @@
 #pragma once
+#include "symboltable.hpp"
 #include "astnode.hpp"
 
 class VarAssignmentStmtNode : public AstNode
 {
 public:
-	std::string identifier;
-	std::unique_ptr<AstNode> expression;
+	Symbol identifier;
+	AstNode* expression;
+	int depth = -1; // frame hops, filled in by the Resolver
+	int slot = -1;
 	
-	VarAssignmentStmtNode(std::string identifier, std::unique_ptr<AstNode> expression);
-	std::any Accept(Visitor& visitor);
+	VarAssignmentStmtNode(Symbol identifier, AstNode* expression);
 };
\ No newline at end of file
@@ -1,14 +1,9 @@
 #include "vardeclarationnode.hpp"
 
-VarDeclarationNode::VarDeclarationNode(Token_t variableType, std::string identifier, std::unique_ptr<AstNode> expression)
+VarDeclarationNode::VarDeclarationNode(Token_t variableType, Symbol identifier, AstNode* expression)
+	: AstNode(NODE_VAR_DECLARATION)
 {
 	this->variableType = variableType;
 	this->identifier = identifier;
-	this->expression = std::move(expression);
+	this->expression = expression;
 }
-
-std::any VarDeclarationNode::Accept(Visitor& visitor)
-{
-	return visitor.VisitVarDeclarationStmt(*this);
-}
-
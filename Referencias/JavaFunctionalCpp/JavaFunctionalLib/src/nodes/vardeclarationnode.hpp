@@ -1,4 +1,5 @@
 #pragma once
+#include "symboltable.hpp"
 #include "astnode.hpp"
 #include "token.hpp"
 #include "variable.hpp"
@@ -6,11 +7,12 @@
 class VarDeclarationNode : public AstNode {
 public:
 	Token_t variableType;
-	std::string identifier;
-	std::unique_ptr<AstNode> expression;
-	VarDeclarationNode(Token_t variableType, std::string identifier, std::unique_ptr<AstNode> expression);
+	Symbol identifier;
+	AstNode* expression;
+	int depth = -1; // frame hops, filled in by the Resolver
+	int slot = -1;
+	VarDeclarationNode(Token_t variableType, Symbol identifier, AstNode* expression);
 
-	std::any Accept(Visitor& visitor);
 
 };
 
@@ -0,0 +1,322 @@
+#include "optimizer.hpp"
+#include "ast_node_headers.hpp"
+
+// The value of a literal, empty for anything else (strings included: no
+// operation accepts them).
+static Value Constant(AstNode* node)
+{
+	if (node == nullptr)
+	{
+		return Value();
+	}
+	switch (node->kind)
+	{
+		case NODE_NUMBER:
+			return static_cast<NumberNode*>(node)->number;
+		case NODE_BOOL:
+			return static_cast<BoolNode*>(node)->value;
+		default:
+			return Value();
+	}
+}
+
+// 'left op right' if both are constant and the operation does not throw.
+static Value FoldBinary(Token_t op, Value left, Value right)
+{
+	if (left.IsEmpty() || right.IsEmpty())
+	{
+		return Value();
+	}
+	try
+	{
+		return BinaryOperation(op, left, right);
+	}
+	catch (std::invalid_argument&)
+	{
+		return Value();
+	}
+}
+
+Optimizer::Optimizer(Arena& arena, FunctionMemory& function_memory, int global_slot_count)
+	: arena(arena), function_memory(function_memory), globals(global_slot_count)
+{
+}
+
+void Optimizer::Optimize(std::vector<AstNode*>& statements)
+{
+	// a body parsed later may assign any global
+	for (Symbol identifier : this->function_memory.GetIdentifiers())
+	{
+		this->lazy = this->lazy || this->function_memory.GetRef(identifier).block_stmt == nullptr;
+	}
+
+	bool first = true;
+	do
+	{
+		this->changed = false;
+		this->nodes = 0;
+		OptimizeProgram(statements);
+		if (first)
+		{
+			this->stats.nodes_before = this->nodes;
+			first = false;
+		}
+		EndRound(this->globals);
+		for (auto& [identifier, slots] : this->frames)
+		{
+			EndRound(slots);
+		}
+	} while (this->changed);
+	this->stats.nodes_after = this->nodes;
+	this->chain.clear();
+}
+
+OptimizerStats Optimizer::GetStats()
+{
+	return this->stats;
+}
+
+void Optimizer::OptimizeProgram(std::vector<AstNode*>& statements)
+{
+	this->frame = &this->globals;
+	statements.resize(FoldStatements(statements));
+	for (Symbol identifier : this->function_memory.GetIdentifiers())
+	{
+		FuncVariable& func_var = this->function_memory.GetRef(identifier);
+		if (func_var.block_stmt == nullptr)
+		{
+			continue;
+		}
+		this->frame = &Frame(func_var);
+		// every call stores its arguments
+		for (size_t i = 0; i < func_var.parameters.size(); i++)
+		{
+			Store(0, (int)i, Value());
+		}
+		Fold(func_var.block_stmt);
+	}
+	this->frame = &this->globals;
+}
+
+// What this round stored becomes what the next round may read. A slot
+// found constant (or no longer) takes another round to propagate.
+void Optimizer::EndRound(std::vector<SlotStore>& slots)
+{
+	for (SlotStore& slot : slots)
+	{
+		Value constant = slot.stores == 1 ? slot.value : Value();
+		this->changed = this->changed || constant.IsEmpty() != slot.constant.IsEmpty();
+		slot.constant = constant;
+		slot.stores = 0;
+		slot.value = Value();
+	}
+}
+
+// Optimizes the subtree at 'node' and replaces it with a literal if it is
+// constant. Returns the constant, or an empty Value.
+Value Optimizer::Fold(AstNode*& node)
+{
+	if (node == nullptr)
+	{
+		return Value();
+	}
+	this->nodes++;
+	Value value = Dispatch(*this, *node);
+	if (value.IsEmpty() || node->kind == NODE_NUMBER || node->kind == NODE_BOOL)
+	{
+		return value;
+	}
+	if (node->kind == NODE_IDENTIFIER)
+	{
+		this->stats.propagated++;
+	}
+	else
+	{
+		this->stats.folded++;
+	}
+	node = Literal(value);
+	this->changed = true;
+	return value;
+}
+
+// Folds a statement list in place, dropping the ifs that never run and
+// putting the block of those that always run in their place. Returns the
+// new length.
+size_t Optimizer::FoldStatements(std::span<AstNode*> stmts)
+{
+	size_t kept = 0;
+	for (AstNode* stmt : stmts)
+	{
+		Fold(stmt);
+		if (stmt != nullptr && stmt->kind == NODE_IF)
+		{
+			IfStmtNode* if_stmt = static_cast<IfStmtNode*>(stmt);
+			Value condition = Constant(if_stmt->expression);
+			try
+			{
+				if (not condition.IsEmpty())
+				{
+					bool taken = IfCondition(condition);
+					this->stats.pruned++;
+					this->changed = true;
+					if (not taken)
+					{
+						continue;
+					}
+					stmt = if_stmt->blockStmt;
+				}
+			}
+			catch (std::invalid_argument&)
+			{
+				// not a condition: left to fail at run time
+			}
+		}
+		stmts[kept++] = stmt;
+	}
+	return kept;
+}
+
+AstNode* Optimizer::Literal(Value value)
+{
+	if (value.IsBool())
+	{
+		return this->arena.New<BoolNode>(value.AsBool());
+	}
+	return this->arena.New<NumberNode>(value);
+}
+
+// Same addressing as FrameStack::At: depth 0 is the current frame, any
+// other depth the global one.
+void Optimizer::Store(int depth, int slot, Value value)
+{
+	std::vector<SlotStore>& slots = depth == 0 ? *this->frame : this->globals;
+	if (slot < 0 || (size_t)slot >= slots.size())
+	{
+		return;
+	}
+	slots[slot].stores++;
+	slots[slot].value = value;
+}
+
+std::vector<Optimizer::SlotStore>& Optimizer::Frame(FuncVariable& func_var)
+{
+	std::vector<SlotStore>& slots = this->frames[func_var.identifier];
+	if (slots.size() < (size_t)func_var.slot_count)
+	{
+		slots.resize(func_var.slot_count);
+	}
+	return slots;
+}
+
+Value Optimizer::VisitBinaryExpression(BinaryExpression& binaryExpression)
+{
+	size_t first = this->chain.size();
+	binaryExpression.Chain(this->chain);
+	this->nodes += this->chain.size() - first - 1;
+	Value value = Fold(this->chain[first]->left);
+	for (size_t i = first; i < this->chain.size(); i++)
+	{
+		BinaryExpression* node = this->chain[i];
+		if (i > first && not value.IsEmpty())
+		{
+			// the operation below folded: the chain now starts here
+			node->left = Literal(value);
+			this->stats.folded++;
+			this->changed = true;
+		}
+		value = FoldBinary(node->op, value, Fold(node->right));
+		node->chain = node->left->kind == NODE_BINARY ? static_cast<BinaryExpression*>(node->left)->chain + 1 : 0;
+	}
+	this->chain.resize(first);
+	return value;
+}
+
+Value Optimizer::VisitBoolNode(BoolNode& boolNode)
+{
+	return boolNode.value;
+}
+
+Value Optimizer::VisitNumberNode(NumberNode& numberNode)
+{
+	return numberNode.number;
+}
+
+Value Optimizer::VisitStringNode(StringNode&)
+{
+	return Value();
+}
+
+// Only reads in the declaring frame: a function reading a global may be
+// called before the global is declared.
+Value Optimizer::VisitIdentifierNode(IdentifierNode& identifierNode)
+{
+	std::vector<SlotStore>& slots = *this->frame;
+	int slot = identifierNode.slot;
+	if (identifierNode.depth != 0 || slot < 0 || (size_t)slot >= slots.size())
+	{
+		return Value();
+	}
+	if (this->lazy && &slots == &this->globals)
+	{
+		return Value();
+	}
+	return slots[slot].constant;
+}
+
+Value Optimizer::VisitUnaryNode(UnaryNode& unaryNode)
+{
+	Value operand = Fold(unaryNode.left);
+	if (operand.IsEmpty())
+	{
+		return Value();
+	}
+	try
+	{
+		return UnaryOperation(unaryNode.token, operand);
+	}
+	catch (std::invalid_argument&)
+	{
+		return Value();
+	}
+}
+
+Value Optimizer::VisitIfStmtNode(IfStmtNode& ifStmtNode)
+{
+	Fold(ifStmtNode.expression);
+	Fold(ifStmtNode.blockStmt);
+	return Value();
+}
+
+Value Optimizer::VisitPrintStmt(PrintStmtNode& printStmtNode)
+{
+	Fold(printStmtNode.expression);
+	return Value();
+}
+
+Value Optimizer::VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode)
+{
+	Store(varDeclarationNode.depth, varDeclarationNode.slot, Fold(varDeclarationNode.expression));
+	return Value();
+}
+
+Value Optimizer::VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode)
+{
+	Fold(varAssignmentNode.expression);
+	Store(varAssignmentNode.depth, varAssignmentNode.slot, Value());
+	return Value();
+}
+
+Value Optimizer::VisitFunctionCallNode(FunctionCallExpr& functionCallExpr)
+{
+	for (AstNode*& argument : functionCallExpr.arguments)
+	{
+		Fold(argument);
+	}
+	return Value();
+}
+
+Value Optimizer::VisitBlockStmtNode(BlockStmtNode& blockStmtNode)
+{
+	blockStmtNode.stmts = blockStmtNode.stmts.first(FoldStatements(blockStmtNode.stmts));
+	return Value();
+}
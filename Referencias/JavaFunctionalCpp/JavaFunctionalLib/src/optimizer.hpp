@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "arena.hpp"
+#include "visitor.hpp"
+#include "nodes/astnode.hpp"
+#include "variable.hpp"
+#include "functionmemory.hpp"
+
+struct OptimizerStats
+{
+	size_t nodes_before = 0;
+	size_t nodes_after = 0;
+	size_t folded = 0;     // operations replaced by their constant result
+	size_t propagated = 0; // variable reads replaced by the variable's constant value
+	size_t pruned = 0;     // ifs dropped or replaced by their block
+};
+
+// Static pass (-O1) run after the Resolver, rewriting the tree in place:
+//  - a binary or unary operation on constants becomes a NumberNode or
+//    BoolNode holding what BinaryOperation/UnaryOperation gives for them;
+//    one that would throw (integer division by zero) is left to fail at run
+//    time;
+//  - a variable stored exactly once in the program, by a declaration whose
+//    initializer is constant, is read as that constant in its own frame.
+//    Globals only qualify when no PARSE_LAZY body is left unparsed;
+//  - an if whose condition is constant is dropped, or replaced by its block.
+// Each rewrite may expose another, so the program is optimized again until
+// nothing changes. New nodes go into the Program's arena; bodies built later
+// by Resolver::Materialize are not optimized.
+class Optimizer final : public Visitor
+{
+public:
+	Optimizer(Arena& arena, FunctionMemory& function_memory, int global_slot_count);
+
+	void Optimize(std::vector<AstNode*>& statements);
+	OptimizerStats GetStats();
+
+private:
+	template <class V>
+	friend Value Dispatch(V& visitor, AstNode& node);
+
+	struct SlotStore
+	{
+		int stores = 0;
+		Value value;    // stored by the last store this round, empty if not constant
+		Value constant; // what every read sees, as found by the previous round; empty if not constant
+	};
+
+	Arena& arena;
+	FunctionMemory& function_memory;
+	std::vector<SlotStore> globals;
+	std::unordered_map<Symbol, std::vector<SlotStore>> frames; // per function
+	std::vector<SlotStore>* frame = nullptr; // of the code being optimized
+	bool lazy = false;
+	bool changed = false;
+	size_t nodes = 0; // visited this round
+	OptimizerStats stats;
+	std::vector<BinaryExpression*> chain; // BinaryExpression::Chain of the expressions being optimized
+
+	void OptimizeProgram(std::vector<AstNode*>& statements);
+	void EndRound(std::vector<SlotStore>& slots);
+	Value Fold(AstNode*& node);
+	size_t FoldStatements(std::span<AstNode*> stmts);
+	AstNode* Literal(Value value);
+	void Store(int depth, int slot, Value value);
+	std::vector<SlotStore>& Frame(FuncVariable& func_var);
+
+	Value VisitBinaryExpression(BinaryExpression& binaryExpression);
+	Value VisitBoolNode(BoolNode& boolNode);
+	Value VisitNumberNode(NumberNode& numberNode);
+	Value VisitStringNode(StringNode& stringNode);
+	Value VisitIdentifierNode(IdentifierNode& identifierNode);
+	Value VisitUnaryNode(UnaryNode& unaryNode);
+
+	Value VisitIfStmtNode(IfStmtNode& ifStmtNode);
+	Value VisitPrintStmt(PrintStmtNode& printStmtNode);
+	Value VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode);
+	Value VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode);
+
+	Value VisitFunctionCallNode(FunctionCallExpr& functionCallExpr);
+	Value VisitBlockStmtNode(BlockStmtNode& blockStmtNode);
+};
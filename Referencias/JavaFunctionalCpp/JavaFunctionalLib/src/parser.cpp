@@ -1,7 +1,12 @@
 
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <climits>
 #include <iostream>
 #include <optional>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "syntaxtoken.hpp"
@@ -10,33 +15,63 @@
 #include "ast_node_headers.hpp"
 
 #include "parser.hpp"
+#include "workers.hpp"
 
-Parser::Parser(std::string program, EnvStack env_stack, FunctionMemory& function_memory)
-	: function_memory(function_memory)
+static constexpr TokenSet TERM_OPERATORS = { PLUS_TOKEN, MINUS_TOKEN, EQUAL_EQUAL_TOKEN, AMPERSAND_AMPERSAND_TOKEN, BANG_EQUAL_TOKEN, PIPE_PIPE_TOKEN };
+static constexpr TokenSet FACTOR_OPERATORS = { STAR_TOKEN, SLASH_TOKEN };
+static constexpr TokenSet UNARY_OPERATORS = { MINUS_TOKEN, BANG_TOKEN };
+
+Parser::Parser(std::string program, EnvStack env_stack, FunctionMemory& function_memory, ParseMode mode)
+	: Parser(SourceBuffer(std::move(program)), std::move(env_stack), function_memory, mode)
 {
-	this->env_stack = std::move(env_stack);
+}
 
-	Lexer lexer(program);
+Parser::Parser(SourceBuffer source, EnvStack env_stack, FunctionMemory& function_memory, ParseMode mode)
+	: mode(mode), function_memory(function_memory), source(std::make_shared<const SourceBuffer>(std::move(source))), tokens(this->source->Text(), mode == PARSE_PIPELINED)
+{
+	this->scopes = ScopeTable(env_stack);
+	if (this->scopes.Empty())
+	{
+		this->scopes.Push(); // global scope
+	}
 
-	this->tokens = lexer.LexAll();
 	this->index = 0;
 }
 
-SyntaxToken Parser::NextToken()
+Parser::Parser(const TokenBuffer& buffer, FunctionMemory& function_memory)
+	: mode(PARSE_STREAMING), function_memory(function_memory), tokens("")
 {
-	size_t size = this->tokens.size();
-	if (this->index < size)
+	this->tokens.UseBuffer(buffer);
+	this->index = 0;
+}
+
+Token_t Parser::PeekKind(int offset)
+{
+	int index = offset + this->index;
+	if (index < 0)
 	{
-		return this->tokens[this->index++];
+		return BAD_TOKEN; // before the first token
 	}
-	return SyntaxToken::SyntaxToken(END_OF_FILE_TOKEN, "", this->index - 1, 0, -1);
+	return this->tokens.Kind(index); // past the end: the final token
+}
+
+// Symbol and text of the token at 'index'; -1, from a failed Expect, reads
+// as an empty name.
+Symbol Parser::SymbolAt(int index)
+{
+	return index < 0 ? NO_SYMBOL : this->tokens.Identifier(index);
+}
+
+std::string_view Parser::TextAt(int index)
+{
+	return index < 0 ? std::string_view() : this->tokens.Text(index);
 }
 
 bool Parser::IsAtEnd()
 {
-	if (this->index >= this->tokens.size() ||
-		this->tokens[this->index].GetToken_t() == BAD_TOKEN ||
-		this->tokens[this->index].GetToken_t() == END_OF_FILE_TOKEN)
+	if (not this->tokens.Has(this->index) ||
+		this->tokens.Kind(this->index) == BAD_TOKEN ||
+		this->tokens.Kind(this->index) == END_OF_FILE_TOKEN)
 	{
 		return true;
 	}
@@ -45,148 +80,357 @@ bool Parser::IsAtEnd()
 
 void Parser::Advance()
 {
-	size_t size = this->tokens.size();
-	if (this->index < size)
+	if (this->tokens.Has(this->index))
 	{
 		this->index++;
 	}
 }
 
-SyntaxToken Parser::PeekNextNext()
+void Parser::Back()
+{
+	if (this->index - 1 >= 0)
+	{
+		--this->index;
+	}
+}
+
+// Index of the matched token, or -1 once the mismatch is reported.
+int Parser::Expect(Token_t expect)
 {
-	return LookAhead(2);
+	if (PeekKind() == expect)
+	{
+		int matched = this->index;
+		Advance();
+		return matched;
+	}
+	Report("Expected " + TokenName(expect) + " at " + this->tokens.Describe(this->index));
+	return -1;
 }
 
-SyntaxToken Parser::PeekNext()
+bool Parser::ExpectOptional(Token_t expect)
 {
-	return LookAhead(1);
+	if (PeekKind() == expect)
+	{
+		Advance();
+		return true;
+	}
+	return false;
 }
 
-SyntaxToken Parser::Peek()
+// Consumes the type keywords of a declaration and returns the type, or
+// BAD_TOKEN. A run in declaration order ('long double') names the last.
+Token_t Parser::FindVarType()
 {
-	return LookAhead(0);
+	Token_t type = BAD_TOKEN;
+	while (TYPE_TOKENS.Contains(PeekKind()) && (type == BAD_TOKEN || PeekKind() > type))
+	{
+		type = PeekKind();
+		Advance();
+	}
+	return type;
 }
 
-SyntaxToken Parser::Previous()
+bool Parser::Match(Token_t match)
 {
-	return LookAhead(-1);
+	return PeekKind() == match;
 }
 
-SyntaxToken Parser::PreviousPrevious()
+bool Parser::MatchAny(TokenSet tokens)
 {
-	return LookAhead(-2);
+	return tokens.Contains(PeekKind());
 }
 
-void Parser::Back()
+// Moves the nodes pushed on node_stack since 'first' into the arena.
+std::span<AstNode*> Parser::PopNodes(size_t first)
 {
-	if (this->index - 1 >= 0)
-	{
-		--this->index;
-	}
+	std::span<AstNode*> nodes = this->program.arena.CopyArray(std::span<AstNode* const>(this->node_stack).subspan(first));
+	this->node_stack.resize(first);
+	return nodes;
 }
 
-SyntaxToken Parser::LookAhead(int offset)
+Program Parser::Parse()
 {
-	int index = offset + this->index;
-	if (index < this->tokens.size())
+	if (this->mode == PARSE_LAZY)
+	{
+		ParseLazy();
+	}
+	else if (this->mode != PARSE_PARALLEL || not ParseParallel())
 	{
-		return this->tokens[index];
+		ParseStatements();
 	}
-	return this->tokens[this->tokens.size() - 1];
+	return std::move(this->program);
 }
 
-SyntaxToken Parser::Expect(Token_t expect)
+void Parser::ParseStatements()
 {
-	if (Peek().GetToken_t() == expect)
+	std::vector<AstNode*>& statements = this->program.statements;
+	while (!IsAtEnd() && not HasErrors())
 	{
-		return NextToken();
+		try
+		{
+			int start = this->index;
+			AstNode* statement = ParseStatement();
+			if (statement == nullptr)
+			{
+				// function declarations are registered, not returned
+				if (this->index == start)
+				{
+					break;
+				}
+				continue;
+			}
+			statements.push_back(statement);
+		}
+		catch (std::invalid_argument e)
+		{
+			Report(e.what());
+		}
 	}
-	SyntaxToken curr = Peek();
-	Report("Expected " + TokenName(expect));
-	return SyntaxToken::SyntaxToken(BAD_TOKEN, "", -1, 0, 0);
 }
 
-std::optional<SyntaxToken> Parser::ExpectOptional(Token_t expect)
-{
-	if (Peek().GetToken_t() == expect)
+// PARSE_PARALLEL. The whole source is lexed up front, in chunks on worker
+// threads (Lexer::LexAllParallel); the top level is parsed with each
+// top-level function body skipped by brace matching, then the bodies are
+// parsed on worker threads, each worker into its own arena, and the
+// functions are registered in the order the serial parser would register
+// them. Diagnostics are left to the serial parser: on any error the state
+// is reset and false returned, so error output is exactly the serial one.
+// Console messages are collected and printed once the parse has succeeded,
+// in source order.
+bool Parser::ParseParallel()
+{
+	Lexer lexer(this->source->Text());
+	TokenBuffer buffer = lexer.LexAllParallel();
+	if (not lexer.GetErrorReports().empty())
+	{
+		return false;
+	}
+
+	ScopeTable saved_scopes = this->scopes;
+	std::vector<FuncVariable> declared;
+	std::vector<DeferredBody> bodies;
+	std::vector<Notice> notices;
+	this->tokens.UseBuffer(buffer);
+	this->declared_functions = &declared;
+	this->deferred_bodies = &bodies;
+	this->notices = &notices;
+	ParseStatements();
+	this->declared_functions = nullptr;
+	this->deferred_bodies = nullptr;
+	this->notices = nullptr;
+
+	bool parsed = this->error_reports.empty();
+	if (parsed && not bodies.empty())
+	{
+		size_t threads = std::min(DefaultThreads(), bodies.size());
+		std::vector<Program> programs(threads);
+		std::atomic<size_t> next{ 0 };
+		RunWorkers(threads, [&](size_t worker)
+		{
+			FunctionMemory unused; // bodies record their functions instead
+			Parser parser(buffer, unused);
+			for (size_t i = next++; i < bodies.size(); i = next++)
+			{
+				parser.ParseDeferredBody(bodies[i]);
+			}
+			programs[worker] = std::move(parser.program);
+		});
+		for (Program& body_program : programs)
+		{
+			this->program.arena.Adopt(std::move(body_program.arena));
+		}
+		parsed = std::none_of(bodies.begin(), bodies.end(), [](const DeferredBody& body) { return body.failed; });
+	}
+	parsed = parsed && RegisterDeclared(declared, bodies);
+
+	this->tokens.Restart(); // 'buffer' is released here
+	if (not parsed)
 	{
-		return NextToken();
+		this->index = 0;
+		this->program = Program();
+		this->error_reports.clear();
+		this->scopes = std::move(saved_scopes);
+		return false;
 	}
-	return std::nullopt;
+
+	for (DeferredBody& body : bodies)
+	{
+		notices.insert(notices.end(), body.notices.begin(), body.notices.end());
+	}
+	std::stable_sort(notices.begin(), notices.end(), [](const Notice& a, const Notice& b) { return a.first < b.first; });
+	for (Notice& notice : notices)
+	{
+		std::cout << notice.second << std::endl;
+	}
+	return true;
 }
 
-std::optional<SyntaxToken> Parser::FindVarType()
+void Parser::ParseDeferredBody(DeferredBody& body)
 {
-	std::optional<SyntaxToken> dt_op = std::nullopt;
-	if (ExpectOptional(BOOL_TYPE))
+	this->scopes = std::move(body.scopes);
+	this->declared_functions = &body.functions;
+	this->notices = &body.notices;
+	this->index = (int)body.start;
+	this->error_reports.clear();
+	try
 	{
-		dt_op = Previous();
+		body.function.block_stmt = ParseBlockStatement(body.function.parameters);
+		body.functions.push_back(body.function);
 	}
-	if (ExpectOptional(SHORT_TYPE))
+	catch (std::invalid_argument)
 	{
-		dt_op = Previous();
+		body.failed = true;
 	}
-	if (ExpectOptional(INT_TYPE))
+	body.failed = body.failed || not this->error_reports.empty() || this->index != (int)body.end + 1;
+}
+
+// The serial parser registers a function once its body is parsed, so the
+// functions a body declares come before the function itself. Entries of
+// 'declared' without a block stand for the deferred bodies, in order.
+// Returns false where the serial parser would have reported a duplicate.
+bool Parser::RegisterDeclared(std::vector<FuncVariable>& declared, std::vector<DeferredBody>& bodies)
+{
+	std::vector<FuncVariable> ordered;
+	size_t next_body = 0;
+	for (FuncVariable& func_var : declared)
 	{
-		dt_op = Previous();
+		if (func_var.block_stmt != nullptr)
+		{
+			ordered.push_back(std::move(func_var));
+			continue;
+		}
+		for (FuncVariable& body_func_var : bodies[next_body++].functions)
+		{
+			ordered.push_back(std::move(body_func_var));
+		}
 	}
-	if (ExpectOptional(LONG_TYPE))
+
+	std::unordered_set<Symbol> seen;
+	for (FuncVariable& func_var : ordered)
 	{
-		dt_op = Previous();
+		if (this->function_memory.Exist(func_var.identifier) || not seen.insert(func_var.identifier).second)
+		{
+			return false;
+		}
+	}
+	for (FuncVariable& func_var : ordered)
+	{
+		this->function_memory.Add(std::move(func_var));
 	}
-	if (ExpectOptional(FLOAT_TYPE))
+	return true;
+}
+
+// PARSE_LAZY. The whole source is lexed up front so top-level function
+// bodies can be skipped by brace matching; each skipped body is recorded as
+// a LazyBody and only parsed when the function is first needed. Bodies are
+// parsed against the top-level scopes as they stand at the end of the
+// source. With lexer errors the source is parsed as usual, so the reports
+// are the streaming ones.
+void Parser::ParseLazy()
+{
+	Lexer lexer(this->source->Text());
+	TokenBuffer buffer = lexer.LexAll();
+	if (not lexer.GetErrorReports().empty())
 	{
-		dt_op = Previous();
+		ParseStatements();
+		return;
 	}
-	if (ExpectOptional(DOUBLE_TYPE))
+
+	std::vector<std::shared_ptr<LazyBody>> bodies;
+	this->tokens.UseBuffer(buffer);
+	this->lazy_bodies = &bodies;
+	ParseStatements();
+	this->lazy_bodies = nullptr;
+	this->tokens.Restart(); // 'buffer' is released here
+
+	std::shared_ptr<const ScopeTable> scopes = std::make_shared<const ScopeTable>(this->scopes);
+	for (std::shared_ptr<LazyBody>& body : bodies)
 	{
-		dt_op = Previous();
+		body->scopes = scopes;
 	}
-	return dt_op;
 }
 
-bool Parser::Match(Token_t match)
+// Whether the tokens in [start, end] declare a function. Such a body is
+// parsed right away, so its functions are registered when the serial
+// parser would register them.
+bool Parser::DeclaresFunction(size_t start, size_t end)
 {
-	if (Peek().GetToken_t() == match)
+	for (size_t i = start; i + 2 <= end; i++)
 	{
-		return true;
+		if (TYPE_TOKENS.Contains(this->tokens.Kind(i)) &&
+			this->tokens.Kind(i + 1) == IDENTIFIER_TOKEN &&
+			this->tokens.Kind(i + 2) == OPEN_PAREN)
+		{
+			return true;
+		}
 	}
 	return false;
 }
 
-bool Parser::MatchAny(std::vector<Token_t> tokens)
+// Builds a PARSE_LAZY body into its LazyBody and sets block_stmt. Returns
+// the lexer and parser reports; on any, block_stmt is left null.
+std::vector<std::string> Parser::ParseLazyBody(FuncVariable& func_var)
 {
-	for (Token_t token : tokens)
+	LazyBody& body = *func_var.lazy_body;
+	Lexer lexer(body.source->Text().substr(0, body.end), body.begin);
+	TokenBuffer buffer = lexer.LexAll();
+	std::vector<std::string> reports = lexer.GetErrorReports();
+	if (not reports.empty())
+	{
+		return reports;
+	}
+
+	FunctionMemory unused; // the body declares no functions (DeclaresFunction)
+	Parser parser(buffer, unused);
+	parser.scopes = *body.scopes;
+	try
 	{
-		if (Match(token))
+		AstNode* block_stmt = parser.ParseBlockStatement(func_var.parameters);
+		if (parser.error_reports.empty())
 		{
-			return true;
+			func_var.block_stmt = block_stmt;
 		}
 	}
-	return false;
+	catch (std::invalid_argument e)
+	{
+		parser.Report(e.what());
+	}
+	body.program = std::move(parser.program);
+	return parser.error_reports;
 }
 
-std::vector<std::unique_ptr<AstNode>> Parser::Parse()
+void Parser::Declare(FuncVariable func_var)
 {
-	std::vector<std::unique_ptr<AstNode>> statements;
-	while (!IsAtEnd() && this->GetErrorReports().empty())
+	if (this->declared_functions != nullptr)
 	{
-		try
+		this->declared_functions->push_back(std::move(func_var));
+		return;
+	}
+	this->function_memory.Add(std::move(func_var));
+}
+
+// Index of the '}' closing the '{' at 'open', or SIZE_MAX. Needs every
+// token, so only for a buffered stream.
+size_t Parser::MatchingBrace(size_t open)
+{
+	size_t depth = 0;
+	for (size_t i = open; this->tokens.Has(i); i++)
+	{
+		Token_t kind = this->tokens.Kind(i);
+		if (kind == OPEN_CURLY_BRACKET)
 		{
-			std::unique_ptr<AstNode> statement = ParseStatement();
-			if (statement == nullptr)
-			{
-				break;
-			}
-			statements.push_back(std::move(statement));
+			depth++;
 		}
-		catch (std::invalid_argument e)
+		else if (kind == CLOSE_CURLY_BRACKET && --depth == 0)
 		{
-			Report(e.what());
+			return i;
+		}
+		else if (depth == 0)
+		{
+			break;
 		}
 	}
-
-	return statements;
+	return SIZE_MAX;
 }
 
 void Parser::Report(std::string error)
@@ -194,18 +438,43 @@ void Parser::Report(std::string error)
 	this->error_reports.push_back(error);
 }
 
+// Not an error: printed, or collected while PARSE_PARALLEL parses out of
+// source order.
+void Parser::Notify(std::string message)
+{
+	if (this->notices != nullptr)
+	{
+		this->notices->emplace_back(this->index, std::move(message));
+		return;
+	}
+	std::cout << message << std::endl;
+}
+
+std::string_view Parser::CopyText(std::string_view text)
+{
+	return this->program.arena.CopyString(text);
+}
+
+// Lexer errors surface as the parser pulls tokens, and come first.
 std::vector<std::string> Parser::GetErrorReports()
 {
-	return this->error_reports;
+	std::vector<std::string> reports = this->tokens.GetErrorReports();
+	reports.insert(reports.end(), this->error_reports.begin(), this->error_reports.end());
+	return reports;
+}
+
+PipelineStats Parser::GetPipelineStats()
+{
+	return this->tokens.GetPipelineStats();
 }
 
-std::unique_ptr<AstNode> Parser::ParseStatement()
+AstNode* Parser::ParseStatement()
 {
 	if (Match(PRINT_KW))
 	{
 		return ParsePrintStatement();
 	}
-	if (MatchAny({ BOOL_TYPE, SHORT_TYPE, INT_TYPE, LONG_TYPE, FLOAT_TYPE, DOUBLE_TYPE }))
+	if (MatchAny(TYPE_TOKENS))
 	{
 		return DeclarationStatement();
 	}
@@ -219,42 +488,38 @@ std::unique_ptr<AstNode> Parser::ParseStatement()
 	{
 		return ParseBlockStatement();
 	}
-	return ParseExpression();
+	AstNode* expression = ParseExpression();
+	ExpectOptional(SEMICOLON_TOKEN);
+	return expression;
 }
 
-std::unique_ptr<AstNode> Parser::ParseIfStatement()
+AstNode* Parser::ParseIfStatement()
 {
 	Expect(IF_KW);
 	Expect(OPEN_PAREN);
-	std::unique_ptr<AstNode> expression = ParseExpression();
+	AstNode* expression = ParseExpression();
 	Expect(CLOSE_PAREN);
 
-	std::unique_ptr<AstNode> blockstmt = ParseBlockStatement();
-	return std::make_unique<IfStmtNode>(std::move(expression), std::move(blockstmt));
+	AstNode* blockstmt = ParseBlockStatement();
+	return New<IfStmtNode>(expression, blockstmt);
 }
 
-std::unique_ptr<AstNode> Parser::ParsePrintStatement()
+AstNode* Parser::ParsePrintStatement()
 {
 	Advance();
-	std::unique_ptr<AstNode> expression = ParseExpression();
+	AstNode* expression = ParseExpression();
 	if (expression != nullptr)
 	{
 		Expect(SEMICOLON_TOKEN);
 	}
-	return std::make_unique<PrintStmtNode>(std::move(expression));
+	return New<PrintStmtNode>(expression);
 }
 
-std::unique_ptr<AstNode> Parser::DeclarationStatement()
+AstNode* Parser::DeclarationStatement()
 {
-	if (MatchAny({
-		BOOL_TYPE,
-		SHORT_TYPE,
-		INT_TYPE,
-		LONG_TYPE,
-		FLOAT_TYPE,
-		DOUBLE_TYPE }) && PeekNext().GetToken_t() == IDENTIFIER_TOKEN)
+	if (MatchAny(TYPE_TOKENS) && PeekKind(1) == IDENTIFIER_TOKEN)
 	{
-		if (PeekNextNext().GetToken_t() == OPEN_PAREN)
+		if (PeekKind(2) == OPEN_PAREN)
 		{
 			return FunctionDeclarationStatement();
 		}
@@ -264,19 +529,18 @@ std::unique_ptr<AstNode> Parser::DeclarationStatement()
 	return nullptr;
 }
 
-std::unique_ptr<AstNode> Parser::FunctionDeclarationStatement()
+AstNode* Parser::FunctionDeclarationStatement()
 {
-	std::optional<SyntaxToken> dt_op = FindVarType();
+	Token_t dt = FindVarType();
 
-	SyntaxToken identifier = Expect(IDENTIFIER_TOKEN);
-	if (not dt_op.has_value())
+	int identifier = Expect(IDENTIFIER_TOKEN);
+	if (dt == BAD_TOKEN)
 	{
-		throw std::invalid_argument("Data type for identifier: " + identifier.GetValue() + " not found.");
+		throw std::invalid_argument("Data type for identifier: " + std::string(TextAt(identifier)) + " not found.");
 	}
-	SyntaxToken dt = dt_op.value();
 	FuncVariable func_var;
-	func_var.return_type = FromToken_tToDataType(dt.GetToken_t());
-	func_var.identifier = identifier.GetValue();
+	func_var.return_type = FromToken_tToDataType(dt);
+	func_var.identifier = SymbolAt(identifier);
 
 	Expect(OPEN_PAREN);
 	std::vector<Variable> formal_parameters;
@@ -286,61 +550,96 @@ std::unique_ptr<AstNode> Parser::FunctionDeclarationStatement()
 	}
 	Expect(CLOSE_PAREN);
 
-	std::unique_ptr<AstNode> blockstmt = ParseBlockStatement(formal_parameters, func_var.identifier);
-	func_var.block_stmt = std::move(blockstmt);
+	if (this->deferred_bodies != nullptr && this->block_depth == 0)
+	{
+		size_t end = MatchingBrace(this->index);
+		if (end != SIZE_MAX)
+		{
+			DeferredBody body;
+			body.start = this->index;
+			body.end = end;
+			body.scopes = this->scopes;
+			body.function = func_var;
+			body.function.parameters = std::move(formal_parameters);
+			this->deferred_bodies->push_back(std::move(body));
+			this->index = (int)end + 1;
+			Declare(std::move(func_var)); // no block: stands for the deferred body
+			return nullptr;
+		}
+	}
+	if (this->lazy_bodies != nullptr && this->block_depth == 0)
+	{
+		size_t end = MatchingBrace(this->index);
+		if (end != SIZE_MAX && not DeclaresFunction(this->index, end))
+		{
+			std::shared_ptr<LazyBody> body = std::make_shared<LazyBody>();
+			body->source = this->source;
+			body->begin = this->tokens.At(this->index).GetPos();
+			body->end = this->tokens.At(end).GetPos() + 1;
+			this->lazy_bodies->push_back(body);
+			this->index = (int)end + 1;
+			func_var.parameters = std::move(formal_parameters);
+			func_var.lazy_body = std::move(body);
+			Declare(std::move(func_var));
+			return nullptr;
+		}
+	}
+
+	AstNode* blockstmt = ParseBlockStatement(formal_parameters);
+	func_var.block_stmt = blockstmt;
 	func_var.parameters = std::move(formal_parameters);
-	this->function_memory.Add(std::move(func_var));
-	return {}; // nullptr for std::unique_ptr
+	Declare(std::move(func_var));
+	return nullptr;
 }
 
-std::unique_ptr<AstNode> Parser::FunctionCall()
+AstNode* Parser::FunctionCall()
 {
-	SyntaxToken identifier = Expect(IDENTIFIER_TOKEN);
-	std::vector<std::unique_ptr<AstNode>> args = Arguments();
-	Expect(CLOSE_PAREN);
-	return std::make_unique<FunctionCallExpr>(identifier.GetValue(), std::move(args));;
+	// read before the arguments move the window past the name
+	Symbol identifier = SymbolAt(Expect(IDENTIFIER_TOKEN));
+	std::span<AstNode*> args = Arguments();
+	return New<FunctionCallExpr>(identifier, args);
 }
 
 std::vector<Variable> Parser::Parameters()
 {
 	std::vector<Variable> formal_parameters;
 
-	std::optional<SyntaxToken> var_dt = FindVarType();
-	SyntaxToken identifier = Expect(IDENTIFIER_TOKEN);
-	if (not var_dt.has_value())
+	Token_t var_dt = FindVarType();
+	int identifier = Expect(IDENTIFIER_TOKEN);
+	if (var_dt == BAD_TOKEN)
 	{
-		throw std::invalid_argument("Data type for identifier: " + identifier.GetValue() + " not found.");
+		throw std::invalid_argument("Data type for identifier: " + std::string(TextAt(identifier)) + " not found.");
 	}
 	Variable var1;
-	var1.dtType = FromToken_tToDataType(var_dt.value().GetToken_t());
-	var1.identifier = identifier.GetValue();
+	var1.dtType = FromToken_tToDataType(var_dt);
+	var1.identifier = SymbolAt(identifier);
 
 	formal_parameters.push_back(var1);
 
 	while (Match(COMMA_TOKEN))
 	{
 		Advance();
-		std::optional<SyntaxToken> var_dt = FindVarType();
-		SyntaxToken identifier = Expect(IDENTIFIER_TOKEN);
-		if (not var_dt.has_value())
+		Token_t var_dt = FindVarType();
+		int identifier = Expect(IDENTIFIER_TOKEN);
+		if (var_dt == BAD_TOKEN)
 		{
-			throw std::invalid_argument("Data type for identifier: " + identifier.GetValue() + " not found.");
+			throw std::invalid_argument("Data type for identifier: " + std::string(TextAt(identifier)) + " not found.");
 		}
 		Variable var2;
-		var2.dtType = FromToken_tToDataType(var_dt.value().GetToken_t());
-		var2.identifier = identifier.GetValue();
+		var2.dtType = FromToken_tToDataType(var_dt);
+		var2.identifier = SymbolAt(identifier);
 		formal_parameters.push_back(var2);
 	}
 	return formal_parameters;
 }
 
-std::vector<std::unique_ptr<AstNode>> Parser::Arguments()
+std::span<AstNode*> Parser::Arguments()
 {
 	Expect(OPEN_PAREN);
-	std::vector<std::unique_ptr<AstNode>> args;
+	size_t first = this->node_stack.size();
 	while (not Match(CLOSE_PAREN))
 	{
-		args.push_back(ParseExpression());
+		this->node_stack.push_back(ParseExpression());
 		if (Match(CLOSE_PAREN))
 		{
 			break;
@@ -348,266 +647,343 @@ std::vector<std::unique_ptr<AstNode>> Parser::Arguments()
 		Expect(COMMA_TOKEN);
 	}
 	Expect(CLOSE_PAREN);
-	return args;
+	return PopNodes(first);
 }
 
-std::unique_ptr<AstNode> Parser::ParseBlockStatement(std::vector<Variable> pre_vars, std::string func_id)
+AstNode* Parser::ParseBlockStatement(const std::vector<Variable>& pre_vars)
 {
 	Expect(OPEN_CURLY_BRACKET);
 
-	Environment block_env;
-	for (auto pre_var : pre_vars)
+	this->scopes.Push();
+	for (const Variable& pre_var : pre_vars)
 	{
-		block_env.env_var.Set(pre_var);
+		if (not this->scopes.Add(pre_var.identifier, pre_var.dtType))
+		{
+			this->scopes.Pop();
+			throw std::invalid_argument("Identifier '" + SymbolName(pre_var.identifier) + "' already declared.");
+		}
 	}
-	this->env_stack.Push(std::move(block_env));
+	this->block_depth++;
 
-	std::vector<std::unique_ptr<AstNode>> stmts;
+	size_t first = this->node_stack.size();
 	while (not Match(CLOSE_CURLY_BRACKET))
 	{
-		std::unique_ptr<AstNode> stmt = ParseStatement();
+		int start = this->index;
+		AstNode* stmt = ParseStatement();
 		if (!stmt)
 		{
-			break;
+			if (this->index == start)
+			{
+				break;
+			}
+			continue;
 		}
-		stmts.push_back(std::move(stmt));
+		this->node_stack.push_back(stmt);
 	}
 	Expect(CLOSE_CURLY_BRACKET);
-	return std::make_unique<BlockStmtNode>(std::move(stmts));
+	this->block_depth--;
+	this->scopes.Pop();
+	return New<BlockStmtNode>(PopNodes(first));
 }
 
-std::unique_ptr<AstNode> Parser::VarDeclarationStatement()
+AstNode* Parser::VarDeclarationStatement()
 {
-	std::optional<SyntaxToken> dt_op = FindVarType();
+	Token_t dt = FindVarType();
 
-	SyntaxToken identifier = Expect(IDENTIFIER_TOKEN);
+	int identifier = Expect(IDENTIFIER_TOKEN);
 
-	if (not dt_op.has_value())
+	if (dt == BAD_TOKEN)
+	{
+		throw std::invalid_argument("Data type for identifier: " + std::string(TextAt(identifier)) + " not found.");
+	}
+	Symbol symbol = SymbolAt(identifier);
+	if (not this->scopes.Add(symbol, FromToken_tToDataType(dt)))
 	{
-		throw std::invalid_argument("Data type for identifier: " + identifier.GetValue() + " not found.");
+		// printed, as the Environment did, without stopping the parse
+		Notify("Identifier '" + SymbolName(symbol) + "' already declared.");
 	}
-	SyntaxToken dt = dt_op.value();
-	Variable var;
-	var.dtType = FromToken_tToDataType(dt.GetToken_t());
-	var.identifier = identifier.GetValue();
-	this->env_stack.Add(var);
-	std::unique_ptr<AstNode> expression;
+	AstNode* expression = nullptr;
 	if (ExpectOptional(EQUAL_TOKEN))
 	{
-		expression = std::move(ParseExpression());
+		expression = ParseExpression();
 	}
 	Expect(SEMICOLON_TOKEN);
 
-	return std::make_unique<VarDeclarationNode>(dt.GetToken_t(), identifier.GetValue(), std::move(expression));
+	return New<VarDeclarationNode>(dt, symbol, expression);
 }
 
-std::unique_ptr<AstNode> Parser::VarAssignmentStatement()
+AstNode* Parser::VarAssignmentStatement()
 {
-	SyntaxToken identifier = Expect(IDENTIFIER_TOKEN);
+	Symbol identifier = SymbolAt(Expect(IDENTIFIER_TOKEN));
 
 	if (ExpectOptional(PLUS_PLUS_TOKEN))
 	{
-		std::unique_ptr<AstNode> ppt = std::make_unique<BinaryExpression>(std::make_unique<IdentifierNode>(identifier.GetValue()), PLUS_TOKEN, std::make_unique<NumberNode>(1));
+		AstNode* ppt = New<BinaryExpression>(New<IdentifierNode>(identifier), PLUS_TOKEN, New<NumberNode>(1));
 		Expect(SEMICOLON_TOKEN);
-		return std::make_unique<VarAssignmentStmtNode>(identifier.GetValue(), std::move(ppt));
+		return New<VarAssignmentStmtNode>(identifier, ppt);
 	}
 	if (ExpectOptional(TRIPLE_PLUS_TOKEN))
 	{
-		std::unique_ptr<AstNode> ppt = std::make_unique<BinaryExpression>(std::make_unique<IdentifierNode>(identifier.GetValue()), PLUS_TOKEN, std::make_unique<NumberNode>(2));
+		AstNode* ppt = New<BinaryExpression>(New<IdentifierNode>(identifier), PLUS_TOKEN, New<NumberNode>(2));
 		Expect(SEMICOLON_TOKEN);
-		return std::make_unique<VarAssignmentStmtNode>(identifier.GetValue(), std::move(ppt));
+		return New<VarAssignmentStmtNode>(identifier, ppt);
 	}
 	if (ExpectOptional(MINUS_MINUS_TOKEN))
 	{
-		std::unique_ptr<AstNode> ppt = std::make_unique<BinaryExpression>(std::make_unique<IdentifierNode>(identifier.GetValue()), MINUS_TOKEN, std::make_unique<NumberNode>(1));
+		AstNode* ppt = New<BinaryExpression>(New<IdentifierNode>(identifier), MINUS_TOKEN, New<NumberNode>(1));
 		Expect(SEMICOLON_TOKEN);
-		return std::make_unique<VarAssignmentStmtNode>(identifier.GetValue(), std::move(ppt));
+		return New<VarAssignmentStmtNode>(identifier, ppt);
 	}
 	if (ExpectOptional(PLUS_EQUAL_TOKEN))
 	{
-		std::unique_ptr<AstNode> ppt = std::make_unique<BinaryExpression>(std::make_unique<IdentifierNode>(identifier.GetValue()), PLUS_TOKEN, std::move(ParseExpression()));
+		AstNode* ppt = New<BinaryExpression>(New<IdentifierNode>(identifier), PLUS_TOKEN, ParseExpression());
 		Expect(SEMICOLON_TOKEN);
-		return std::make_unique<VarAssignmentStmtNode>(identifier.GetValue(), std::move(ppt));
+		return New<VarAssignmentStmtNode>(identifier, ppt);
 	}
 	if (ExpectOptional(MINUS_EQUAL_TOKEN))
 	{
-		std::unique_ptr<AstNode> ppt = std::make_unique<BinaryExpression>(std::make_unique<IdentifierNode>(identifier.GetValue()), MINUS_TOKEN, std::move(ParseExpression()));
+		AstNode* ppt = New<BinaryExpression>(New<IdentifierNode>(identifier), MINUS_TOKEN, ParseExpression());
 		Expect(SEMICOLON_TOKEN);
-		return std::make_unique<VarAssignmentStmtNode>(identifier.GetValue(), std::move(ppt));
+		return New<VarAssignmentStmtNode>(identifier, ppt);
 	}
 	if (ExpectOptional(STAR_EQUAL_TOKEN))
 	{
-		std::unique_ptr<AstNode> ppt = std::make_unique<BinaryExpression>(std::make_unique<IdentifierNode>(identifier.GetValue()), STAR_TOKEN, std::move(ParseExpression()));
+		AstNode* ppt = New<BinaryExpression>(New<IdentifierNode>(identifier), STAR_TOKEN, ParseExpression());
 		Expect(SEMICOLON_TOKEN);
-		return std::make_unique<VarAssignmentStmtNode>(identifier.GetValue(), std::move(ppt));
+		return New<VarAssignmentStmtNode>(identifier, ppt);
 	}
 	if (ExpectOptional(SLASH_EQUAL_TOKEN))
 	{
-		std::unique_ptr<AstNode> ppt = std::make_unique<BinaryExpression>(std::make_unique<IdentifierNode>(identifier.GetValue()), SLASH_TOKEN, std::move(ParseExpression()));
+		AstNode* ppt = New<BinaryExpression>(New<IdentifierNode>(identifier), SLASH_TOKEN, ParseExpression());
 		Expect(SEMICOLON_TOKEN);
-		return std::make_unique<VarAssignmentStmtNode>(identifier.GetValue(), std::move(ppt));
+		return New<VarAssignmentStmtNode>(identifier, ppt);
 	}
 
 	if (ExpectOptional(EQUAL_TOKEN))
 	{
-		std::unique_ptr<AstNode> expression = ParseExpression();
+		AstNode* expression = ParseExpression();
 		Expect(SEMICOLON_TOKEN);
-		return std::make_unique<VarAssignmentStmtNode>(identifier.GetValue(), std::move(expression));
+		return New<VarAssignmentStmtNode>(identifier, expression);
 	}
 	Back();
 	return ParseTerm();
 }
 
-std::unique_ptr<AstNode> Parser::ParseExpression()
+AstNode* Parser::ParseExpression()
 {
 	if (Match(OPEN_PAREN))
 	{
 		return Group();
 	}
-	if (Match(IDENTIFIER_TOKEN) && PeekNext().GetToken_t() == OPEN_PAREN)
+	if (Match(IDENTIFIER_TOKEN) && PeekKind(1) == OPEN_PAREN)
 	{
 		return FunctionCall();
 	}
-	if (Match(IDENTIFIER_TOKEN) && PeekNext().GetToken_t() != OPEN_PAREN)
+	if (Match(IDENTIFIER_TOKEN) && PeekKind(1) != OPEN_PAREN)
 	{
 		return VarAssignmentStatement();
 	}
 	return ParseBinaryExpression();
 }
 
-std::unique_ptr<AstNode> Parser::Group()
+AstNode* Parser::Group()
 {
 	Expect(OPEN_PAREN);
-	std::unique_ptr<AstNode> expression = ParseExpression();
+	AstNode* expression = ParseExpression();
 	Expect(CLOSE_PAREN);
 	return expression;
 }
 
-std::unique_ptr<AstNode> Parser::ParseBinaryExpression(int parentPrecedence)
+// Precedence climbing with an explicit stack: an operator waiting for its
+// right operand (or a unary one for its operand) is pushed with the
+// precedence to return to, so generated expressions of any length use no
+// native stack. Builds the same tree as the recursive form it replaces,
+// where a unary operator takes everything that binds tighter than it.
+AstNode* Parser::ParseBinaryExpression()
 {
-	std::unique_ptr<AstNode> left;
-
-	unsigned short unary_prec = GetUnaryOperatorPrecedence(Peek().GetToken_t());
-	if (unary_prec != 0 && unary_prec >= parentPrecedence)
-	{
-		SyntaxToken operatorToken = NextToken();
-		std::unique_ptr<AstNode> operand = ParseBinaryExpression(unary_prec);
-		left = std::make_unique<UnaryNode>(operatorToken.GetToken_t(), std::move(operand));
-	}
-	else
-	{
-		left = ParsePrimary();
-	}
-
+	size_t first = this->pending_operators.size();
+	int parent = 0;
 	while (true)
 	{
-		unsigned short prec = GetBinaryOperatorPrecedence(Peek().GetToken_t());
-		if (prec == 0 || prec <= parentPrecedence)
+		Token_t op = PeekKind();
+		unsigned short unary_prec = GetUnaryOperatorPrecedence(op);
+		if (unary_prec != 0 && unary_prec >= parent)
 		{
-			break;
+			Advance();
+			this->pending_operators.push_back({ nullptr, op, parent });
+			parent = unary_prec;
+			continue;
 		}
-		SyntaxToken operatorToken = NextToken();
-		std::unique_ptr<AstNode> right = ParseBinaryExpression(prec);
-		left = std::make_unique<BinaryExpression>(std::move(left), operatorToken.GetToken_t(), std::move(right));
-	}
 
-	return left;
+		AstNode* left = ParsePrimary();
+		while (true)
+		{
+			op = PeekKind();
+			unsigned short prec = GetBinaryOperatorPrecedence(op);
+			if (prec != 0 && prec > parent)
+			{
+				Advance();
+				this->pending_operators.push_back({ left, op, parent });
+				parent = prec;
+				break; // on to its right operand
+			}
+			if (this->pending_operators.size() == first)
+			{
+				return left;
+			}
+			// 'left' completes the operand of the innermost pending operator
+			PendingOperator pending = this->pending_operators.back();
+			this->pending_operators.pop_back();
+			if (pending.left == nullptr)
+			{
+				left = New<UnaryNode>(pending.op, left);
+			}
+			else
+			{
+				left = New<BinaryExpression>(pending.left, pending.op, left);
+			}
+			parent = pending.parent;
+		}
+	}
 }
 
-std::unique_ptr<AstNode> Parser::ParseTerm()
+AstNode* Parser::ParseTerm()
 {
-	std::unique_ptr<AstNode> left = ParseFactor();
-	while (MatchAny({ PLUS_TOKEN, MINUS_TOKEN, EQUAL_EQUAL_TOKEN, AMPERSAND_AMPERSAND_TOKEN, BANG_EQUAL_TOKEN, PIPE_PIPE_TOKEN }))
+	AstNode* left = ParseFactor();
+	while (MatchAny(TERM_OPERATORS))
 	{
-		SyntaxToken op = NextToken();
-		std::unique_ptr<AstNode> right = ParseFactor();
-		left = std::make_unique<BinaryExpression>(std::move(left), op.GetToken_t(), std::move(right));
+		Token_t op = PeekKind();
+		Advance();
+		AstNode* right = ParseFactor();
+		left = New<BinaryExpression>(left, op, right);
 	}
 	return left;
 }
 
-std::unique_ptr<AstNode> Parser::ParseFactor()
+AstNode* Parser::ParseFactor()
 {
-	std::unique_ptr<AstNode> left = ParseUnary();
+	AstNode* left = ParseUnary();
 
-	while (MatchAny({ STAR_TOKEN, SLASH_TOKEN }))
+	while (MatchAny(FACTOR_OPERATORS))
 	{
-		SyntaxToken op = NextToken();
-		std::unique_ptr<AstNode> right = ParseUnary();
-		left = std::make_unique<BinaryExpression>(std::move(left), op.GetToken_t(), std::move(right));
+		Token_t op = PeekKind();
+		Advance();
+		AstNode* right = ParseUnary();
+		left = New<BinaryExpression>(left, op, right);
 	}
 
 	return left;
 }
 
-std::unique_ptr<AstNode> Parser::ParseUnary()
+AstNode* Parser::ParseUnary()
 {
-	if (MatchAny({ MINUS_TOKEN, BANG_TOKEN }))
+	if (MatchAny(UNARY_OPERATORS))
 	{
-		SyntaxToken token = NextToken();
-		std::unique_ptr<AstNode> unary = ParseUnary();
-		return std::make_unique<UnaryNode>(token.GetToken_t(), std::move(unary));
+		Token_t op = PeekKind();
+		Advance();
+		AstNode* unary = ParseUnary();
+		return New<UnaryNode>(op, unary);
 	}
 	return ParsePrimary();
 }
 
-std::unique_ptr<AstNode> Parser::ParsePrimary()
+// Narrows the decoded literal at token 'index' to 'target'. Integral types
+// take the integer part; DT_NOT_VALID means no declared type, where a
+// literal with a fraction is a double and any other an int.
+Value Parser::NumberValue(size_t index, DataType target)
 {
-	std::unique_ptr<AstNode> primary = {};
-	SyntaxToken token = SyntaxToken::SyntaxToken(BAD_TOKEN, "", -1, 0, 0);
+	NumberLiteral number = this->tokens.Number(index);
+	if (target == DT_NOT_VALID)
+	{
+		target = number.is_floating ? DT_DOUBLE : DT_INT;
+	}
 
-	SyntaxToken prev = Previous();
-	SyntaxToken prev_prev = PreviousPrevious();
-	if (Match(NUMBER_LITERAL_TOKEN) &&
-		prev.GetToken_t() == EQUAL_TOKEN &&
-		prev_prev.GetToken_t() == IDENTIFIER_TOKEN)
+	Value value;
+	const char* type_name = "int";
+	switch (target)
 	{
-		token = NextToken();
-		std::pair<Variable, Environment> var = std::move(this->env_stack.Get(prev_prev.GetValue()));
-		switch (var.first.dtType)
-		{
-			case DT_SHORT:
-				return std::make_unique<NumberNode>((short)stoi(token.GetValue()));
-			case DT_INT:
-				return std::make_unique<NumberNode>(stoi(token.GetValue()));
-			case DT_LONG:
-				return std::make_unique<NumberNode>(stol(token.GetValue()));
-			case DT_FLOAT:
-				return std::make_unique<NumberNode>(stof(token.GetValue()));
-			case DT_DOUBLE:
-				return std::make_unique<NumberNode>(stod(token.GetValue()));
-			default:
-				return std::make_unique<NumberNode>(stoi(token.GetValue()));
-		}
+		case DT_SHORT:
+			type_name = "short";
+			if (number.integer_fits && number.integer >= SHRT_MIN && number.integer <= SHRT_MAX)
+			{
+				value = Value((short)number.integer);
+			}
+			break;
+		case DT_LONG:
+			type_name = "long";
+			if (number.integer_fits && number.integer >= LONG_MIN && number.integer <= LONG_MAX)
+			{
+				value = Value((long)number.integer);
+			}
+			break;
+		case DT_FLOAT:
+			type_name = "float";
+			if (number.real_fits && number.real <= FLT_MAX)
+			{
+				value = Value((float)number.real);
+			}
+			break;
+		case DT_DOUBLE:
+			type_name = "double";
+			if (number.real_fits)
+			{
+				value = Value(number.real);
+			}
+			break;
+		default:
+			if (number.integer_fits && number.integer >= INT_MIN && number.integer <= INT_MAX)
+			{
+				value = Value((int)number.integer);
+			}
+			break;
+	}
+	if (value.IsEmpty())
+	{
+		throw std::invalid_argument("Number literal '" + std::string(this->tokens.Text(index)) + "' is out of range for " + std::string(type_name) + " at " + this->tokens.Describe(index));
 	}
-	else if (Match(NUMBER_LITERAL_TOKEN))
+	return value;
+}
+
+AstNode* Parser::ParsePrimary()
+{
+	AstNode* primary = nullptr;
+
+	if (Match(NUMBER_LITERAL_TOKEN))
 	{
-		token = NextToken();
-		if (token.GetValue().find('.') != std::string::npos)
+		// a literal assigned straight to a variable takes the variable's type
+		DataType target = DT_NOT_VALID;
+		if (PeekKind(-1) == EQUAL_TOKEN && PeekKind(-2) == IDENTIFIER_TOKEN)
 		{
-			return std::make_unique<NumberNode>(stod(token.GetValue()));
+			Symbol variable = SymbolAt(this->index - 2);
+			target = this->scopes.Find(variable);
+			if (target == DT_NOT_VALID)
+			{
+				throw std::invalid_argument("Variable Identifier '" + SymbolName(variable) + "' not found.");
+			}
 		}
-		return std::make_unique<NumberNode>(stoi(token.GetValue()));
+		return New<NumberNode>(NumberValue(this->index++, target));
 	}
 	else if (Match(STRING_LITERAL_TOKEN))
 	{
-		token = NextToken();
-		return std::make_unique<StringNode>(token.GetValue());
+		std::string_view text = TextAt(this->index);
+		Advance();
+		return New<StringNode>(CopyText(text));
 	}
 	else if (Match(IDENTIFIER_TOKEN))
 	{
-		token = NextToken();
-		return std::make_unique<IdentifierNode>(token.GetValue());
+		Symbol identifier = SymbolAt(this->index);
+		Advance();
+		return New<IdentifierNode>(identifier);
 	}
 	else if (Match(FALSE_TOKEN))
 	{
 		Advance();
-		return std::make_unique<BoolNode>(false);
+		return New<BoolNode>(false);
 	}
 	else if (Match(TRUE_TOKEN))
 	{
 		Advance();
-		return std::make_unique<BoolNode>(true);
+		return New<BoolNode>(true);
 	}
 	return primary;
 }
@@ -1,65 +1,142 @@
 #pragma once
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <optional>
+#include <span>
+#include <string>
+#include <utility>
 
 #include "lexer.hpp"
+#include "sourcebuffer.hpp"
+#include "tokenstream.hpp"
 #include "nodes/astnode.hpp"
+#include "program.hpp"
 #include "environment.hpp"
 #include "envstack.hpp"
+#include "scopetable.hpp"
+#include "lazybody.hpp"
 
 #include "functionmemory.hpp"
 
+enum ParseMode
+{
+	PARSE_STREAMING, // tokens pulled from the lexer as the parser goes
+	PARSE_PIPELINED, // the lexer runs ahead on its own thread (TokenPipeline)
+	PARSE_PARALLEL,  // top-level function bodies parsed on worker threads
+	PARSE_LAZY       // top-level function bodies parsed when first called (LazyBody)
+};
+
 class Parser
 {
 public:
-	Parser(std::string program, EnvStack env, FunctionMemory& function_memory);
+	Parser(std::string program, EnvStack env, FunctionMemory& function_memory, ParseMode mode = PARSE_STREAMING);
+	Parser(SourceBuffer source, EnvStack env, FunctionMemory& function_memory, ParseMode mode = PARSE_STREAMING);
+	Parser(const Parser&) = delete; // tokens point into 'source'
+	Parser& operator=(const Parser&) = delete;
 
-	std::vector<std::unique_ptr<AstNode>> Parse();
+	Program Parse();
 	std::vector<std::string> GetErrorReports();
+	bool HasErrors() const { return not this->error_reports.empty() || this->tokens.HasErrors(); }
+	PipelineStats GetPipelineStats();
+
+	static std::vector<std::string> ParseLazyBody(FuncVariable& func_var);
 private:
-	EnvStack env_stack;
+	// A top-level function whose body PARSE_PARALLEL left for a worker.
+	// A console message of the parse and the token index it was printed at.
+	using Notice = std::pair<int, std::string>;
+
+	struct DeferredBody
+	{
+		size_t start = 0;   // token index of the body's '{'
+		size_t end = 0;     // and of its matching '}'
+		ScopeTable scopes; // visible at the declaration
+		FuncVariable function;
+		std::vector<FuncVariable> functions; // declared in the body, then the function itself
+		std::vector<Notice> notices;
+		bool failed = false;
+	};
+
+	Parser(const TokenBuffer& buffer, FunctionMemory& function_memory); // a PARSE_PARALLEL worker
+
+	void ParseStatements();
+	bool ParseParallel();
+	void ParseLazy();
+	bool DeclaresFunction(size_t start, size_t end);
+	void ParseDeferredBody(DeferredBody& body);
+	bool RegisterDeclared(std::vector<FuncVariable>& declared, std::vector<DeferredBody>& bodies);
+	void Declare(FuncVariable func_var);
+	size_t MatchingBrace(size_t open);
+
+	ParseMode mode;
+	int block_depth = 0;
+	std::vector<FuncVariable>* declared_functions = nullptr; // recorded here instead of registered when set
+	std::vector<DeferredBody>* deferred_bodies = nullptr;    // set while PARSE_PARALLEL skips bodies
+	std::vector<std::shared_ptr<LazyBody>>* lazy_bodies = nullptr; // set while PARSE_LAZY skips bodies
+	std::vector<Notice>* notices = nullptr; // collected here instead of printed when set
+
+	ScopeTable scopes;
 	FunctionMemory& function_memory;
-	std::vector<SyntaxToken> tokens;
+	std::shared_ptr<const SourceBuffer> source; // shared with the LazyBody records
+	TokenStream tokens; // pulled from the lexer as the parser advances
 	int index;
+	Program program;
+	std::vector<AstNode*> node_stack; // children of the blocks and calls being parsed
+
+	// An operator of ParseBinaryExpression waiting for its right operand;
+	// 'left' is null for a unary one.
+	struct PendingOperator
+	{
+		AstNode* left;
+		Token_t op;
+		int parent; // precedence to return to once it is complete
+	};
+	std::vector<PendingOperator> pending_operators;
+
+	template <class T, class... Args>
+	T* New(Args&&... args)
+	{
+		return this->program.arena.New<T>(std::forward<Args>(args)...);
+	}
+	std::string_view CopyText(std::string_view text);
 
 	void Report(std::string error);
+	void Notify(std::string message);
 	std::vector<std::string> error_reports;
 
 
-	SyntaxToken NextToken();
+	// The cursor reads tokens in place by index; nothing is copied out.
+	Token_t PeekKind(int offset = 0);
+	Symbol SymbolAt(int index);
+	std::string_view TextAt(int index);
 	bool IsAtEnd();
 	void Advance();
-	SyntaxToken PeekNextNext();
-	SyntaxToken PeekNext();
-	SyntaxToken Peek();
-	SyntaxToken Previous();
-	SyntaxToken PreviousPrevious();
 	void Back();
-	SyntaxToken Expect(Token_t match);
-	std::optional<SyntaxToken> ExpectOptional(Token_t expect);
-	std::optional<SyntaxToken> FindVarType();
+	int Expect(Token_t expect);
+	bool ExpectOptional(Token_t expect);
+	Token_t FindVarType();
 	bool Match(Token_t match);
-	bool MatchAny(std::vector<Token_t> tokens);
-	SyntaxToken LookAhead(int offset);
-	std::unique_ptr<AstNode> ParseStatement();
-	std::unique_ptr<AstNode> ParseIfStatement();
-	std::unique_ptr<AstNode> ParsePrintStatement();
-	std::unique_ptr<AstNode> DeclarationStatement();
-	std::unique_ptr<AstNode> FunctionDeclarationStatement();
-	std::unique_ptr<AstNode> FunctionCall();
+	bool MatchAny(TokenSet tokens);
+	std::span<AstNode*> PopNodes(size_t first);
+	AstNode* ParseStatement();
+	AstNode* ParseIfStatement();
+	AstNode* ParsePrintStatement();
+	AstNode* DeclarationStatement();
+	AstNode* FunctionDeclarationStatement();
+	AstNode* FunctionCall();
 	std::vector<Variable> Parameters();
-	std::vector<std::unique_ptr<AstNode>> Arguments();
-	std::unique_ptr<AstNode> ParseBlockStatement(std::vector<Variable> pre_vars = {}, std::string func_id = "main");
-	std::unique_ptr<AstNode> VarDeclarationStatement();
-	std::unique_ptr<AstNode> VarAssignmentStatement();
-	std::unique_ptr<AstNode> ParseExpression();
-	std::unique_ptr<AstNode> Group();
-	std::unique_ptr<AstNode> ParseBinaryExpression(int precedence = 0);
-	std::unique_ptr<AstNode> ParseTerm();
-	std::unique_ptr<AstNode> ParseFactor();
-	std::unique_ptr<AstNode> ParseUnary();
-	std::unique_ptr<AstNode> ParsePrimary();
+	std::span<AstNode*> Arguments();
+	AstNode* ParseBlockStatement(const std::vector<Variable>& pre_vars = {});
+	AstNode* VarDeclarationStatement();
+	AstNode* VarAssignmentStatement();
+	AstNode* ParseExpression();
+	AstNode* Group();
+	AstNode* ParseBinaryExpression();
+	AstNode* ParseTerm();
+	AstNode* ParseFactor();
+	AstNode* ParseUnary();
+	AstNode* ParsePrimary();
+	Value NumberValue(size_t index, DataType target);
 
 };
 
@@ -0,0 +1,17 @@
+#pragma once
+#include <vector>
+
+#include "arena.hpp"
+#include "nodes/astnode.hpp"
+
+// Result of a parse: the top-level statements and the arena holding every
+// node they reach, function bodies included (FunctionMemory points into it;
+// PARSE_LAZY bodies live in their LazyBody instead).
+// The Program must outlive any pass or Chunk that uses its nodes; dropping
+// it releases the whole tree at once.
+class Program
+{
+public:
+	Arena arena;
+	std::vector<AstNode*> statements;
+};
@@ -0,0 +1,179 @@
+#include "quicken.hpp"
+
+#include <utility>
+
+// PromoteNumbers at compile time.
+static constexpr ValueType Promoted(ValueType left, ValueType right)
+{
+	return left < VAL_INT && right < VAL_INT ? VAL_INT : (left > right ? left : right);
+}
+
+template <ValueType TYPE> struct NumberOf;
+template <> struct NumberOf<VAL_INT> { using type = int; };
+template <> struct NumberOf<VAL_LONG> { using type = long; };
+template <> struct NumberOf<VAL_FLOAT> { using type = float; };
+template <> struct NumberOf<VAL_DOUBLE> { using type = double; };
+
+static const int NUMBER_TYPES = VAL_DOUBLE - VAL_SHORT + 1;
+
+// The operators BinaryOperation accepts, in executor order.
+static constexpr Token_t NUMBER_OPS[] = { PLUS_TOKEN, MINUS_TOKEN, STAR_TOKEN, SLASH_TOKEN, EQUAL_EQUAL_TOKEN, BANG_EQUAL_TOKEN };
+static constexpr Token_t BOOL_OPS[] = { EQUAL_EQUAL_TOKEN, BANG_EQUAL_TOKEN, AMPERSAND_AMPERSAND_TOKEN, PIPE_PIPE_TOKEN };
+static const int FIRST_BOOL_EXECUTOR = 1 + std::size(NUMBER_OPS) * NUMBER_TYPES * NUMBER_TYPES;
+
+template <Token_t OP, ValueType LEFT, ValueType RIGHT>
+static Value QuickNumbers(Value left, Value right)
+{
+	if (left.type != LEFT || right.type != RIGHT)
+	{
+		return Value();
+	}
+	using T = typename NumberOf<Promoted(LEFT, RIGHT)>::type;
+	return Arithmetic<T>(OP, left.Unbox<T>(LEFT), right.Unbox<T>(RIGHT));
+}
+
+template <Token_t OP>
+static Value QuickBools(Value left, Value right)
+{
+	if (left.type != VAL_BOOL || right.type != VAL_BOOL)
+	{
+		return Value();
+	}
+	bool lvar = left.AsBool();
+	bool rvar = right.AsBool();
+	if constexpr (OP == AMPERSAND_AMPERSAND_TOKEN)
+	{
+		return lvar && rvar;
+	}
+	else if constexpr (OP == PIPE_PIPE_TOKEN)
+	{
+		return lvar || rvar;
+	}
+	else if constexpr (OP == EQUAL_EQUAL_TOKEN)
+	{
+		return lvar == rvar;
+	}
+	else
+	{
+		return lvar != rvar;
+	}
+}
+
+// Executor 1 + (op * NUMBER_TYPES + left) * NUMBER_TYPES + right is op on
+// two numbers, then one per BOOL_OPS operator on two bools.
+template <size_t I>
+static constexpr BinaryExecutor BinaryExecutorAt()
+{
+	if constexpr (I == QUICK_NONE)
+	{
+		return nullptr;
+	}
+	else if constexpr (I < FIRST_BOOL_EXECUTOR)
+	{
+		constexpr size_t number = I - 1;
+		constexpr ValueType left = (ValueType)(VAL_SHORT + number / NUMBER_TYPES % NUMBER_TYPES);
+		constexpr ValueType right = (ValueType)(VAL_SHORT + number % NUMBER_TYPES);
+		return QuickNumbers<NUMBER_OPS[number / (NUMBER_TYPES * NUMBER_TYPES)], left, right>;
+	}
+	else
+	{
+		return QuickBools<BOOL_OPS[I - FIRST_BOOL_EXECUTOR]>;
+	}
+}
+
+template <size_t... I>
+static constexpr std::array<BinaryExecutor, sizeof...(I)> BinaryExecutors(std::index_sequence<I...>)
+{
+	return { BinaryExecutorAt<I>()... };
+}
+
+constexpr std::array<BinaryExecutor, 155> BINARY_EXECUTORS = BinaryExecutors(std::make_index_sequence<155>());
+static_assert(FIRST_BOOL_EXECUTOR + std::size(BOOL_OPS) == BINARY_EXECUTORS.size());
+
+template <size_t N>
+static int IndexOf(const Token_t (&ops)[N], Token_t op)
+{
+	for (size_t i = 0; i < N; i++)
+	{
+		if (ops[i] == op)
+		{
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+uint8_t SpecializeBinary(Token_t op, ValueType left, ValueType right)
+{
+	if (IsNumberType(left) && IsNumberType(right))
+	{
+		int number_op = IndexOf(NUMBER_OPS, op);
+		if (number_op >= 0)
+		{
+			return (uint8_t)(1 + (number_op * NUMBER_TYPES + left - VAL_SHORT) * NUMBER_TYPES + right - VAL_SHORT);
+		}
+	}
+	if (left == VAL_BOOL && right == VAL_BOOL)
+	{
+		int bool_op = IndexOf(BOOL_OPS, op);
+		if (bool_op >= 0)
+		{
+			return (uint8_t)(FIRST_BOOL_EXECUTOR + bool_op);
+		}
+	}
+	return QUICK_GENERIC;
+}
+
+template <ValueType TYPE>
+static Value QuickSame(Value operand)
+{
+	if (operand.type != TYPE)
+	{
+		return Value();
+	}
+	return operand;
+}
+
+template <ValueType TYPE>
+static Value QuickNegate(Value operand)
+{
+	if (operand.type != TYPE)
+	{
+		return Value();
+	}
+	using T = typename NumberOf<Promoted(TYPE, TYPE)>::type;
+	return -operand.Unbox<T>(TYPE);
+}
+
+static Value QuickNot(Value operand)
+{
+	if (operand.type != VAL_BOOL)
+	{
+		return Value();
+	}
+	return !operand.AsBool();
+}
+
+// Executor 1 + type keeps a number (unary '+'), 1 + NUMBER_TYPES + type
+// negates it, and the last one is '!' on a bool.
+constexpr std::array<UnaryExecutor, 12> UNARY_EXECUTORS = {
+	nullptr,
+	QuickSame<VAL_SHORT>, QuickSame<VAL_INT>, QuickSame<VAL_LONG>, QuickSame<VAL_FLOAT>, QuickSame<VAL_DOUBLE>,
+	QuickNegate<VAL_SHORT>, QuickNegate<VAL_INT>, QuickNegate<VAL_LONG>, QuickNegate<VAL_FLOAT>, QuickNegate<VAL_DOUBLE>,
+	QuickNot
+};
+
+// Following UnaryOperation: '+' keeps a number as it is, any other operator
+// negates it, and only '!' applies to a bool.
+uint8_t SpecializeUnary(Token_t op, ValueType operand)
+{
+	if (IsNumberType(operand))
+	{
+		return (uint8_t)(1 + (op == PLUS_TOKEN ? 0 : NUMBER_TYPES) + operand - VAL_SHORT);
+	}
+	if (operand == VAL_BOOL && op == BANG_TOKEN)
+	{
+		return (uint8_t)(UNARY_EXECUTORS.size() - 1);
+	}
+	return QUICK_GENERIC;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include "token.hpp"
+#include "value.hpp"
+
+// An operation specialized for the operand types a node has seen: each is
+// a template instance for one operator and exact operand tags, so it does
+// neither tag dispatch nor operator dispatch. The operand tags are its
+// guard: an operand of another type returns an empty Value, which no
+// specialized operation otherwise produces, and the caller falls back to
+// BinaryOperation/UnaryOperation. Errors (integer division by zero) are
+// thrown exactly as the generic operation throws them.
+using BinaryExecutor = Value (*)(Value left, Value right);
+using UnaryExecutor = Value (*)(Value operand);
+
+// A node stores its executor as a one-byte index into the tables below, so
+// quickening does not grow the AST. QUICK_NONE until the node first runs,
+// QUICK_GENERIC once no executor applies or a guard has failed.
+enum : uint8_t
+{
+	QUICK_NONE = 0,
+	QUICK_GENERIC = UINT8_MAX
+};
+
+extern const std::array<BinaryExecutor, 155> BINARY_EXECUTORS;
+extern const std::array<UnaryExecutor, 12> UNARY_EXECUTORS;
+
+// QUICK_GENERIC where the generic operation would throw for these types.
+uint8_t SpecializeBinary(Token_t op, ValueType left, ValueType right);
+uint8_t SpecializeUnary(Token_t op, ValueType operand);
@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "resolver.hpp"
+#include "parser.hpp"
+#include "ast_node_headers.hpp"
+
+Resolver::Resolver(FunctionMemory& function_memory)
+	: function_memory(function_memory)
+{
+}
+
+std::vector<std::string> Resolver::Resolve(std::vector<AstNode*>& statements)
+{
+	this->frames.clear();
+	this->frames.push_back(FrameScope());
+	// a function called from inside a top-level block addresses globals by
+	// slot, so the block's locals must not reuse one declared after it
+	for (AstNode* stmt : statements)
+	{
+		if (stmt != nullptr && stmt->kind == NODE_VAR_DECLARATION)
+		{
+			this->frames.back().reserved++;
+		}
+	}
+	BeginScope();
+	for (auto& stmt : statements)
+	{
+		if (stmt == nullptr)
+		{
+			continue;
+		}
+		Dispatch(*this, *stmt);
+	}
+
+	// function bodies see their own frame plus every top-level variable
+	for (Symbol identifier : this->function_memory.GetIdentifiers())
+	{
+		ResolveFunction(this->function_memory.GetRef(identifier));
+	}
+
+	// the global frame stays for bodies Materialize resolves later
+	this->global_slot_count = this->frames.back().slot_count;
+	return this->errors;
+}
+
+// A PARSE_LAZY function is parsed and resolved the first time it is
+// needed, against the global frame Resolve left behind. Throws the first
+// report, so the caller fails where the function is used.
+void Resolver::Materialize(FuncVariable& func_var)
+{
+	if (func_var.block_stmt != nullptr || func_var.lazy_body == nullptr)
+	{
+		return;
+	}
+	std::vector<std::string> reports = Parser::ParseLazyBody(func_var);
+	if (not reports.empty())
+	{
+		throw std::invalid_argument(reports.front());
+	}
+	size_t reported = this->errors.size();
+	ResolveFunction(func_var);
+	if (this->errors.size() > reported)
+	{
+		std::string error = this->errors[reported];
+		func_var.block_stmt = nullptr;
+		throw std::invalid_argument(error);
+	}
+}
+
+int Resolver::GetGlobalSlotCount()
+{
+	return this->global_slot_count;
+}
+
+void Resolver::Report(std::string error)
+{
+	this->errors.push_back(error);
+}
+
+void Resolver::BeginScope()
+{
+	FrameScope& frame = this->frames.back();
+	BlockScope block;
+	block.first_slot = frame.next_slot;
+	if (not frame.blocks.empty())
+	{
+		frame.next_slot = std::max(frame.next_slot, frame.reserved);
+	}
+	frame.blocks.push_back(std::move(block));
+}
+
+void Resolver::EndScope()
+{
+	FrameScope& frame = this->frames.back();
+	frame.next_slot = frame.blocks.back().first_slot;
+	frame.blocks.pop_back();
+}
+
+int Resolver::Declare(Symbol identifier)
+{
+	FrameScope& frame = this->frames.back();
+	BlockScope& block = frame.blocks.back();
+	if (block.slots.contains(identifier))
+	{
+		Report("Identifier '" + SymbolName(identifier) + "' already declared.");
+		return block.slots[identifier];
+	}
+	int slot = frame.next_slot++;
+	frame.slot_count = std::max(frame.slot_count, frame.next_slot);
+	block.slots[identifier] = slot;
+	return slot;
+}
+
+bool Resolver::Lookup(Symbol identifier, int& depth, int& slot)
+{
+	for (int f = (int)this->frames.size() - 1; f >= 0; f--)
+	{
+		std::vector<BlockScope>& blocks = this->frames[f].blocks;
+		for (auto block = blocks.rbegin(); block != blocks.rend(); ++block)
+		{
+			auto found = block->slots.find(identifier);
+			if (found != block->slots.end())
+			{
+				depth = (int)this->frames.size() - 1 - f;
+				slot = found->second;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void Resolver::ResolveFunction(FuncVariable& func_var)
+{
+	if (func_var.block_stmt == nullptr)
+	{
+		return;
+	}
+	this->frames.push_back(FrameScope());
+	BeginScope();
+	// parameters share the body's scope and take the first slots, which is
+	// where FrameStack::Push places the evaluated arguments
+	for (Variable& parameter : func_var.parameters)
+	{
+		Declare(parameter.identifier);
+	}
+	BlockStmtNode& body = static_cast<BlockStmtNode&>(*func_var.block_stmt);
+	for (auto& stmt : body.stmts)
+	{
+		Dispatch(*this, *stmt);
+	}
+	EndScope();
+	func_var.slot_count = this->frames.back().slot_count;
+	this->frames.pop_back();
+}
+
+Value Resolver::VisitBinaryExpression(BinaryExpression& binaryExpression)
+{
+	size_t first = this->chain.size();
+	binaryExpression.Chain(this->chain);
+	Dispatch(*this, *this->chain[first]->left);
+	for (size_t i = first; i < this->chain.size(); i++)
+	{
+		Dispatch(*this, *this->chain[i]->right);
+	}
+	this->chain.resize(first);
+	return Value();
+}
+
+Value Resolver::VisitBoolNode(BoolNode&)
+{
+	return Value();
+}
+
+Value Resolver::VisitNumberNode(NumberNode&)
+{
+	return Value();
+}
+
+Value Resolver::VisitStringNode(StringNode&)
+{
+	return Value();
+}
+
+Value Resolver::VisitIdentifierNode(IdentifierNode& identifierNode)
+{
+	if (not Lookup(identifierNode.identifier, identifierNode.depth, identifierNode.slot))
+	{
+		Report("Variable Identifier '" + SymbolName(identifierNode.identifier) + "' not found.");
+	}
+	return Value();
+}
+
+Value Resolver::VisitUnaryNode(UnaryNode& unaryNode)
+{
+	Dispatch(*this, *unaryNode.left);
+	return Value();
+}
+
+Value Resolver::VisitIfStmtNode(IfStmtNode& ifStmtNode)
+{
+	Dispatch(*this, *ifStmtNode.expression);
+	Dispatch(*this, *ifStmtNode.blockStmt);
+	return Value();
+}
+
+Value Resolver::VisitPrintStmt(PrintStmtNode& printStmtNode)
+{
+	Dispatch(*this, *printStmtNode.expression);
+	return Value();
+}
+
+Value Resolver::VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode)
+{
+	// the initializer is resolved first: 'int a = a;' reads an outer 'a'
+	if (varDeclarationNode.expression != nullptr)
+	{
+		Dispatch(*this, *varDeclarationNode.expression);
+	}
+	varDeclarationNode.depth = 0;
+	varDeclarationNode.slot = Declare(varDeclarationNode.identifier);
+	return Value();
+}
+
+Value Resolver::VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode)
+{
+	Dispatch(*this, *varAssignmentNode.expression);
+	if (not Lookup(varAssignmentNode.identifier, varAssignmentNode.depth, varAssignmentNode.slot))
+	{
+		Report("Variable Identifier '" + SymbolName(varAssignmentNode.identifier) + "' not found.");
+	}
+	return Value();
+}
+
+Value Resolver::VisitFunctionCallNode(FunctionCallExpr& functionCallExpr)
+{
+	if (not this->function_memory.Exist(functionCallExpr.identifier))
+	{
+		Report("Function identifier '" + SymbolName(functionCallExpr.identifier) + "' not declared.");
+	}
+	for (auto& arg : functionCallExpr.arguments)
+	{
+		Dispatch(*this, *arg);
+	}
+	return Value();
+}
+
+Value Resolver::VisitBlockStmtNode(BlockStmtNode& blockStmtNode)
+{
+	BeginScope();
+	for (auto& stmt : blockStmtNode.stmts)
+	{
+		Dispatch(*this, *stmt);
+	}
+	EndScope();
+	return Value();
+}
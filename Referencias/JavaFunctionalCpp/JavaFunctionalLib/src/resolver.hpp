@@ -0,0 +1,70 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "visitor.hpp"
+#include "nodes/astnode.hpp"
+#include "variable.hpp"
+#include "functionmemory.hpp"
+
+// Static pass run before interpretation: gives every variable declaration,
+// read and write a (depth, slot) address. 'depth' counts call frames outwards
+// (0 = current frame, 1 = global frame from inside a function) and 'slot' is
+// the index inside that frame. Sibling blocks share slots, so a frame is as
+// big as the deepest set of simultaneously live variables.
+class Resolver final : public Visitor
+{
+public:
+	Resolver(FunctionMemory& function_memory);
+
+	std::vector<std::string> Resolve(std::vector<AstNode*>& statements);
+	int GetGlobalSlotCount();
+	void Materialize(FuncVariable& func_var); // builds a PARSE_LAZY body; throws std::invalid_argument
+
+private:
+	template <class V>
+	friend Value Dispatch(V& visitor, AstNode& node);
+
+	struct BlockScope
+	{
+		std::unordered_map<Symbol, int> slots;
+		int first_slot = 0;
+	};
+	struct FrameScope
+	{
+		std::vector<BlockScope> blocks;
+		int next_slot = 0;
+		int slot_count = 0;
+		int reserved = 0; // slots nested blocks start past: the globals, in the global frame
+	};
+
+	FunctionMemory& function_memory;
+	std::vector<FrameScope> frames;
+	int global_slot_count = 0;
+	std::vector<BinaryExpression*> chain; // BinaryExpression::Chain of the expressions being resolved
+
+	std::vector<std::string> errors;
+	void Report(std::string error);
+
+	void BeginScope();
+	void EndScope();
+	int Declare(Symbol identifier);
+	bool Lookup(Symbol identifier, int& depth, int& slot);
+	void ResolveFunction(FuncVariable& func_var);
+
+	Value VisitBinaryExpression(BinaryExpression& binaryExpression);
+	Value VisitBoolNode(BoolNode& boolNode);
+	Value VisitNumberNode(NumberNode& numberNode);
+	Value VisitStringNode(StringNode& stringNode);
+	Value VisitIdentifierNode(IdentifierNode& identifierNode);
+	Value VisitUnaryNode(UnaryNode& unaryNode);
+
+	Value VisitIfStmtNode(IfStmtNode& ifStmtNode);
+	Value VisitPrintStmt(PrintStmtNode& printStmtNode);
+	Value VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode);
+	Value VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode);
+
+	Value VisitFunctionCallNode(FunctionCallExpr& functionCallExpr);
+	Value VisitBlockStmtNode(BlockStmtNode& blockStmtNode);
+};
@@ -0,0 +1,224 @@
+#include <bit>
+#include <cstdint>
+
+#include "scan.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SCAN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SCAN_SSE2
+#endif
+
+static bool IsWhitespace(char c)
+{
+	return c == ' ' || (unsigned char)(c - '\t') <= '\r' - '\t';
+}
+
+size_t SkipWhitespaceScalar(std::string_view text, size_t from)
+{
+	while (from < text.size() && IsWhitespace(text[from]))
+	{
+		from++;
+	}
+	return from;
+}
+
+size_t FindCommentEndScalar(std::string_view text, size_t from)
+{
+	for (; from + 1 < text.size(); from++)
+	{
+		if (text[from] == '*' && text[from + 1] == '/')
+		{
+			return from;
+		}
+	}
+	return std::string_view::npos;
+}
+
+size_t FindQuoteScalar(std::string_view text, size_t from)
+{
+	if (from >= text.size())
+	{
+		return std::string_view::npos;
+	}
+	return text.find('"', from);
+}
+
+size_t FindAnyOfScalar(std::string_view text, size_t from, char a, char b)
+{
+	for (; from < text.size(); from++)
+	{
+		if (text[from] == a || text[from] == b)
+		{
+			return from;
+		}
+	}
+	return std::string_view::npos;
+}
+
+size_t FindAnyOfScalar(std::string_view text, size_t from, char a, char b, char c)
+{
+	for (; from < text.size(); from++)
+	{
+		if (text[from] == a || text[from] == b || text[from] == c)
+		{
+			return from;
+		}
+	}
+	return std::string_view::npos;
+}
+
+// Each vector step produces a bit mask with one bit per byte; the first set
+// bit is the answer for that block.
+#if defined(SCAN_AVX2)
+
+static const size_t BLOCK = 32;
+typedef __m256i Block;
+
+static Block Load(const char* p) { return _mm256_loadu_si256((const __m256i*)p); }
+static Block Splat(char c) { return _mm256_set1_epi8(c); }
+static Block Equal(Block a, Block b) { return _mm256_cmpeq_epi8(a, b); }
+static Block And(Block a, Block b) { return _mm256_and_si256(a, b); }
+static Block Or(Block a, Block b) { return _mm256_or_si256(a, b); }
+static Block Sub(Block a, Block b) { return _mm256_sub_epi8(a, b); }
+static Block MinUnsigned(Block a, Block b) { return _mm256_min_epu8(a, b); }
+static uint32_t Mask(Block a) { return (uint32_t)_mm256_movemask_epi8(a); }
+static const uint32_t FULL_MASK = 0xFFFFFFFFu;
+
+#elif defined(SCAN_SSE2)
+
+static const size_t BLOCK = 16;
+typedef __m128i Block;
+
+static Block Load(const char* p) { return _mm_loadu_si128((const __m128i*)p); }
+static Block Splat(char c) { return _mm_set1_epi8(c); }
+static Block Equal(Block a, Block b) { return _mm_cmpeq_epi8(a, b); }
+static Block And(Block a, Block b) { return _mm_and_si128(a, b); }
+static Block Or(Block a, Block b) { return _mm_or_si128(a, b); }
+static Block Sub(Block a, Block b) { return _mm_sub_epi8(a, b); }
+static Block MinUnsigned(Block a, Block b) { return _mm_min_epu8(a, b); }
+static uint32_t Mask(Block a) { return (uint32_t)_mm_movemask_epi8(a); }
+static const uint32_t FULL_MASK = 0xFFFFu;
+
+#endif
+
+#if defined(SCAN_AVX2) || defined(SCAN_SSE2)
+
+size_t SkipWhitespace(std::string_view text, size_t from)
+{
+	const char* data = text.data();
+	const Block space = Splat(' ');
+	const Block tab = Splat('\t');
+	const Block control_range = Splat('\r' - '\t');
+	for (; from + BLOCK <= text.size(); from += BLOCK)
+	{
+		Block bytes = Load(data + from);
+		// '\t'..'\r' is a single unsigned range: c - '\t' <= 4
+		Block offset = Sub(bytes, tab);
+		Block is_control = Equal(MinUnsigned(offset, control_range), offset);
+		uint32_t whitespace = Mask(Or(Equal(bytes, space), is_control));
+		if (whitespace != FULL_MASK)
+		{
+			return from + std::countr_zero(~whitespace);
+		}
+	}
+	return SkipWhitespaceScalar(text, from);
+}
+
+size_t FindCommentEnd(std::string_view text, size_t from)
+{
+	const char* data = text.data();
+	const Block star = Splat('*');
+	const Block slash = Splat('/');
+	// the second load is one byte ahead, so it needs one byte of lookahead
+	for (; from + BLOCK + 1 <= text.size(); from += BLOCK)
+	{
+		uint32_t found = Mask(And(Equal(Load(data + from), star), Equal(Load(data + from + 1), slash)));
+		if (found != 0)
+		{
+			return from + std::countr_zero(found);
+		}
+	}
+	return FindCommentEndScalar(text, from);
+}
+
+size_t FindQuote(std::string_view text, size_t from)
+{
+	const char* data = text.data();
+	const Block quote = Splat('"');
+	for (; from + BLOCK <= text.size(); from += BLOCK)
+	{
+		uint32_t found = Mask(Equal(Load(data + from), quote));
+		if (found != 0)
+		{
+			return from + std::countr_zero(found);
+		}
+	}
+	return FindQuoteScalar(text, from);
+}
+
+size_t FindAnyOf(std::string_view text, size_t from, char a, char b)
+{
+	const char* data = text.data();
+	const Block first = Splat(a);
+	const Block second = Splat(b);
+	for (; from + BLOCK <= text.size(); from += BLOCK)
+	{
+		Block bytes = Load(data + from);
+		uint32_t found = Mask(Or(Equal(bytes, first), Equal(bytes, second)));
+		if (found != 0)
+		{
+			return from + std::countr_zero(found);
+		}
+	}
+	return FindAnyOfScalar(text, from, a, b);
+}
+
+size_t FindAnyOf(std::string_view text, size_t from, char a, char b, char c)
+{
+	const char* data = text.data();
+	const Block first = Splat(a);
+	const Block second = Splat(b);
+	const Block third = Splat(c);
+	for (; from + BLOCK <= text.size(); from += BLOCK)
+	{
+		Block bytes = Load(data + from);
+		uint32_t found = Mask(Or(Or(Equal(bytes, first), Equal(bytes, second)), Equal(bytes, third)));
+		if (found != 0)
+		{
+			return from + std::countr_zero(found);
+		}
+	}
+	return FindAnyOfScalar(text, from, a, b, c);
+}
+
+#else
+
+size_t SkipWhitespace(std::string_view text, size_t from)
+{
+	return SkipWhitespaceScalar(text, from);
+}
+
+size_t FindCommentEnd(std::string_view text, size_t from)
+{
+	return FindCommentEndScalar(text, from);
+}
+
+size_t FindQuote(std::string_view text, size_t from)
+{
+	return FindQuoteScalar(text, from);
+}
+
+size_t FindAnyOf(std::string_view text, size_t from, char a, char b)
+{
+	return FindAnyOfScalar(text, from, a, b);
+}
+
+size_t FindAnyOf(std::string_view text, size_t from, char a, char b, char c)
+{
+	return FindAnyOfScalar(text, from, a, b, c);
+}
+
+#endif
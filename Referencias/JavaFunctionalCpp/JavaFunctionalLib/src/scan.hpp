@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+
+// Byte-scanning kernels used by the Lexer for whitespace runs, comment
+// bodies and string literals, and by LexAllParallel to find chunk
+// boundaries. With AVX2 or SSE2 available at compile time
+// they look at 32 or 16 bytes per step; the remaining tail, and targets
+// without either, use the scalar loops below. Every kernel returns an index
+// into 'text' and never reads past its end.
+
+// First index at or after 'from' that is not ' ', '\t', '\n', '\v', '\f' or
+// '\r'; text.size() when the rest of the text is whitespace.
+size_t SkipWhitespace(std::string_view text, size_t from);
+
+// Index of the '*' of the first "*/" at or after 'from', npos if none.
+size_t FindCommentEnd(std::string_view text, size_t from);
+
+// Index of the first '"' at or after 'from', npos if none.
+size_t FindQuote(std::string_view text, size_t from);
+
+// Index of the first 'a' or 'b' (or 'c') at or after 'from', npos if none.
+size_t FindAnyOf(std::string_view text, size_t from, char a, char b);
+size_t FindAnyOf(std::string_view text, size_t from, char a, char b, char c);
+
+size_t SkipWhitespaceScalar(std::string_view text, size_t from);
+size_t FindCommentEndScalar(std::string_view text, size_t from);
+size_t FindQuoteScalar(std::string_view text, size_t from);
+size_t FindAnyOfScalar(std::string_view text, size_t from, char a, char b);
+size_t FindAnyOfScalar(std::string_view text, size_t from, char a, char b, char c);
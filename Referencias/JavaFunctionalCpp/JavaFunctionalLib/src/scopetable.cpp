@@ -0,0 +1,60 @@
+#include "scopetable.hpp"
+#include "environment.hpp"
+
+ScopeTable::ScopeTable(EnvStack& env_stack)
+{
+	for (Environment& env : env_stack.envs)
+	{
+		Push();
+		for (auto& [identifier, variable] : env.env_var.GetAll())
+		{
+			Add(identifier, variable.dtType);
+		}
+	}
+}
+
+void ScopeTable::Push()
+{
+	this->scope_starts.push_back(this->declarations.size());
+}
+
+void ScopeTable::Pop()
+{
+	size_t start = this->scope_starts.back();
+	this->scope_starts.pop_back();
+	while (this->declarations.size() > start)
+	{
+		Declaration& declaration = this->declarations.back();
+		this->innermost[declaration.identifier] = declaration.shadowed;
+		this->declarations.pop_back();
+	}
+}
+
+bool ScopeTable::Add(Symbol identifier, DataType type)
+{
+	if (identifier == NO_SYMBOL)
+	{
+		return true; // a missing name was already reported
+	}
+	if (identifier >= this->innermost.size())
+	{
+		this->innermost.resize(identifier + 1, -1);
+	}
+	int shadowed = this->innermost[identifier];
+	if (shadowed >= 0 && (size_t)shadowed >= this->scope_starts.back())
+	{
+		return false;
+	}
+	this->innermost[identifier] = (int)this->declarations.size();
+	this->declarations.push_back({ identifier, type, shadowed });
+	return true;
+}
+
+DataType ScopeTable::Find(Symbol identifier) const
+{
+	if (identifier >= this->innermost.size() || this->innermost[identifier] < 0)
+	{
+		return DT_NOT_VALID;
+	}
+	return this->declarations[this->innermost[identifier]].type;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <vector>
+
+#include "envstack.hpp"
+#include "symboltable.hpp"
+#include "variable.hpp"
+
+// Declared types of the variables the Parser can see, which it needs to
+// type a number literal assigned to a variable. Scopes are flat: one entry
+// per declaration, plus the innermost declaration of every Symbol, so
+// Push, Add, Pop and Find touch no map and allocate nothing once the
+// vectors have grown.
+class ScopeTable
+{
+public:
+	ScopeTable() = default;
+	ScopeTable(EnvStack& env_stack); // one scope per Environment
+
+	void Push();
+	void Pop();
+	bool Add(Symbol identifier, DataType type); // false if already declared in this scope
+	DataType Find(Symbol identifier) const;     // DT_NOT_VALID when not visible
+	bool Empty() const { return this->scope_starts.empty(); }
+
+private:
+	struct Declaration
+	{
+		Symbol identifier;
+		DataType type;
+		int shadowed; // declaration it hides, or -1
+	};
+
+	std::vector<Declaration> declarations;
+	std::vector<size_t> scope_starts;
+	std::vector<int> innermost; // by Symbol: index into 'declarations', or -1
+};
@@ -5,9 +5,13 @@ Semantic::Semantic(EnvStack env_stack, FunctionMemory& function_memory)
 	: function_memory(function_memory)
 {
 	this->env_stack = std::move(env_stack);
+	if (this->env_stack.envs.empty())
+	{
+		this->env_stack.Push(Environment()); // global scope
+	}
 }
 
-std::vector<std::string> Semantic::Analyse(std::vector<std::unique_ptr<AstNode>>& statements)
+std::vector<std::string> Semantic::Analyse(std::vector<AstNode*>& statements)
 {
 	for (auto& stmt : statements)
 	{
@@ -15,50 +19,48 @@ std::vector<std::string> Semantic::Analyse(std::vector<std::unique_ptr<AstNode>>
 		{
 			continue;
 		}
-		stmt->Accept(*this);
+		Dispatch(*this, *stmt);
 	}
 	return this->errors;
 }
 
-std::any Semantic::VisitBinaryExpression(BinaryExpression& binaryExpression)
+// Type of 'left op right': the operands' when an arithmetic operator
+// gets two numbers of one type, empty otherwise.
+static Value BinaryType(Token_t op, Value left, Value right)
 {
-	std::any left = binaryExpression.left->Accept(*this);
-	std::any right = binaryExpression.right->Accept(*this);
-	Token_t op = binaryExpression.op;
 	switch (op)
 	{
 		case PLUS_TOKEN:
 		case MINUS_TOKEN:
 		case STAR_TOKEN:
 		case SLASH_TOKEN:
-			if (left.type() == typeid(short) && right.type() == typeid(short))
-			{
-				return (short)1;
-			}
-			if (left.type() == typeid(int) && right.type() == typeid(int))
+			if (left.IsNumber() && left.type == right.type)
 			{
-				return (int)1;
-			}
-			if (left.type() == typeid(long) && right.type() == typeid(long))
-			{
-				return (long)1;
-			}
-			if (left.type() == typeid(float) && right.type() == typeid(float))
-			{
-				return (float)1;
-			}
-			if (left.type() == typeid(double) && right.type() == typeid(double))
-			{
-				return (double)1;
+				return left;
 			}
 
 			break;
 	}
 
-	return std::any();
+	return Value();
 }
 
-std::any Semantic::VisitBoolNode(BoolNode& boolNode)
+Value Semantic::VisitBinaryExpression(BinaryExpression& binaryExpression)
+{
+	size_t first = this->chain.size();
+	binaryExpression.Chain(this->chain);
+	Value left = Dispatch(*this, *this->chain[first]->left);
+	for (size_t i = first; i < this->chain.size(); i++)
+	{
+		BinaryExpression* node = this->chain[i];
+		Value right = Dispatch(*this, *node->right);
+		left = BinaryType(node->op, left, right);
+	}
+	this->chain.resize(first);
+	return left;
+}
+
+Value Semantic::VisitBoolNode(BoolNode& boolNode)
 {
 	bool v = boolNode.value;
 	if (not (v == false || v == true))
@@ -68,40 +70,23 @@ std::any Semantic::VisitBoolNode(BoolNode& boolNode)
 	return (bool)true;
 }
 
-std::any Semantic::VisitNumberNode(NumberNode& numberNode)
+Value Semantic::VisitNumberNode(NumberNode& numberNode)
 {
-	NUMBER_DT nn = numberNode.number;
-	if (std::holds_alternative<short>(nn))
-	{
-		return (short)1;
-	}
-	if (std::holds_alternative<int>(nn))
-	{
-		return (int)1;
-	}
-	if (std::holds_alternative<long>(nn))
+	if (numberNode.number.IsNumber())
 	{
-		return (long)1;
-	}
-	if (std::holds_alternative<float>(nn))
-	{
-		return (float)1;
-	}
-	if (std::holds_alternative<double>(nn))
-	{
-		return (double)1;
+		return numberNode.number;
 	}
 
 	Report("Number value is invalid.");
-	return std::any();
+	return Value();
 }
 
-std::any Semantic::VisitStringNode(StringNode& stringNode)
+Value Semantic::VisitStringNode(StringNode& stringNode)
 {
-	return stringNode.value;
+	return Value::String(stringNode.value);
 }
 
-std::any Semantic::VisitIdentifierNode(IdentifierNode& identifierNode)
+Value Semantic::VisitIdentifierNode(IdentifierNode& identifierNode)
 {
 	try
 	{
@@ -112,32 +97,35 @@ std::any Semantic::VisitIdentifierNode(IdentifierNode& identifierNode)
 	{
 		Report(e.what());
 	}
-	return std::any();
+	return Value();
 }
 
-std::any Semantic::VisitUnaryNode(UnaryNode& unaryNode)
+Value Semantic::VisitUnaryNode(UnaryNode& unaryNode)
 {
-	unaryNode.left->Accept(*this);
-	return std::any();
+	Dispatch(*this, *unaryNode.left);
+	return Value();
 }
 
-std::any Semantic::VisitIfStmtNode(IfStmtNode& ifStmtNode)
+Value Semantic::VisitIfStmtNode(IfStmtNode& ifStmtNode)
 {
-	return std::any();
+	return Value();
 }
 
-std::any Semantic::VisitPrintStmt(PrintStmtNode& printStmtNode)
+Value Semantic::VisitPrintStmt(PrintStmtNode& printStmtNode)
 {
-	printStmtNode.expression->Accept(*this);
-	return std::any();
+	Dispatch(*this, *printStmtNode.expression);
+	return Value();
 }
 
-std::any Semantic::VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode)
+Value Semantic::VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode)
 {
 	Variable var;
 	var.identifier = varDeclarationNode.identifier;
 	var.dtType = FromToken_tToDataType(varDeclarationNode.variableType);
-	var.value = varDeclarationNode.expression->Accept(*this);
+	if (varDeclarationNode.expression != nullptr)
+	{
+		var.value = Dispatch(*this, *varDeclarationNode.expression);
+	}
 	try
 	{
 		this->env_stack.Add(var);
@@ -146,12 +134,12 @@ std::any Semantic::VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNod
 	{
 		Report(e.what());
 	}
-	return std::any();
+	return Value();
 }
 
-std::any Semantic::VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode)
+Value Semantic::VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode)
 {
-	varAssignmentNode.expression->Accept(*this);
+	Dispatch(*this, *varAssignmentNode.expression);
 	try
 	{
 		return this->env_stack.Get(varAssignmentNode.identifier).first.dtType;
@@ -160,17 +148,17 @@ std::any Semantic::VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNo
 	{
 		Report(e.what());
 	}
-	return std::any();
+	return Value();
 }
 
-std::any Semantic::VisitFunctionCallNode(FunctionCallExpr& functionCallExpr)
+Value Semantic::VisitFunctionCallNode(FunctionCallExpr& functionCallExpr)
 {
-	return std::any();
+	return Value();
 }
 
-std::any Semantic::VisitBlockStmtNode(BlockStmtNode& blockStmtNode)
+Value Semantic::VisitBlockStmtNode(BlockStmtNode& blockStmtNode)
 {
-	return std::any();
+	return Value();
 }
 
 void Semantic::Report(std::string error)
@@ -6,32 +6,36 @@
 #include "variable.hpp"
 #include "functionmemory.hpp"
 
-class Semantic : public Visitor
+class Semantic final : public Visitor
 {
 public:
 	EnvStack env_stack;
 	FunctionMemory& function_memory;
 	Semantic(EnvStack env, FunctionMemory& function_memory);
 
-	std::vector<std::string> Analyse(std::vector<std::unique_ptr<AstNode>>& statements);
+	std::vector<std::string> Analyse(std::vector<AstNode*>& statements);
 
 
 private:
+	template <class V>
+	friend Value Dispatch(V& visitor, AstNode& node);
+
 	std::vector<std::string> errors;
 	void Report(std::string error);
+	std::vector<BinaryExpression*> chain; // BinaryExpression::Chain of the expressions being checked
 
-	std::any VisitBinaryExpression(BinaryExpression& binaryExpression);
-	std::any VisitBoolNode(BoolNode& boolNode);
-	std::any VisitNumberNode(NumberNode& numberNode);
-	std::any VisitStringNode(StringNode& stringNode);
-	std::any VisitIdentifierNode(IdentifierNode& identifierNode);
-	std::any VisitUnaryNode(UnaryNode& unaryNode);
+	Value VisitBinaryExpression(BinaryExpression& binaryExpression);
+	Value VisitBoolNode(BoolNode& boolNode);
+	Value VisitNumberNode(NumberNode& numberNode);
+	Value VisitStringNode(StringNode& stringNode);
+	Value VisitIdentifierNode(IdentifierNode& identifierNode);
+	Value VisitUnaryNode(UnaryNode& unaryNode);
 
-	std::any VisitIfStmtNode(IfStmtNode& ifStmtNode);
-	std::any VisitPrintStmt(PrintStmtNode& printStmtNode);
-	std::any VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode);
-	std::any VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode);
+	Value VisitIfStmtNode(IfStmtNode& ifStmtNode);
+	Value VisitPrintStmt(PrintStmtNode& printStmtNode);
+	Value VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode);
+	Value VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode);
 
-	std::any VisitFunctionCallNode(FunctionCallExpr& functionCallExpr);
-	std::any VisitBlockStmtNode(BlockStmtNode& blockStmtNode);
+	Value VisitFunctionCallNode(FunctionCallExpr& functionCallExpr);
+	Value VisitBlockStmtNode(BlockStmtNode& blockStmtNode);
 };
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include <ios>
+#include <utility>
+
+#include "sourcebuffer.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SOURCE_MMAP
+#endif
+
+SourceBuffer::SourceBuffer(std::string text)
+	: text(std::move(text))
+{
+}
+
+SourceBuffer::SourceBuffer(SourceBuffer&& other) noexcept
+	: text(std::move(other.text)), mapped(std::exchange(other.mapped, nullptr)), mapped_size(std::exchange(other.mapped_size, 0))
+{
+}
+
+SourceBuffer& SourceBuffer::operator=(SourceBuffer&& other) noexcept
+{
+	if (this != &other)
+	{
+		Release();
+		this->text = std::move(other.text);
+		this->mapped = std::exchange(other.mapped, nullptr);
+		this->mapped_size = std::exchange(other.mapped_size, 0);
+	}
+	return *this;
+}
+
+SourceBuffer::~SourceBuffer()
+{
+	Release();
+}
+
+void SourceBuffer::Release()
+{
+#if defined(SOURCE_MMAP)
+	if (this->mapped != nullptr)
+	{
+		munmap((void*)this->mapped, this->mapped_size);
+	}
+#endif
+	this->mapped = nullptr;
+	this->mapped_size = 0;
+}
+
+SourceBuffer SourceBuffer::Read(FILE* stream)
+{
+	SourceBuffer source;
+	size_t size = 0;
+	source.text.resize(4096);
+	while (true)
+	{
+		size += fread(&source.text[size], 1, source.text.size() - size, stream);
+		if (size < source.text.size())
+		{
+			break;
+		}
+		source.text.resize(source.text.size() * 2);
+	}
+	if (ferror(stream))
+	{
+		throw std::ios_base::failure("could not read the source");
+	}
+	source.text.resize(size);
+	return source;
+}
+
+SourceBuffer SourceBuffer::Open(const std::string& path)
+{
+	if (path == "-")
+	{
+		return Read(stdin);
+	}
+#if defined(SOURCE_MMAP)
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		throw std::ios_base::failure("file does not exist");
+	}
+	struct stat info;
+	if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+	{
+		void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED)
+		{
+			close(fd);
+			madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL); // the lexer reads front to back
+			SourceBuffer source;
+			source.mapped = (const char*)data;
+			source.mapped_size = (size_t)info.st_size;
+			return source;
+		}
+	}
+	// pipes, character devices, empty files, or a failed mapping
+	FILE* stream = fdopen(fd, "rb");
+	if (stream == nullptr)
+	{
+		close(fd);
+		throw std::ios_base::failure("could not read the source");
+	}
+#elif defined(_MSC_VER)
+	FILE* stream = nullptr;
+	if (fopen_s(&stream, path.c_str(), "rb") != 0)
+	{
+		throw std::ios_base::failure("file does not exist");
+	}
+#else
+	FILE* stream = fopen(path.c_str(), "rb");
+	if (stream == nullptr)
+	{
+		throw std::ios_base::failure("file does not exist");
+	}
+#endif
+	try
+	{
+		SourceBuffer source = Read(stream);
+		fclose(stream);
+		return source;
+	}
+	catch (...)
+	{
+		fclose(stream);
+		throw;
+	}
+}
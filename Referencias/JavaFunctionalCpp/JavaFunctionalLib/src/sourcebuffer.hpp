@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+// The text of a script, scanned in place by the Lexer and Parser. A regular
+// file is memory-mapped where the platform allows it, so loading costs one
+// page-cache mapping and no copy; pipes, stdin and other platforms fall back
+// to reading into an owned string. Move-only: the mapping is released once.
+class SourceBuffer
+{
+public:
+	SourceBuffer(std::string text = {});
+	SourceBuffer(SourceBuffer&& other) noexcept;
+	SourceBuffer& operator=(SourceBuffer&& other) noexcept;
+	SourceBuffer(const SourceBuffer&) = delete;
+	SourceBuffer& operator=(const SourceBuffer&) = delete;
+	~SourceBuffer();
+
+	static SourceBuffer Open(const std::string& path); // "-" reads stdin
+	static SourceBuffer Read(FILE* stream);
+
+	std::string_view Text() const
+	{
+		return this->mapped != nullptr ? std::string_view(this->mapped, this->mapped_size) : std::string_view(this->text);
+	}
+	bool IsMapped() const { return this->mapped != nullptr; }
+
+private:
+	void Release();
+
+	std::string text;
+	const char* mapped = nullptr;
+	size_t mapped_size = 0;
+};
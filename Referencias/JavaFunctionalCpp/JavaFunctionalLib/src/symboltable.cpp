@@ -0,0 +1,40 @@
+#include "symboltable.hpp"
+
+Symbol SymbolTable::Intern(std::string_view name)
+{
+	auto found = this->ids.find(name);
+	if (found != this->ids.end())
+	{
+		return found->second;
+	}
+	Symbol symbol = (Symbol)this->names.size();
+	std::string_view stored = this->text.CopyString(name);
+	this->names.push_back(stored);
+	this->ids.emplace(stored, symbol);
+	return symbol;
+}
+
+std::string_view SymbolTable::Name(Symbol symbol) const
+{
+	if (symbol >= this->names.size())
+	{
+		return "";
+	}
+	return this->names[symbol];
+}
+
+size_t SymbolTable::Size() const
+{
+	return this->names.size();
+}
+
+SymbolTable& Symbols()
+{
+	static SymbolTable symbols;
+	return symbols;
+}
+
+std::string SymbolName(Symbol symbol)
+{
+	return std::string(Symbols().Name(symbol));
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "arena.hpp"
+
+// Dense id of an interned identifier.
+typedef uint32_t Symbol;
+
+static const Symbol NO_SYMBOL = UINT32_MAX;
+
+// Interns identifier text. The Lexer gives every distinct name a Symbol the
+// first time it is seen; from then on tokens, nodes, variables and every
+// scope or function map carry the 4-byte id, so names are compared and
+// hashed as integers and their text is stored once. Names are never
+// removed, which keeps ids valid across Programs. Not thread-safe.
+class SymbolTable
+{
+public:
+	Symbol Intern(std::string_view name);
+	std::string_view Name(Symbol symbol) const;
+	size_t Size() const;
+
+private:
+	Arena text; // owns the characters the views below point to
+	std::vector<std::string_view> names;
+	std::unordered_map<std::string_view, Symbol> ids;
+};
+
+// The process-wide table every stage interns into.
+SymbolTable& Symbols();
+
+// Name of 'symbol' as a string, for building messages.
+std::string SymbolName(Symbol symbol);
@@ -1,22 +1,33 @@
 #pragma once
+#include <cstdint>
 #include <iostream>
+#include <string_view>
+#include <type_traits>
 
+#include "symboltable.hpp"
 #include "token.hpp"
 
+// A token is a view into the source buffer it was lexed from (the Parser
+// keeps that buffer alive), so tokens are copied and stored without owning
+// or allocating anything. Lines and columns are not tracked per token; a
+// LineTable derives them from 'pos' when a diagnostic needs one.
+// Identifiers also carry their interned Symbol.
 class SyntaxToken
 {
 public:
-	SyntaxToken(Token_t token_t, std::string value, size_t pos, unsigned int row, size_t len);
-	Token_t GetToken_t();
-	std::string GetValue();
-	size_t GetPos();
-	unsigned int GetRow();
-	size_t GetLen();
+	SyntaxToken(Token_t token_t, std::string_view value, size_t pos, size_t len, Symbol symbol = NO_SYMBOL)
+		: value(value), token_t(token_t), pos((uint32_t)pos), len((uint32_t)len), symbol(symbol) {}
+	Token_t GetToken_t() const { return this->token_t; }
+	std::string_view GetValue() const { return this->value; }
+	size_t GetPos() const { return this->pos; }
+	size_t GetLen() const { return this->len; }
+	Symbol GetSymbol() const { return this->symbol; } // IDENTIFIER_TOKEN only
 private:
+	std::string_view value;
 	Token_t token_t;
-	std::string value;
-	size_t pos;
-	unsigned int row;
-	size_t len;
+	uint32_t pos;
+	uint32_t len;
+	Symbol symbol;
 };
 
+static_assert(std::is_trivially_copyable_v<SyntaxToken>, "tokens must stay plain views");
@@ -39,7 +39,7 @@ std::string TokenName(Token_t token)
 	return "Invalid Token";
 }
 
-std::string DisplayToken(Token_t token)
+std::string_view DisplayToken(Token_t token)
 {
 	switch (token)
 	{
@@ -86,7 +86,7 @@ std::string DisplayToken(Token_t token)
 		case RETURN_KW:
 			return "return";
 	}
-	return TokenName(token) + " not found";
+	return "";
 }
 
 unsigned short GetUnaryOperatorPrecedence(Token_t unary_op)
@@ -1,5 +1,8 @@
 #pragma once
+#include <cstdint>
+#include <initializer_list>
 #include <iostream>
+#include <string_view>
 
 enum Token_t
 {
@@ -57,8 +60,33 @@ enum Token_t
 	END_OF_FILE_TOKEN
 };
 
+// A set of token kinds as one bitmask, built at compile time, so testing a
+// token against several kinds is a shift and a mask.
+class TokenSet
+{
+public:
+	constexpr TokenSet(std::initializer_list<Token_t> tokens)
+	{
+		for (Token_t token : tokens)
+		{
+			this->bits |= uint64_t(1) << token;
+		}
+	}
+	constexpr bool Contains(Token_t token) const
+	{
+		return (this->bits >> token) & 1;
+	}
+
+private:
+	uint64_t bits = 0;
+};
+
+static_assert(END_OF_FILE_TOKEN < 64, "TokenSet keeps one bit per Token_t");
+
+constexpr TokenSet TYPE_TOKENS = { BOOL_TYPE, SHORT_TYPE, INT_TYPE, LONG_TYPE, FLOAT_TYPE, DOUBLE_TYPE };
+
 std::string TokenName(Token_t token);
-std::string DisplayToken(Token_t token);
+std::string_view DisplayToken(Token_t token);
 
 unsigned short GetUnaryOperatorPrecedence(Token_t unary_op);
 unsigned short GetBinaryOperatorPrecedence(Token_t binary_op);
\ No newline at end of file
@@ -0,0 +1,271 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "tokenbuffer.hpp"
+
+LineTable::LineTable(std::string_view source)
+{
+	this->source = source;
+}
+
+SourceLocation LineTable::Locate(size_t offset)
+{
+	if (this->line_starts.empty())
+	{
+		this->line_starts.push_back(0);
+		const char* data = this->source.data();
+		const char* end = data + this->source.size();
+		for (const char* p = data; (p = (const char*)std::memchr(p, '\n', end - p)) != nullptr; p++)
+		{
+			this->line_starts.push_back((uint32_t)(p - data + 1));
+		}
+	}
+	// last line start at or before 'offset'
+	auto line = std::upper_bound(this->line_starts.begin(), this->line_starts.end(), (uint32_t)offset) - 1;
+	return { (uint32_t)(line - this->line_starts.begin() + 1), (uint32_t)(offset - *line + 1) };
+}
+
+std::string LineTable::Describe(size_t offset)
+{
+	SourceLocation location = Locate(offset);
+	return "line " + std::to_string(location.line) + ", column " + std::to_string(location.column);
+}
+
+TokenBuffer::TokenBuffer(std::string_view source)
+	: lines(source)
+{
+	this->source = source;
+}
+
+void TokenBuffer::Push(const SyntaxToken& token)
+{
+	size_t index = this->kinds.size();
+	uint32_t offset = (uint32_t)token.GetPos();
+	uint32_t length = (uint32_t)token.GetLen();
+	if (index % BLOCK == 0)
+	{
+		this->blocks.push_back({ offset, (uint32_t)this->payloads.size(), 0 });
+	}
+	Block& block = this->blocks.back();
+
+	this->kinds.push_back((uint8_t)token.GetToken_t());
+	if (offset - block.offset < FAR_OFFSET)
+	{
+		this->deltas.push_back((uint16_t)(offset - block.offset));
+	}
+	else
+	{
+		this->deltas.push_back(FAR_OFFSET);
+		this->far_offsets.push_back({ (uint32_t)index, offset });
+	}
+	if (length < LONG_LENGTH)
+	{
+		this->lengths.push_back((uint8_t)length);
+	}
+	else
+	{
+		this->lengths.push_back(LONG_LENGTH);
+		this->long_lengths.push_back({ (uint32_t)index, length });
+	}
+	if (token.GetToken_t() == IDENTIFIER_TOKEN || token.GetToken_t() == NUMBER_LITERAL_TOKEN)
+	{
+		block.has_payload |= uint64_t(1) << (index % BLOCK);
+		this->payloads.push_back(token.GetSymbol());
+	}
+}
+
+void TokenBuffer::PushNumber(const NumberLiteral& number)
+{
+	if (not number.is_floating && number.integer_fits && number.integer >= 0 && number.integer < NUMBER_INDEX)
+	{
+		this->payloads.back() = (uint32_t)number.integer;
+		return;
+	}
+	PackedNumber packed;
+	packed.integer = number.integer_fits ? number.integer : INT64_MIN;
+	packed.real = number.real_fits ? number.real : HUGE_VAL;
+	this->payloads.back() = NUMBER_INDEX | (uint32_t)this->numbers.size();
+	this->numbers.push_back(packed);
+}
+
+void TokenBuffer::Reserve(size_t count)
+{
+	this->kinds.reserve(count);
+	this->lengths.reserve(count);
+	this->deltas.reserve(count);
+	this->blocks.reserve((count + BLOCK - 1) / BLOCK);
+}
+
+void TokenBuffer::ShrinkToFit()
+{
+	this->kinds.shrink_to_fit();
+	this->lengths.shrink_to_fit();
+	this->deltas.shrink_to_fit();
+	this->blocks.shrink_to_fit();
+	this->payloads.shrink_to_fit();
+	this->numbers.shrink_to_fit();
+	this->far_offsets.shrink_to_fit();
+	this->long_lengths.shrink_to_fit();
+}
+
+void TokenBuffer::Resize(std::vector<TokenChunk>& chunks)
+{
+	size_t count = 0;
+	size_t payload_count = 0;
+	size_t number_count = 0;
+	for (TokenChunk& chunk : chunks)
+	{
+		const TokenBuffer& other = chunk.tokens;
+		chunk.start = count;
+		chunk.first_payload = payload_count;
+		chunk.first_number = number_count;
+		count += chunk.count;
+		payload_count += chunk.count == other.Size() ? other.payloads.size() : other.PayloadRank(chunk.count);
+		number_count += other.numbers.size();
+		for (auto [index, length] : other.long_lengths)
+		{
+			if (index < chunk.count)
+			{
+				this->long_lengths.push_back({ (uint32_t)(chunk.start + index), length });
+			}
+		}
+	}
+	this->kinds.resize(count);
+	this->lengths.resize(count);
+	this->deltas.resize(count);
+	this->blocks.resize((count + BLOCK - 1) / BLOCK);
+	this->payloads.resize(payload_count);
+	this->numbers.resize(number_count);
+
+	// Blocks move, so which offsets are far changes. Only a block spanning
+	// 64 KB of source can hold one, and those are rare enough to scan here.
+	size_t chunk = 0;
+	auto offset = [&](size_t index)
+	{
+		while (index >= chunks[chunk].start + chunks[chunk].count)
+		{
+			chunk++;
+		}
+		return chunks[chunk].tokens.Offset(index - chunks[chunk].start);
+	};
+	for (size_t first = 0; first < count; first += BLOCK)
+	{
+		size_t end = std::min(first + BLOCK, count);
+		uint32_t block_offset = offset(first);
+		size_t first_chunk = chunk;
+		if (offset(end - 1) - block_offset < FAR_OFFSET)
+		{
+			continue;
+		}
+		chunk = first_chunk;
+		for (size_t index = first + 1; index < end; index++)
+		{
+			uint32_t token_offset = offset(index);
+			if (token_offset - block_offset >= FAR_OFFSET)
+			{
+				this->far_offsets.push_back({ (uint32_t)index, token_offset });
+			}
+		}
+	}
+}
+
+void TokenBuffer::Place(const std::vector<TokenChunk>& chunks, size_t chunk)
+{
+	const TokenChunk& own = chunks[chunk];
+	size_t from = (own.start + BLOCK - 1) / BLOCK * BLOCK;
+	size_t to = std::min((own.start + own.count + BLOCK - 1) / BLOCK * BLOCK, Size());
+	std::copy(own.tokens.numbers.begin(), own.tokens.numbers.end(), this->numbers.begin() + own.first_number);
+	if (from >= to)
+	{
+		return;
+	}
+
+	// the blocks' tokens, a run from each chunk they cover
+	size_t payload = own.first_payload + own.tokens.PayloadRank(from - own.start);
+	for (size_t index = from, source = chunk; index < to; source++)
+	{
+		const TokenChunk& other = chunks[source];
+		size_t local = index - other.start;
+		size_t end = std::min(to, other.start + other.count);
+		if (end == index)
+		{
+			continue;
+		}
+		std::copy_n(other.tokens.kinds.begin() + local, end - index, this->kinds.begin() + index);
+		std::copy_n(other.tokens.lengths.begin() + local, end - index, this->lengths.begin() + index);
+		size_t other_payload = other.tokens.PayloadRank(local);
+		for (; index < end; index++, local++)
+		{
+			uint32_t offset = other.tokens.Offset(local);
+			if (index % BLOCK == 0)
+			{
+				this->blocks[index / BLOCK] = { offset, (uint32_t)payload, 0 };
+			}
+			Block& block = this->blocks[index / BLOCK];
+			this->deltas[index] = offset - block.offset < FAR_OFFSET ? (uint16_t)(offset - block.offset) : FAR_OFFSET;
+
+			Token_t kind = (Token_t)this->kinds[index];
+			if (kind == IDENTIFIER_TOKEN || kind == NUMBER_LITERAL_TOKEN)
+			{
+				uint32_t value = other.tokens.payloads[other_payload++];
+				if (kind == IDENTIFIER_TOKEN)
+				{
+					value = other.symbols[value];
+				}
+				else if ((value & NUMBER_INDEX) != 0)
+				{
+					value += (uint32_t)other.first_number;
+				}
+				block.has_payload |= uint64_t(1) << (index % BLOCK);
+				this->payloads[payload++] = value;
+			}
+		}
+	}
+}
+
+uint32_t TokenBuffer::Overflow(const OverflowTable& table, size_t index)
+{
+	auto entry = std::lower_bound(table.begin(), table.end(), std::pair<uint32_t, uint32_t>((uint32_t)index, 0));
+	return entry->second;
+}
+
+NumberLiteral TokenBuffer::Number(size_t index) const
+{
+	uint32_t payload = Payload(index);
+	NumberLiteral number;
+	if ((payload & NUMBER_INDEX) == 0)
+	{
+		number.integer = payload;
+		number.real = payload;
+		return number;
+	}
+	const PackedNumber& packed = this->numbers[payload & ~NUMBER_INDEX];
+	number.is_floating = Text(index).find('.') != std::string_view::npos;
+	number.integer_fits = packed.integer != INT64_MIN;
+	number.real_fits = packed.real != HUGE_VAL;
+	number.integer = number.integer_fits ? packed.integer : 0;
+	number.real = number.real_fits ? packed.real : 0;
+	return number;
+}
+
+SourceLocation TokenBuffer::Locate(size_t index)
+{
+	return this->lines.Locate(Offset(index));
+}
+
+std::string TokenBuffer::Describe(size_t index)
+{
+	return this->lines.Describe(Offset(index));
+}
+
+size_t TokenBuffer::BytesUsed() const
+{
+	return this->kinds.capacity() * sizeof(uint8_t) +
+		this->lengths.capacity() * sizeof(uint8_t) +
+		this->deltas.capacity() * sizeof(uint16_t) +
+		this->blocks.capacity() * sizeof(Block) +
+		this->payloads.capacity() * sizeof(uint32_t) +
+		this->numbers.capacity() * sizeof(PackedNumber) +
+		(this->far_offsets.capacity() + this->long_lengths.capacity()) * sizeof(std::pair<uint32_t, uint32_t>);
+}
@@ -0,0 +1,194 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "syntaxtoken.hpp"
+#include "token.hpp"
+
+// 1-based position of a byte in the source, for diagnostics.
+struct SourceLocation
+{
+	uint32_t line;
+	uint32_t column;
+};
+
+// A number literal decoded by the Lexer (digits with an optional fraction).
+// 'integer' is the integer part, 'real' the whole value; the parser narrows
+// one of them to the literal's target type.
+struct NumberLiteral
+{
+	bool is_floating = false;  // written with a '.'
+	bool integer_fits = true;  // integer part fits in a long long
+	bool real_fits = true;     // value fits in a double
+	long long integer = 0;
+	double real = 0;
+};
+
+// Maps byte offsets to line/column. The table of line starts is only built
+// on the first lookup, so a clean parse never pays for it.
+class LineTable
+{
+public:
+	LineTable(std::string_view source = {});
+
+	SourceLocation Locate(size_t offset);
+	std::string Describe(size_t offset); // "line L, column C"
+
+private:
+	std::string_view source;
+	std::vector<uint32_t> line_starts;
+};
+
+// Leaves the elements resize() adds uninitialised, so that sizing a
+// buffer for TokenBuffer::Place() does not write the memory first: the
+// workers that fill it are the first to touch it.
+template <class T>
+struct UninitializedAllocator : std::allocator<T>
+{
+	template <class U>
+	struct rebind
+	{
+		using other = UninitializedAllocator<U>;
+	};
+
+	template <class U>
+	void construct(U* p) noexcept
+	{
+		::new ((void*)p) U;
+	}
+	template <class U, class... Args>
+	void construct(U* p, Args&&... args)
+	{
+		::new ((void*)p) U(std::forward<Args>(args)...);
+	}
+};
+
+template <class T>
+using TokenArray = std::vector<T, UninitializedAllocator<T>>;
+
+struct TokenChunk;
+
+// The lexed token stream as parallel arrays, packed for large inputs. Per
+// token there is one byte of kind, one of length and a 16-bit offset from
+// the start of its block of 64 tokens: 4 bytes. Only identifiers and number
+// literals have a payload (4 bytes), found through a per-block count and
+// bit mask; a number literal's payload is its value when it is an integer
+// below 2^31, else the index of a 16-byte packed literal. Offsets and
+// lengths that do not fit go to sorted side tables. Token text is recovered
+// from the source on demand and SyntaxToken views are built only when asked
+// for, so the parser's cursor walks a dense array of kinds.
+class TokenBuffer
+{
+public:
+	TokenBuffer(std::string_view source = {});
+
+	void Push(const SyntaxToken& token);
+	void PushNumber(const NumberLiteral& number); // payload of the last pushed token
+	void Reserve(size_t count);
+	void ShrinkToFit(); // once the last token is pushed
+
+	// Stitching buffers lexed separately: Resize() lays the chunks out one
+	// after another and makes room for all their tokens, then Place() fills
+	// the blocks of 64 tokens that start in chunk 'chunk', reading on into
+	// the next chunks where a block straddles them. Place() calls for
+	// different chunks may run concurrently.
+	void Resize(std::vector<TokenChunk>& chunks);
+	void Place(const std::vector<TokenChunk>& chunks, size_t chunk);
+
+	size_t Size() const { return this->kinds.size(); }
+	Token_t Kind(size_t index) const { return (Token_t)this->kinds[index]; }
+	uint32_t Offset(size_t index) const
+	{
+		uint16_t delta = this->deltas[index];
+		return delta != FAR_OFFSET ? this->blocks[index / BLOCK].offset + delta : Overflow(this->far_offsets, index);
+	}
+	uint32_t Length(size_t index) const
+	{
+		uint8_t length = this->lengths[index];
+		return length != LONG_LENGTH ? length : Overflow(this->long_lengths, index);
+	}
+	std::string_view Text(size_t index) const
+	{
+		return std::string_view(this->source.data() + Offset(index), Length(index));
+	}
+	Symbol Identifier(size_t index) const { return Payload(index); } // IDENTIFIER_TOKEN only
+	SyntaxToken At(size_t index) const
+	{
+		Symbol symbol = Kind(index) == IDENTIFIER_TOKEN ? Payload(index) : NO_SYMBOL;
+		return SyntaxToken(Kind(index), Text(index), Offset(index), Length(index), symbol);
+	}
+
+	NumberLiteral Number(size_t index) const; // NUMBER_LITERAL_TOKEN only
+
+	SourceLocation Locate(size_t index);
+	std::string Describe(size_t index);
+	size_t BytesUsed() const;
+
+private:
+	friend class TokenStream; // reads 'kinds' in place
+
+	static constexpr size_t BLOCK = 64;
+	static constexpr uint16_t FAR_OFFSET = UINT16_MAX;
+	static constexpr uint8_t LONG_LENGTH = UINT8_MAX;
+	static constexpr uint32_t NUMBER_INDEX = 1u << 31; // payload bit: index into 'numbers'
+
+	struct Block
+	{
+		uint32_t offset;         // of the block's first token
+		uint32_t first_payload;  // payloads of earlier blocks
+		uint64_t has_payload;    // bit per token of the block
+	};
+
+	// A NumberLiteral without its flags: an integer part that does not fit
+	// is INT64_MIN, a value that does not fit a double is infinity, and
+	// 'is_floating' is a '.' in the token text.
+	struct PackedNumber
+	{
+		long long integer;
+		double real;
+	};
+
+	// Index and value of the tokens whose offset or length did not fit.
+	using OverflowTable = std::vector<std::pair<uint32_t, uint32_t>>;
+	static uint32_t Overflow(const OverflowTable& table, size_t index);
+
+	// Index in 'payloads' of the first payload at or after token 'index'.
+	size_t PayloadRank(size_t index) const
+	{
+		const Block& block = this->blocks[index / BLOCK];
+		uint64_t before = block.has_payload & ((uint64_t(1) << (index % BLOCK)) - 1);
+		return block.first_payload + std::popcount(before);
+	}
+	uint32_t Payload(size_t index) const { return this->payloads[PayloadRank(index)]; }
+
+	std::string_view source;
+	TokenArray<uint8_t> kinds;
+	TokenArray<uint8_t> lengths;
+	TokenArray<uint16_t> deltas;
+	std::vector<Block> blocks;
+	TokenArray<uint32_t> payloads;
+	std::vector<PackedNumber> numbers;
+	OverflowTable far_offsets;
+	OverflowTable long_lengths;
+	LineTable lines;
+};
+
+// A buffer lexed from one chunk of the source, with its identifiers
+// interned into a table of its own, and where TokenBuffer::Resize() put it.
+struct TokenChunk
+{
+	TokenBuffer tokens;
+	size_t count = 0;            // tokens taken from it
+	std::vector<Symbol> symbols; // global Symbol of each of its own
+	size_t start = 0;            // first token, payload and number literal in the whole buffer
+	size_t first_payload = 0;
+	size_t first_number = 0;
+};
+
+static_assert(END_OF_FILE_TOKEN <= UINT8_MAX, "token kinds are stored in one byte");
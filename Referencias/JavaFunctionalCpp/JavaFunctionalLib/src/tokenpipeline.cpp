@@ -0,0 +1,88 @@
+#include "tokenpipeline.hpp"
+
+TokenPipeline::TokenPipeline(std::string_view source)
+	: source(source), lexer(source, 0, symbols), slots(SLOTS)
+{
+	this->producer = std::thread(&TokenPipeline::Produce, this);
+}
+
+TokenPipeline::~TokenPipeline()
+{
+	this->stop.store(true, std::memory_order_relaxed);
+	this->producer.join();
+}
+
+void TokenPipeline::Produce()
+{
+	bool finished = false;
+	size_t head = 0;
+	while (not finished)
+	{
+		if (head - this->tail.load(std::memory_order_acquire) == SLOTS)
+		{
+			this->lexer_stalls.fetch_add(1, std::memory_order_relaxed);
+			while (head - this->tail.load(std::memory_order_acquire) == SLOTS)
+			{
+				if (this->stop.load(std::memory_order_relaxed))
+				{
+					return;
+				}
+				std::this_thread::yield();
+			}
+		}
+
+		TokenBatch& batch = this->slots[head & (SLOTS - 1)];
+		batch.count = 0;
+		while (batch.count < TokenBatch::CAPACITY && not finished)
+		{
+			SyntaxToken token = this->lexer.Lex();
+			size_t i = batch.count++;
+			batch.kinds[i] = (uint8_t)token.GetToken_t();
+			batch.offsets[i] = (uint32_t)token.GetPos();
+			batch.lengths[i] = (uint32_t)token.GetLen();
+			batch.payloads[i] = token.GetSymbol();
+			if (token.GetToken_t() == NUMBER_LITERAL_TOKEN)
+			{
+				batch.numbers[i] = this->lexer.GetNumber();
+			}
+			finished = token.GetToken_t() == END_OF_FILE_TOKEN || token.GetToken_t() == BAD_TOKEN;
+		}
+		this->head.store(++head, std::memory_order_release);
+	}
+}
+
+const TokenBatch& TokenPipeline::Acquire()
+{
+	size_t tail = this->tail.load(std::memory_order_relaxed);
+	if (this->head.load(std::memory_order_acquire) == tail)
+	{
+		this->parser_stalls.fetch_add(1, std::memory_order_relaxed);
+		while (this->head.load(std::memory_order_acquire) == tail)
+		{
+			std::this_thread::yield();
+		}
+	}
+	return this->slots[tail & (SLOTS - 1)];
+}
+
+void TokenPipeline::Release()
+{
+	this->tail.store(this->tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// Only called once the batch holding the final token was acquired: the
+// producer wrote its reports before publishing that batch and never
+// touches them again.
+std::vector<std::string> TokenPipeline::GetErrorReports()
+{
+	return this->lexer.GetErrorReports();
+}
+
+PipelineStats TokenPipeline::GetStats()
+{
+	PipelineStats stats;
+	stats.batches = this->head.load(std::memory_order_acquire);
+	stats.lexer_stalls = this->lexer_stalls.load(std::memory_order_relaxed);
+	stats.parser_stalls = this->parser_stalls.load(std::memory_order_relaxed);
+	return stats;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "lexer.hpp"
+#include "symboltable.hpp"
+#include "tokenbuffer.hpp"
+
+// A run of tokens handed from the lexer thread to the parser. Identifier
+// payloads are Symbols of the lexer thread's private table; number
+// literals are stored at their token's position.
+struct TokenBatch
+{
+	static const size_t CAPACITY = 512;
+
+	size_t count = 0;
+	uint8_t kinds[CAPACITY];
+	uint32_t offsets[CAPACITY];
+	uint32_t lengths[CAPACITY];
+	uint32_t payloads[CAPACITY];
+	NumberLiteral numbers[CAPACITY];
+};
+
+struct PipelineStats
+{
+	size_t batches = 0;
+	size_t lexer_stalls = 0;  // the ring was full, the lexer waited for the parser
+	size_t parser_stalls = 0; // the ring was empty, the parser waited for the lexer
+};
+
+// Runs a Lexer on its own thread, publishing TokenBatches into a
+// single-producer/single-consumer ring of SLOTS batches. The indices are
+// the only shared state: the producer owns 'head', the consumer 'tail',
+// and each publishes with a release store the other reads with acquire.
+// A waiting side yields its time slice and counts one stall per wait.
+//
+// The global SymbolTable is not touched from the lexer thread; the
+// consumer re-interns identifiers itself (see TokenStream).
+class TokenPipeline
+{
+public:
+	static const size_t SLOTS = 16; // power of two
+
+	TokenPipeline(std::string_view source);
+	TokenPipeline(const TokenPipeline&) = delete;
+	TokenPipeline& operator=(const TokenPipeline&) = delete;
+	~TokenPipeline(); // stops the lexer thread if the parser quit early
+
+	// Consumer side. Acquire() blocks for the next batch; Release() hands
+	// the acquired batch back to the producer.
+	const TokenBatch& Acquire();
+	void Release();
+
+	// The lexer's reports; complete once the final token has been acquired.
+	std::vector<std::string> GetErrorReports();
+	bool HasErrors() const { return this->lexer.HasErrors(); } // same condition
+	PipelineStats GetStats();
+
+private:
+	void Produce();
+
+	std::string_view source;
+	SymbolTable symbols; // the lexer thread's private table
+	Lexer lexer;
+	std::vector<TokenBatch> slots;
+	alignas(64) std::atomic<size_t> head{ 0 }; // batches published
+	alignas(64) std::atomic<size_t> tail{ 0 }; // batches released
+	std::atomic<bool> stop{ false };
+	std::atomic<size_t> lexer_stalls{ 0 };
+	std::atomic<size_t> parser_stalls{ 0 };
+	std::thread producer;
+};
@@ -0,0 +1,148 @@
+#include <stdexcept>
+
+#include "tokenstream.hpp"
+
+TokenStream::TokenStream(std::string_view source, bool pipelined)
+	: lexer(source), lines(source)
+{
+	this->source = source;
+	if (pipelined)
+	{
+		this->pipeline = std::make_unique<TokenPipeline>(source);
+	}
+}
+
+void TokenStream::UseBuffer(const TokenBuffer& buffer)
+{
+	this->buffer = &buffer;
+	this->source = buffer.source;
+	this->lines = LineTable(buffer.source);
+	this->kind_data = buffer.kinds.data();
+	this->window = SIZE_MAX;
+	this->mask = SIZE_MAX;
+	this->lexed = buffer.Size();
+	this->finished = true;
+}
+
+void TokenStream::Restart()
+{
+	this->buffer = nullptr;
+	this->kind_data = this->kinds;
+	this->window = WINDOW;
+	this->mask = WINDOW - 1;
+	this->lexer = Lexer(this->source);
+	this->lexed = 0;
+	this->finished = false;
+}
+
+void TokenStream::Store(Token_t kind, uint32_t offset, uint32_t length, uint32_t payload, const NumberLiteral& number)
+{
+	size_t slot = this->lexed & (WINDOW - 1);
+	this->kinds[slot] = (uint8_t)kind;
+	this->offsets[slot] = offset;
+	this->lengths[slot] = length;
+	this->payloads[slot] = payload;
+	if (kind == NUMBER_LITERAL_TOKEN)
+	{
+		this->numbers[slot] = number;
+	}
+	this->lexed++;
+	this->finished = kind == END_OF_FILE_TOKEN || kind == BAD_TOKEN;
+}
+
+void TokenStream::Fill(size_t index)
+{
+	if (this->pipeline != nullptr)
+	{
+		FillFromPipeline(index);
+		return;
+	}
+	while (not this->finished && this->lexed <= index)
+	{
+		SyntaxToken token = this->lexer.Lex();
+		Store(token.GetToken_t(), (uint32_t)token.GetPos(), (uint32_t)token.GetLen(), token.GetSymbol(), this->lexer.GetNumber());
+	}
+}
+
+// The lexer thread numbers identifiers in first-seen order, so a pipeline
+// Symbol not mapped yet is always the next one and is interned here, on
+// the parser's thread, from the token text.
+void TokenStream::FillFromPipeline(size_t index)
+{
+	while (not this->finished && this->lexed <= index)
+	{
+		if (this->batch == nullptr || this->batch_position == this->batch->count)
+		{
+			if (this->batch != nullptr)
+			{
+				this->pipeline->Release();
+			}
+			this->batch = &this->pipeline->Acquire();
+			this->batch_position = 0;
+		}
+		size_t i = this->batch_position++;
+		Token_t kind = (Token_t)this->batch->kinds[i];
+		uint32_t payload = this->batch->payloads[i];
+		if (kind == IDENTIFIER_TOKEN)
+		{
+			if (payload == this->global_symbols.size())
+			{
+				std::string_view text = this->source.substr(this->batch->offsets[i], this->batch->lengths[i]);
+				this->global_symbols.push_back(Symbols().Intern(text));
+			}
+			payload = this->global_symbols[payload];
+		}
+		Store(kind, this->batch->offsets[i], this->batch->lengths[i], payload, this->batch->numbers[i]);
+	}
+}
+
+size_t TokenStream::SlowSlot(size_t index)
+{
+	Fill(index);
+	if (index >= this->lexed)
+	{
+		index = this->lexed - 1; // the final token
+	}
+	if (this->lexed - index > this->window)
+	{
+		throw std::invalid_argument("Token " + std::to_string(index) + " has left the lookahead window");
+	}
+	return index & this->mask; // the ring, or a whole TokenBuffer
+}
+
+std::string TokenStream::Describe(size_t index)
+{
+	size_t slot = Slot(index);
+	return this->lines.Describe(this->buffer != nullptr ? this->buffer->Offset(slot) : this->offsets[slot]);
+}
+
+std::vector<std::string> TokenStream::GetErrorReports()
+{
+	if (this->pipeline != nullptr)
+	{
+		// the lexer thread's reports are only safe to read once it is done
+		return this->finished ? this->pipeline->GetErrorReports() : std::vector<std::string>();
+	}
+	return this->lexer.GetErrorReports();
+}
+
+bool TokenStream::HasErrors() const
+{
+	if (this->pipeline != nullptr)
+	{
+		return this->finished && this->pipeline->HasErrors();
+	}
+	return this->lexer.HasErrors();
+}
+
+PipelineStats TokenStream::GetPipelineStats()
+{
+	return this->pipeline != nullptr ? this->pipeline->GetStats() : PipelineStats();
+}
+
+size_t TokenStream::BytesUsed() const
+{
+	size_t ring = this->pipeline != nullptr ? TokenPipeline::SLOTS * sizeof(TokenBatch) : 0;
+	return sizeof(this->kinds) + sizeof(this->offsets) + sizeof(this->lengths) +
+		sizeof(this->payloads) + sizeof(this->numbers) + ring;
+}
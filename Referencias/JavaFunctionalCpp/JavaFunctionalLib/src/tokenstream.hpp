@@ -0,0 +1,118 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "lexer.hpp"
+#include "syntaxtoken.hpp"
+#include "tokenbuffer.hpp"
+#include "tokenpipeline.hpp"
+
+// Tokens pulled from the Lexer on demand. Only the last WINDOW tokens are
+// kept, in a ring indexed by absolute token position, which covers the
+// Parser's LookAhead(-2..+2) plus one Back(). Memory stays bounded by the
+// window however long the source is. Asking past the end returns the final
+// END_OF_FILE_TOKEN or BAD_TOKEN.
+//
+// When pipelined, the Lexer runs ahead on its own thread (TokenPipeline)
+// and the window is refilled from its batches. UseBuffer() instead reads
+// an already lexed TokenBuffer with random access, for parsers that jump
+// around the token array.
+class TokenStream
+{
+public:
+	static const size_t WINDOW = 8; // power of two
+
+	TokenStream(std::string_view source, bool pipelined = false);
+	TokenStream(const TokenStream&) = delete; // the lexer points into 'source'
+	TokenStream& operator=(const TokenStream&) = delete;
+
+	bool Has(size_t index) // lexes up to 'index'; false past the final token
+	{
+		if (index >= this->lexed)
+		{
+			Fill(index);
+		}
+		return index < this->lexed;
+	}
+	Token_t Kind(size_t index) { return (Token_t)this->kind_data[Slot(index)]; }
+	SyntaxToken At(size_t index)
+	{
+		size_t slot = Slot(index);
+		if (this->buffer != nullptr)
+		{
+			return this->buffer->At(slot);
+		}
+		return SyntaxToken((Token_t)this->kinds[slot], SlotText(slot), this->offsets[slot], this->lengths[slot], this->payloads[slot]);
+	}
+	std::string_view Text(size_t index)
+	{
+		size_t slot = Slot(index);
+		return this->buffer != nullptr ? this->buffer->Text(slot) : SlotText(slot);
+	}
+	Symbol Identifier(size_t index) // IDENTIFIER_TOKEN only
+	{
+		size_t slot = Slot(index);
+		return this->buffer != nullptr ? this->buffer->Identifier(slot) : this->payloads[slot];
+	}
+	NumberLiteral Number(size_t index)
+	{
+		size_t slot = Slot(index);
+		return this->buffer != nullptr ? this->buffer->Number(slot) : this->numbers[slot];
+	}
+
+	void UseBuffer(const TokenBuffer& buffer); // 'buffer' must outlive the stream
+	void Restart(); // back to lexing from the start of the source
+
+	std::string Describe(size_t index);
+	std::vector<std::string> GetErrorReports();
+	bool HasErrors() const; // GetErrorReports() is not empty, without the copy
+	size_t Lexed() const { return this->lexed; }
+	PipelineStats GetPipelineStats(); // all zero unless pipelined
+	size_t BytesUsed() const;
+
+private:
+	void Fill(size_t index);
+	void FillFromPipeline(size_t index);
+	void Store(Token_t kind, uint32_t offset, uint32_t length, uint32_t payload, const NumberLiteral& number);
+	size_t Slot(size_t index)
+	{
+		if (index < this->lexed && this->lexed - index <= this->window)
+		{
+			return index & this->mask;
+		}
+		return SlowSlot(index);
+	}
+	size_t SlowSlot(size_t index);
+	std::string_view SlotText(size_t slot)
+	{
+		return std::string_view(this->source.data() + this->offsets[slot], this->lengths[slot]);
+	}
+
+	Lexer lexer;
+	std::string_view source;
+	size_t lexed = 0;      // tokens pulled from the lexer so far
+	bool finished = false; // the final token has been pulled
+	uint8_t kinds[WINDOW];
+	uint32_t offsets[WINDOW];
+	uint32_t lengths[WINDOW];
+	uint32_t payloads[WINDOW];
+	NumberLiteral numbers[WINDOW];
+	LineTable lines;
+
+	// What the accessors read: the ring above, or a whole TokenBuffer with
+	// a window and mask that never wrap. Kinds are read in place either way.
+	const uint8_t* kind_data = kinds;
+	size_t window = WINDOW;
+	size_t mask = WINDOW - 1;
+	const TokenBuffer* buffer = nullptr;
+
+	std::unique_ptr<TokenPipeline> pipeline;
+	const TokenBatch* batch = nullptr;
+	size_t batch_position = 0;
+	std::vector<Symbol> global_symbols; // pipeline Symbol -> global Symbol
+};
+
+static_assert((TokenStream::WINDOW & (TokenStream::WINDOW - 1)) == 0, "the window is indexed with a mask");
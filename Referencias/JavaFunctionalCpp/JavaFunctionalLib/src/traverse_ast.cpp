@@ -29,14 +29,14 @@ void DeleteSpaceTab()
     tab = tab.substr(0, tab.size() - 4);
 }
 
-void Traverser::Traverse(std::unique_ptr<AstNode>& statement)
+void Traverser::Traverse(AstNode* statement)
 {
     statement->Accept(*this);
 }
 
-std::any Traverser::VisitFunctionCallNode(FunctionCallExpr& functionCallExpr)
+Value Traverser::VisitFunctionCallNode(FunctionCallExpr& functionCallExpr)
 {
-    std::cout << tab + "FunctionCallExprNode (" + functionCallExpr.identifier + ")" << std::endl;
+    std::cout << tab + "FunctionCallExprNode (" + SymbolName(functionCallExpr.identifier) + ")" << std::endl;
     std::cout << tab + "└─── Arguments" << std::endl;
     AddSpaceTab();
     for (auto& arg : functionCallExpr.arguments)
@@ -44,10 +44,10 @@ std::any Traverser::VisitFunctionCallNode(FunctionCallExpr& functionCallExpr)
         arg->Accept(*this);
     }
     DeleteSpaceTab();
-    return std::any();
+    return Value();
 }
 
-std::any Traverser::VisitBlockStmtNode(BlockStmtNode& blockStmtNode)
+Value Traverser::VisitBlockStmtNode(BlockStmtNode& blockStmtNode)
 {
     std::cout << tab + "BlockStatementNode" << std::endl;
     size_t stmt_counter = 0;
@@ -65,10 +65,10 @@ std::any Traverser::VisitBlockStmtNode(BlockStmtNode& blockStmtNode)
         stmt->Accept(*this);
         std::cout << std::endl;
     }
-    return std::any();
+    return Value();
 }
 
-std::any Traverser::VisitBinaryExpression(BinaryExpression& binaryExpression)
+Value Traverser::VisitBinaryExpression(BinaryExpression& binaryExpression)
 {
     std::cout << tab + "BinaryExpressionNode (" + TokenName(binaryExpression.op) + ")" << std::endl;
 
@@ -85,40 +85,40 @@ std::any Traverser::VisitBinaryExpression(BinaryExpression& binaryExpression)
     AddSpaceTab();
     binaryExpression.right->Accept(*this);
     DeleteSpaceTab();
-    return std::any();
+    return Value();
 }
 
-std::any Traverser::VisitBoolNode(BoolNode& boolNode)
+Value Traverser::VisitBoolNode(BoolNode& boolNode)
 {
     std::cout << tab + "BoolNode" << std::endl;
-    return std::any();
+    return Value();
 }
 
-std::any Traverser::VisitNumberNode(NumberNode& numberNode)
+Value Traverser::VisitNumberNode(NumberNode& numberNode)
 {
     std::cout << tab + "NumberNode" << std::endl;
-    return std::any();
+    return Value();
 }
 
-std::any Traverser::VisitStringNode(StringNode& stringNode)
+Value Traverser::VisitStringNode(StringNode& stringNode)
 {
     std::cout << tab + "StringNode" << std::endl;
-    return std::any();
+    return Value();
 }
 
-std::any Traverser::VisitIdentifierNode(IdentifierNode& identifierNode)
+Value Traverser::VisitIdentifierNode(IdentifierNode& identifierNode)
 {
     std::cout << tab + "IdentifierNode" << std::endl;
-    return std::any();
+    return Value();
 }
 
-std::any Traverser::VisitUnaryNode(UnaryNode& unaryNode)
+Value Traverser::VisitUnaryNode(UnaryNode& unaryNode)
 {
     std::cout << tab + "UnaryNode" << std::endl;
-    return std::any();
+    return Value();
 }
 
-std::any Traverser::VisitIfStmtNode(IfStmtNode& ifStmtNode)
+Value Traverser::VisitIfStmtNode(IfStmtNode& ifStmtNode)
 {
     std::cout << tab + "IfStatmentNode" << std::endl;
     std::cout << tab + "├───";
@@ -129,27 +129,27 @@ std::any Traverser::VisitIfStmtNode(IfStmtNode& ifStmtNode)
     AddSpaceTab();
     ifStmtNode.blockStmt->Accept(*this);
     DeleteSpaceTab();
-    return std::any();
+    return Value();
 }
 
-std::any Traverser::VisitPrintStmt(PrintStmtNode& printStmtNode)
+Value Traverser::VisitPrintStmt(PrintStmtNode& printStmtNode)
 {
     std::cout << tab + "PrintStatementNode" << std::endl;
     std::cout << tab + "└───";
     AddSpaceTab();
     printStmtNode.expression->Accept(*this);
     DeleteSpaceTab();
-    return std::any();
+    return Value();
 }
 
-std::any Traverser::VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode)
+Value Traverser::VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode)
 {
     std::cout << tab + "VarDeclarationNode";
-    return std::any();
+    return Value();
 }
 
-std::any Traverser::VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode)
+Value Traverser::VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode)
 {
     std::cout << tab + "VarAssignmentNode";
-    return std::any();
+    return Value();
 }
\ No newline at end of file
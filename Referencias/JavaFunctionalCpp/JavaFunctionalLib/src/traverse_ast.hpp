@@ -7,21 +7,21 @@
 class Traverser : public Visitor
 {
 public:
-	void Traverse(std::unique_ptr<AstNode>& statement);
+	void Traverse(AstNode* statement);
 
 private:
-	std::any VisitBinaryExpression(BinaryExpression& binaryExpression);
-	std::any VisitBoolNode(BoolNode& boolNode);
-	std::any VisitNumberNode(NumberNode& numberNode);
-	std::any VisitStringNode(StringNode& stringNode);
-	std::any VisitIdentifierNode(IdentifierNode& identifierNode);
-	std::any VisitUnaryNode(UnaryNode& unaryNode);
+	Value VisitBinaryExpression(BinaryExpression& binaryExpression);
+	Value VisitBoolNode(BoolNode& boolNode);
+	Value VisitNumberNode(NumberNode& numberNode);
+	Value VisitStringNode(StringNode& stringNode);
+	Value VisitIdentifierNode(IdentifierNode& identifierNode);
+	Value VisitUnaryNode(UnaryNode& unaryNode);
 
-	std::any VisitIfStmtNode(IfStmtNode& ifStmtNode);
-	std::any VisitPrintStmt(PrintStmtNode& printStmtNode);
-	std::any VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode);
-	std::any VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode);
+	Value VisitIfStmtNode(IfStmtNode& ifStmtNode);
+	Value VisitPrintStmt(PrintStmtNode& printStmtNode);
+	Value VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode);
+	Value VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode);
 
-	std::any VisitFunctionCallNode(FunctionCallExpr& functionCallExpr);
-	std::any VisitBlockStmtNode(BlockStmtNode& blockStmtNode);
+	Value VisitFunctionCallNode(FunctionCallExpr& functionCallExpr);
+	Value VisitBlockStmtNode(BlockStmtNode& blockStmtNode);
 };
\ No newline at end of file
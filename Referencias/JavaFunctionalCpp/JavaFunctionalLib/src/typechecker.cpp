@@ -0,0 +1,304 @@
+#include "typechecker.hpp"
+#include "ast_node_headers.hpp"
+
+// The type of an expression reading a slot no store has reached yet. It
+// only exists between rounds and never outlives Check().
+static const ValueType PENDING = (ValueType)UINT8_MAX;
+
+// Carries a static type through the Visitor's Value return.
+static Value OfType(ValueType type)
+{
+	Value value;
+	value.type = type;
+	return value;
+}
+
+TypeChecker::TypeChecker(FunctionMemory& function_memory, int global_slot_count)
+	: function_memory(function_memory), globals(global_slot_count)
+{
+}
+
+void TypeChecker::Check(std::vector<AstNode*>& statements)
+{
+	// a body parsed later may store anything in a global or pass anything
+	// to a function
+	bool lazy = false;
+	for (Symbol identifier : this->function_memory.GetIdentifiers())
+	{
+		FuncVariable& func_var = this->function_memory.GetRef(identifier);
+		lazy = lazy || func_var.block_stmt == nullptr;
+	}
+	if (lazy)
+	{
+		for (SlotType& slot : this->globals)
+		{
+			slot = { true, VAL_EMPTY };
+		}
+	}
+	for (Symbol identifier : this->function_memory.GetIdentifiers())
+	{
+		FuncVariable& func_var = this->function_memory.GetRef(identifier);
+		std::vector<SlotType>& frame = Frame(func_var);
+		for (size_t i = 0; lazy && i < func_var.parameters.size() && i < frame.size(); i++)
+		{
+			frame[i] = { true, VAL_EMPTY };
+		}
+	}
+
+	// slot types only move from unknown to a type to VAL_EMPTY, so both
+	// loops end
+	do
+	{
+		CheckProgram(statements);
+	} while (this->changed);
+	this->settling = true;
+	do
+	{
+		CheckProgram(statements);
+	} while (this->changed);
+	this->chain.clear();
+}
+
+void TypeChecker::CheckProgram(std::vector<AstNode*>& statements)
+{
+	this->changed = false;
+	this->frame = &this->globals;
+	for (AstNode* stmt : statements)
+	{
+		if (stmt != nullptr)
+		{
+			Type(stmt);
+		}
+	}
+	for (Symbol identifier : this->function_memory.GetIdentifiers())
+	{
+		FuncVariable& func_var = this->function_memory.GetRef(identifier);
+		if (func_var.block_stmt != nullptr)
+		{
+			this->frame = &Frame(func_var);
+			Type(func_var.block_stmt);
+		}
+	}
+	this->frame = &this->globals;
+}
+
+ValueType TypeChecker::Type(AstNode* node)
+{
+	if (node == nullptr)
+	{
+		return VAL_EMPTY;
+	}
+	ValueType type = Dispatch(*this, *node).type;
+	node->static_type = type;
+	return type;
+}
+
+std::vector<TypeChecker::SlotType>& TypeChecker::Frame(FuncVariable& func_var)
+{
+	std::vector<SlotType>& frame = this->frames[func_var.identifier];
+	if (frame.size() < (size_t)func_var.slot_count)
+	{
+		frame.resize(func_var.slot_count);
+	}
+	return frame;
+}
+
+// Same addressing as FrameStack::At: depth 0 is the current frame, any
+// other depth the global one. A function reading a global may be called
+// before the global is declared, so such a read has no static type.
+ValueType TypeChecker::Load(int depth, int slot)
+{
+	if (depth != 0 && this->frame != &this->globals)
+	{
+		return VAL_EMPTY;
+	}
+	std::vector<SlotType>& frame = depth == 0 ? *this->frame : this->globals;
+	if (slot < 0 || (size_t)slot >= frame.size())
+	{
+		return VAL_EMPTY;
+	}
+	if (not frame[slot].stored)
+	{
+		return this->settling ? VAL_EMPTY : PENDING;
+	}
+	return frame[slot].type;
+}
+
+void TypeChecker::Store(int depth, int slot, ValueType type)
+{
+	std::vector<SlotType>& frame = depth == 0 ? *this->frame : this->globals;
+	if (type == PENDING || slot < 0 || (size_t)slot >= frame.size())
+	{
+		return;
+	}
+	SlotType& slot_type = frame[slot];
+	if (not slot_type.stored)
+	{
+		slot_type = { true, type };
+		this->changed = true;
+	}
+	else if (slot_type.type != type && slot_type.type != VAL_EMPTY)
+	{
+		slot_type.type = VAL_EMPTY;
+		this->changed = true;
+	}
+}
+
+// Type of 'left op right', following BinaryOperation.
+static ValueType BinaryType(Token_t op, ValueType left, ValueType right)
+{
+	if (left == PENDING || right == PENDING)
+	{
+		return PENDING;
+	}
+	if (IsNumberType(left) && IsNumberType(right))
+	{
+		switch (op)
+		{
+			case PLUS_TOKEN:
+			case MINUS_TOKEN:
+			case STAR_TOKEN:
+			case SLASH_TOKEN:
+				return PromoteNumbers(left, right);
+			case EQUAL_EQUAL_TOKEN:
+			case BANG_EQUAL_TOKEN:
+				return VAL_BOOL;
+			default:
+				break;
+		}
+		return VAL_EMPTY;
+	}
+	if (left == VAL_BOOL && right == VAL_BOOL)
+	{
+		switch (op)
+		{
+			case AMPERSAND_AMPERSAND_TOKEN:
+			case PIPE_PIPE_TOKEN:
+			case EQUAL_EQUAL_TOKEN:
+			case BANG_EQUAL_TOKEN:
+				return VAL_BOOL;
+			default:
+				break;
+		}
+	}
+	return VAL_EMPTY;
+}
+
+Value TypeChecker::VisitBinaryExpression(BinaryExpression& binaryExpression)
+{
+	size_t first = this->chain.size();
+	binaryExpression.Chain(this->chain);
+	ValueType type = Type(this->chain[first]->left);
+	for (size_t i = first; i < this->chain.size(); i++)
+	{
+		BinaryExpression* node = this->chain[i];
+		type = BinaryType(node->op, type, Type(node->right));
+		node->static_type = type;
+	}
+	this->chain.resize(first);
+	return OfType(type);
+}
+
+Value TypeChecker::VisitBoolNode(BoolNode&)
+{
+	return OfType(VAL_BOOL);
+}
+
+Value TypeChecker::VisitNumberNode(NumberNode& numberNode)
+{
+	return OfType(numberNode.number.type);
+}
+
+Value TypeChecker::VisitStringNode(StringNode&)
+{
+	return OfType(VAL_STRING);
+}
+
+Value TypeChecker::VisitIdentifierNode(IdentifierNode& identifierNode)
+{
+	return OfType(Load(identifierNode.depth, identifierNode.slot));
+}
+
+// Following UnaryOperation: unary '+' keeps a number as it is, any other
+// operator negates it (promoting short).
+Value TypeChecker::VisitUnaryNode(UnaryNode& unaryNode)
+{
+	ValueType type = Type(unaryNode.left);
+	if (type == PENDING)
+	{
+		return OfType(PENDING);
+	}
+	if (IsNumberType(type))
+	{
+		return OfType(unaryNode.token == PLUS_TOKEN ? type : PromoteNumbers(type, type));
+	}
+	if (type == VAL_BOOL && unaryNode.token == BANG_TOKEN)
+	{
+		return OfType(VAL_BOOL);
+	}
+	return OfType(VAL_EMPTY);
+}
+
+Value TypeChecker::VisitIfStmtNode(IfStmtNode& ifStmtNode)
+{
+	Type(ifStmtNode.expression);
+	Type(ifStmtNode.blockStmt);
+	return OfType(VAL_EMPTY);
+}
+
+Value TypeChecker::VisitPrintStmt(PrintStmtNode& printStmtNode)
+{
+	Type(printStmtNode.expression);
+	return OfType(VAL_EMPTY);
+}
+
+Value TypeChecker::VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode)
+{
+	ValueType type = VAL_NULL;
+	if (varDeclarationNode.expression != nullptr)
+	{
+		type = Type(varDeclarationNode.expression);
+	}
+	Store(varDeclarationNode.depth, varDeclarationNode.slot, type);
+	return OfType(VAL_EMPTY);
+}
+
+Value TypeChecker::VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode)
+{
+	Store(varAssignmentNode.depth, varAssignmentNode.slot, Type(varAssignmentNode.expression));
+	return OfType(VAL_EMPTY);
+}
+
+// Arguments are stored in the callee's first slots.
+Value TypeChecker::VisitFunctionCallNode(FunctionCallExpr& functionCallExpr)
+{
+	std::vector<SlotType>* callee = nullptr;
+	size_t parameter_count = 0;
+	if (this->function_memory.Exist(functionCallExpr.identifier))
+	{
+		FuncVariable& func_var = this->function_memory.GetRef(functionCallExpr.identifier);
+		callee = &Frame(func_var);
+		parameter_count = func_var.parameters.size();
+	}
+	for (size_t i = 0; i < functionCallExpr.arguments.size(); i++)
+	{
+		ValueType type = Type(functionCallExpr.arguments[i]);
+		if (callee != nullptr && i < parameter_count)
+		{
+			std::vector<SlotType>* caller = this->frame;
+			this->frame = callee;
+			Store(0, (int)i, type);
+			this->frame = caller;
+		}
+	}
+	return OfType(VAL_EMPTY);
+}
+
+Value TypeChecker::VisitBlockStmtNode(BlockStmtNode& blockStmtNode)
+{
+	for (AstNode* stmt : blockStmtNode.stmts)
+	{
+		Type(stmt);
+	}
+	return OfType(VAL_EMPTY);
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+
+#include "visitor.hpp"
+#include "nodes/astnode.hpp"
+#include "variable.hpp"
+#include "functionmemory.hpp"
+
+// Static pass run after the Resolver: records on every expression node the
+// type its value has on every evaluation (AstNode::static_type), so the
+// Interpreter can take typed paths. A variable holds whatever was last
+// stored in it (the declared type only types literals), so the type of a
+// frame slot is the join of every store to it in the program: initializers,
+// assignments and, for parameters, the arguments of every call. Stores read
+// other slots, so the whole program is checked again until no slot changes.
+// A slot stored with two types stays VAL_EMPTY, as does every global and
+// parameter while a PARSE_LAZY body is still unparsed. Calls evaluate to
+// nothing: there is no return statement to give FuncVariable::return_type
+// a value.
+class TypeChecker final : public Visitor
+{
+public:
+	TypeChecker(FunctionMemory& function_memory, int global_slot_count);
+
+	void Check(std::vector<AstNode*>& statements);
+
+private:
+	template <class V>
+	friend Value Dispatch(V& visitor, AstNode& node);
+
+	struct SlotType
+	{
+		bool stored = false;
+		ValueType type = VAL_EMPTY; // VAL_EMPTY once two stores disagree
+	};
+
+	FunctionMemory& function_memory;
+	std::vector<SlotType> globals;
+	std::unordered_map<Symbol, std::vector<SlotType>> frames; // per function
+	std::vector<SlotType>* frame = nullptr; // of the code being checked
+	bool changed = false;
+	bool settling = false; // last rounds: slots never stored read as VAL_EMPTY
+	std::vector<BinaryExpression*> chain; // BinaryExpression::Chain of the expressions being checked
+
+	void CheckProgram(std::vector<AstNode*>& statements);
+	ValueType Type(AstNode* node);
+	ValueType Load(int depth, int slot);
+	void Store(int depth, int slot, ValueType type);
+	std::vector<SlotType>& Frame(FuncVariable& func_var);
+
+	Value VisitBinaryExpression(BinaryExpression& binaryExpression);
+	Value VisitBoolNode(BoolNode& boolNode);
+	Value VisitNumberNode(NumberNode& numberNode);
+	Value VisitStringNode(StringNode& stringNode);
+	Value VisitIdentifierNode(IdentifierNode& identifierNode);
+	Value VisitUnaryNode(UnaryNode& unaryNode);
+
+	Value VisitIfStmtNode(IfStmtNode& ifStmtNode);
+	Value VisitPrintStmt(PrintStmtNode& printStmtNode);
+	Value VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode);
+	Value VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode);
+
+	Value VisitFunctionCallNode(FunctionCallExpr& functionCallExpr);
+	Value VisitBlockStmtNode(BlockStmtNode& blockStmtNode);
+};
@@ -0,0 +1,169 @@
+#include <stdexcept>
+
+#include "value.hpp"
+
+std::string ValueTypeName(ValueType type)
+{
+	switch (type)
+	{
+		case VAL_EMPTY:
+			return "empty";
+		case VAL_NULL:
+			return "null";
+		case VAL_BOOL:
+			return "bool";
+		case VAL_SHORT:
+			return "short";
+		case VAL_INT:
+			return "int";
+		case VAL_LONG:
+			return "long";
+		case VAL_FLOAT:
+			return "float";
+		case VAL_DOUBLE:
+			return "double";
+		case VAL_STRING:
+			return "string";
+	}
+	return "invalid";
+}
+
+ValueType PromoteNumbers(ValueType left, ValueType right)
+{
+	ValueType type = left > right ? left : right;
+	if (type == VAL_SHORT)
+	{
+		return VAL_INT;
+	}
+	return type;
+}
+
+Value NumberBinary(Token_t op, Value left, Value right)
+{
+	switch (PromoteNumbers(left.type, right.type))
+	{
+		case VAL_INT:
+			return Arithmetic<int>(op, left.As<int>(), right.As<int>());
+		case VAL_LONG:
+			return Arithmetic<long>(op, left.As<long>(), right.As<long>());
+		case VAL_FLOAT:
+			return Arithmetic<float>(op, left.As<float>(), right.As<float>());
+		case VAL_DOUBLE:
+			return Arithmetic<double>(op, left.As<double>(), right.As<double>());
+		default:
+			break;
+	}
+	throw std::invalid_argument("Runtime Error: couldn't evaluate type '" + ValueTypeName(left.type) + "' with type '" + ValueTypeName(right.type) + "'");
+}
+
+Value NumberUnary(Token_t op, Value operand)
+{
+	if (op == PLUS_TOKEN)
+	{
+		return operand;
+	}
+	switch (operand.type)
+	{
+		case VAL_SHORT:
+		case VAL_INT:
+			return -operand.As<int>();
+		case VAL_LONG:
+			return -operand.As<long>();
+		case VAL_FLOAT:
+			return -operand.As<float>();
+		case VAL_DOUBLE:
+			return -operand.As<double>();
+		default:
+			break;
+	}
+	throw std::invalid_argument("Runtime Error: Invalid unary value type (found type '" + ValueTypeName(operand.type) + "')");
+}
+
+// Full binary/unary semantics shared by the tree interpreter and the VM.
+Value BinaryOperation(Token_t op, Value left, Value right)
+{
+	if (left.IsNumber() && right.IsNumber())
+	{
+		return NumberBinary(op, left, right);
+	}
+
+	if (left.IsBool() && right.IsBool())
+	{
+		bool lvar = left.AsBool();
+		bool rvar = right.AsBool();
+
+		switch (op)
+		{
+			case AMPERSAND_AMPERSAND_TOKEN:
+				return lvar && rvar;
+			case PIPE_PIPE_TOKEN:
+				return lvar || rvar;
+			case EQUAL_EQUAL_TOKEN:
+				return lvar == rvar;
+			case BANG_EQUAL_TOKEN:
+				return lvar != rvar;
+			default:
+				break;
+		}
+		std::string op_err = TokenName(op);
+		throw std::invalid_argument("Runtime Error: Invalid value type (found type '" + op_err + "')");
+	}
+	throw std::invalid_argument("Runtime Error: couldn't evaluate type '" + ValueTypeName(left.type) + "' with type '" + ValueTypeName(right.type) + "'");
+}
+
+Value UnaryOperation(Token_t op, Value operand)
+{
+	if (operand.IsNumber())
+	{
+		return NumberUnary(op, operand);
+	}
+	if (operand.IsBool())
+	{
+		if (op == BANG_TOKEN)
+		{
+			return !operand.AsBool();
+		}
+		throw std::invalid_argument("Runtime Error: Expected BANG TOKEN.");
+	}
+	throw std::invalid_argument("Runtime Error: Invalid unary value type (found type '" + ValueTypeName(operand.type) + "')");
+}
+
+// Numbers are accepted as conditions when they equal 1.
+bool IfCondition(Value value)
+{
+	if (value.IsBool())
+	{
+		return value.AsBool();
+	}
+	if (value.IsNumber())
+	{
+		return value.As<double>() == 1;
+	}
+	throw std::invalid_argument("Runtime Error: If expressions must return a bool (found type '" + ValueTypeName(value.type) + "')");
+}
+
+std::ostream& operator<<(std::ostream& out, const Value& value)
+{
+	switch (value.type)
+	{
+		case VAL_NULL:
+			return out << "null";
+		case VAL_BOOL:
+			return out << (value.as.b ? "true" : "false");
+		case VAL_SHORT:
+			return out << value.as.s;
+		case VAL_INT:
+			return out << value.as.i;
+		case VAL_LONG:
+			return out << (long)value.as.l;
+		case VAL_FLOAT:
+			return out << value.as.f;
+		case VAL_DOUBLE:
+			return out << value.as.d;
+		case VAL_STRING:
+			return out << value.AsString();
+		default:
+			break;
+	}
+	return out;
+}
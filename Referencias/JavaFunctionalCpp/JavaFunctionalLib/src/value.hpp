@@ -0,0 +1,162 @@
+#pragma once
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "token.hpp"
+
+// Numeric tags are ordered by rank so the result type of a mixed operation
+// is simply the larger tag (short is promoted to int, as in C++).
+enum ValueType : uint8_t
+{
+	VAL_EMPTY, // statements evaluate to nothing
+	VAL_NULL,
+	VAL_BOOL,
+	VAL_SHORT,
+	VAL_INT,
+	VAL_LONG,
+	VAL_FLOAT,
+	VAL_DOUBLE,
+	VAL_STRING
+};
+
+// 16-byte tagged value returned by every Visitor. Strings are views into
+// storage owned by the AST, so copying a Value never allocates.
+class Value
+{
+public:
+	Value() : type(VAL_EMPTY), length(0) { as.l = 0; }
+	Value(std::nullptr_t) : type(VAL_NULL), length(0) { as.l = 0; }
+	Value(bool b) : type(VAL_BOOL), length(0) { as.l = 0; as.b = b; }
+	Value(short s) : type(VAL_SHORT), length(0) { as.l = 0; as.s = s; }
+	Value(int i) : type(VAL_INT), length(0) { as.l = 0; as.i = i; }
+	Value(long l) : type(VAL_LONG), length(0) { as.l = l; }
+	Value(float f) : type(VAL_FLOAT), length(0) { as.l = 0; as.f = f; }
+	Value(double d) : type(VAL_DOUBLE), length(0) { as.d = d; }
+	static Value String(std::string_view str)
+	{
+		Value value;
+		value.type = VAL_STRING;
+		value.length = (uint32_t)str.size();
+		value.as.str = str.data();
+		return value;
+	}
+
+	ValueType type;
+	uint32_t length; // string length
+
+	union
+	{
+		bool b;
+		short s;
+		int i;
+		long long l; // 'long' is 32-bit on Windows, keep the payload 8 bytes
+		float f;
+		double d;
+		const char* str;
+	} as;
+
+	bool IsEmpty() const { return this->type == VAL_EMPTY; }
+	bool IsNull() const { return this->type == VAL_NULL; }
+	bool IsBool() const { return this->type == VAL_BOOL; }
+	bool IsNumber() const { return this->type >= VAL_SHORT && this->type <= VAL_DOUBLE; }
+	bool IsString() const { return this->type == VAL_STRING; }
+
+	bool AsBool() const { return this->as.b; }
+	std::string_view AsString() const { return std::string_view(this->as.str, this->length); }
+
+	template <class T>
+	T As() const
+	{
+		switch (this->type)
+		{
+			case VAL_SHORT:
+				return (T)this->as.s;
+			case VAL_INT:
+				return (T)this->as.i;
+			case VAL_LONG:
+				return (T)(long)this->as.l;
+			case VAL_FLOAT:
+				return (T)this->as.f;
+			case VAL_DOUBLE:
+				return (T)this->as.d;
+			case VAL_BOOL:
+				return (T)this->as.b;
+			default:
+				break;
+		}
+		return (T)0;
+	}
+
+	// As<T>() for a number whose type is known before it is computed: the
+	// static 'type' is switched on in place of the value's own tag.
+	template <class T>
+	T Unbox(ValueType type) const
+	{
+		switch (type)
+		{
+			case VAL_SHORT:
+				return (T)this->as.s;
+			case VAL_INT:
+				return (T)this->as.i;
+			case VAL_LONG:
+				return (T)(long)this->as.l;
+			case VAL_FLOAT:
+				return (T)this->as.f;
+			default:
+				return (T)this->as.d;
+		}
+	}
+};
+
+static_assert(sizeof(Value) == 16, "Value must stay two machine words");
+
+inline bool IsNumberType(ValueType type)
+{
+	return type >= VAL_SHORT && type <= VAL_DOUBLE;
+}
+
+std::string ValueTypeName(ValueType type);
+ValueType PromoteNumbers(ValueType left, ValueType right);
+
+// 'left op right' on two numbers already converted to T.
+template <class T>
+inline Value Arithmetic(Token_t op, T lvar, T rvar)
+{
+	switch (op)
+	{
+		case PLUS_TOKEN:
+			return lvar + rvar;
+		case MINUS_TOKEN:
+			return lvar - rvar;
+		case STAR_TOKEN:
+			return lvar * rvar;
+		case SLASH_TOKEN:
+			if constexpr (std::is_integral_v<T>)
+			{
+				if (rvar == 0)
+				{
+					throw std::invalid_argument("Runtime Error: division by zero.");
+				}
+			}
+			return lvar / rvar;
+
+		case EQUAL_EQUAL_TOKEN:
+			return lvar == rvar;
+		case BANG_EQUAL_TOKEN:
+			return lvar != rvar;
+		default:
+			break;
+	}
+	throw std::invalid_argument("Runtime Error: invalid number operator '" + TokenName(op) + "'");
+}
+
+Value NumberBinary(Token_t op, Value left, Value right);
+Value NumberUnary(Token_t op, Value operand);
+Value BinaryOperation(Token_t op, Value left, Value right);
+Value UnaryOperation(Token_t op, Value operand);
+bool IfCondition(Value value);
+std::ostream& operator<<(std::ostream& out, const Value& value);
@@ -19,4 +19,27 @@ DataType FromToken_tToDataType(Token_t token)
     }
 
     return DT_NOT_VALID;
-}
\ No newline at end of file
+}
+
+Token_t FromDataTypeToToken_t(DataType type)
+{
+    switch (type)
+    {
+        case DT_BOOL:
+            return BOOL_TYPE;
+        case DT_SHORT:
+            return SHORT_TYPE;
+        case DT_INT:
+            return INT_TYPE;
+        case DT_LONG:
+            return LONG_TYPE;
+        case DT_FLOAT:
+            return FLOAT_TYPE;
+        case DT_DOUBLE:
+            return DOUBLE_TYPE;
+        default:
+            break;
+    }
+
+    return BAD_TOKEN;
+}
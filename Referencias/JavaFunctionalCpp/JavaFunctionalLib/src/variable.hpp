@@ -1,9 +1,11 @@
 #pragma once
 #include <iostream>
-#include <any>
+#include <memory>
 #include <string>
 #include <vector>
+#include "symboltable.hpp"
 #include "token.hpp"
+#include "value.hpp"
 #include "nodes/astnode.hpp"
 
 enum DataType
@@ -21,18 +23,23 @@ enum DataType
 struct Variable
 {
 	DataType dtType = DT_NOT_VALID;
-	std::string identifier;
-	std::any value;
+	Symbol identifier = NO_SYMBOL;
+	Value value;
 	
 };
 
+struct LazyBody;
+
 struct FuncVariable 
 {
 	DataType return_type = DT_NOT_VALID;
-	std::string identifier;
-	std::unique_ptr<AstNode> block_stmt;
+	Symbol identifier = NO_SYMBOL;
+	AstNode* block_stmt = nullptr; // owned by the Program arena
 	std::vector<Variable> parameters;
+	int slot_count = 0; // frame size, filled in by the Resolver
+	std::shared_ptr<LazyBody> lazy_body; // PARSE_LAZY: the body, until block_stmt is built
 };
 
 DataType FromToken_tToDataType(Token_t token);
+Token_t FromDataTypeToToken_t(DataType type);
 
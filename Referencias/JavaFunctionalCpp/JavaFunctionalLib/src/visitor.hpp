@@ -1,8 +1,9 @@
 #pragma once
-#include <any>
 #include <iostream>
 #include <vector>
 
+#include "value.hpp"
+
 class BinaryExpression;
 class BoolNode;
 class NumberNode;
@@ -23,19 +24,19 @@ struct Variable;
 
 class Visitor {
 public:
-	virtual std::any VisitBinaryExpression(BinaryExpression& binaryExpression) = 0;
-	virtual std::any VisitBoolNode(BoolNode& boolNode) = 0;
-	virtual std::any VisitNumberNode(NumberNode& numberNode) = 0;
-	virtual std::any VisitStringNode(StringNode& stringNode) = 0;
-	virtual std::any VisitIdentifierNode(IdentifierNode& identifierNode) = 0;
-	virtual std::any VisitUnaryNode(UnaryNode& unaryNode) = 0;
-
-	virtual std::any VisitIfStmtNode(IfStmtNode& ifStmtNode) = 0;
-	virtual std::any VisitPrintStmt(PrintStmtNode& printStmtNode) = 0;
-	virtual std::any VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode) = 0;
-	virtual std::any VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode) = 0;
-
-	virtual std::any VisitFunctionCallNode(FunctionCallExpr& functionCallExpr) = 0;
-	virtual std::any VisitBlockStmtNode(BlockStmtNode& blockStmtNode) = 0;
+	virtual Value VisitBinaryExpression(BinaryExpression& binaryExpression) = 0;
+	virtual Value VisitBoolNode(BoolNode& boolNode) = 0;
+	virtual Value VisitNumberNode(NumberNode& numberNode) = 0;
+	virtual Value VisitStringNode(StringNode& stringNode) = 0;
+	virtual Value VisitIdentifierNode(IdentifierNode& identifierNode) = 0;
+	virtual Value VisitUnaryNode(UnaryNode& unaryNode) = 0;
+
+	virtual Value VisitIfStmtNode(IfStmtNode& ifStmtNode) = 0;
+	virtual Value VisitPrintStmt(PrintStmtNode& printStmtNode) = 0;
+	virtual Value VisitVarDeclarationStmt(VarDeclarationNode& varDeclarationNode) = 0;
+	virtual Value VisitVarAssignmentStmt(VarAssignmentStmtNode& varAssignmentNode) = 0;
+
+	virtual Value VisitFunctionCallNode(FunctionCallExpr& functionCallExpr) = 0;
+	virtual Value VisitBlockStmtNode(BlockStmtNode& blockStmtNode) = 0;
 };
 
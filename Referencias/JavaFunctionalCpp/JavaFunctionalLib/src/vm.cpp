@@ -0,0 +1,362 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+
+#include "vm.hpp"
+
+// GCC and Clang support labels as values: each handler jumps straight to the
+// next one, giving the branch predictor one indirect jump per opcode instead
+// of a single shared switch. MSVC falls back to the switch.
+#if defined(__GNUC__) || defined(__clang__)
+#define VM_COMPUTED_GOTO
+#endif
+
+static const size_t INITIAL_STACK_SIZE = 1 << 12;
+static const size_t MAX_STACK_SIZE = 1 << 22;
+
+VirtualMachine::VirtualMachine(std::vector<Chunk>& chunks)
+	: chunks(chunks)
+{
+}
+
+void VirtualMachine::Run()
+{
+	try
+	{
+		Execute();
+	}
+	catch (std::invalid_argument& e)
+	{
+		Report(e.what());
+	}
+	this->frames.clear();
+}
+
+std::vector<std::string> VirtualMachine::GetRuntimeErrors()
+{
+	return this->runtime_errors;
+}
+
+void VirtualMachine::Report(std::string error)
+{
+	this->runtime_errors.push_back(error);
+}
+
+// Grows the Value stack to hold at least 'required' values and moves the
+// saved frame bases along with it. Returns how far the storage moved.
+ptrdiff_t VirtualMachine::GrowStack(size_t required)
+{
+	if (required > MAX_STACK_SIZE)
+	{
+		return PTRDIFF_MAX;
+	}
+	size_t size = this->stack.size();
+	while (size < required)
+	{
+		size *= 2;
+	}
+	Value* old_data = this->stack.data();
+	this->stack.resize(std::min(size, MAX_STACK_SIZE));
+	ptrdiff_t moved = this->stack.data() - old_data;
+	for (CallFrame& frame : this->frames)
+	{
+		frame.base += moved;
+	}
+	return moved;
+}
+
+#define READ_BYTE() (*ip++)
+#define READ_SHORT() (ip += 2, ReadShort(ip - 2))
+#define READ_INT() (ip += 4, ReadInt(ip - 4))
+
+// Inline paths for the common same-type operands; everything else (mixed
+// widths, bools, type errors) goes through the interpreter's semantics.
+#define BINARY_OP(token, op) \
+	{ \
+		Value right = *--sp; \
+		Value& left = sp[-1]; \
+		if (left.type == VAL_INT && right.type == VAL_INT) \
+		{ \
+			left = Value(left.as.i op right.as.i); \
+		} \
+		else if (left.type == VAL_DOUBLE && right.type == VAL_DOUBLE) \
+		{ \
+			left = Value(left.as.d op right.as.d); \
+		} \
+		else \
+		{ \
+			left = BinaryOperation(token, left, right); \
+		} \
+	}
+
+void VirtualMachine::Execute()
+{
+	const Chunk* chunk = &this->chunks[0];
+	size_t required = (size_t)chunk->slot_count + chunk->max_stack;
+	if (this->stack.size() < required)
+	{
+		this->stack.resize(std::max(required, INITIAL_STACK_SIZE));
+	}
+	Value* stack_end = this->stack.data() + this->stack.size();
+
+	const uint8_t* ip = chunk->code.data();
+	Value* globals = this->stack.data();
+	Value* base = globals;
+	Value* sp = base + chunk->slot_count;
+	this->frames.push_back({ chunk, ip, base });
+
+#ifdef VM_COMPUTED_GOTO
+	static void* dispatch_table[] = {
+		&&L_OP_CONSTANT, &&L_OP_NULL, &&L_OP_TRUE, &&L_OP_FALSE, &&L_OP_POP,
+		&&L_OP_GET_LOCAL, &&L_OP_SET_LOCAL, &&L_OP_GET_GLOBAL, &&L_OP_SET_GLOBAL,
+		&&L_OP_ADD, &&L_OP_SUBTRACT, &&L_OP_MULTIPLY, &&L_OP_DIVIDE,
+		&&L_OP_EQUAL, &&L_OP_NOT_EQUAL, &&L_OP_BINARY,
+		&&L_OP_NEGATE, &&L_OP_NOT, &&L_OP_UNARY,
+		&&L_OP_PRINT, &&L_OP_JUMP_IF_FALSE, &&L_OP_CHECK_ARGUMENT, &&L_OP_CALL,
+		&&L_OP_FAIL, &&L_OP_RETURN
+	};
+	static_assert(sizeof(dispatch_table) / sizeof(dispatch_table[0]) == OP_COUNT, "dispatch table out of sync with OpCode");
+#define VM_DISPATCH() goto *dispatch_table[READ_BYTE()]
+#define VM_CASE(op) L_##op:
+#define VM_NEXT() VM_DISPATCH()
+	VM_DISPATCH();
+#else
+#define VM_DISPATCH() for (;;) switch ((OpCode)READ_BYTE())
+#define VM_CASE(op) case op:
+#define VM_NEXT() break
+	VM_DISPATCH()
+	{
+#endif
+
+	VM_CASE(OP_CONSTANT)
+	{
+		*sp++ = chunk->constants[READ_SHORT()];
+		VM_NEXT();
+	}
+	VM_CASE(OP_NULL)
+	{
+		*sp++ = Value(nullptr);
+		VM_NEXT();
+	}
+	VM_CASE(OP_TRUE)
+	{
+		*sp++ = Value(true);
+		VM_NEXT();
+	}
+	VM_CASE(OP_FALSE)
+	{
+		*sp++ = Value(false);
+		VM_NEXT();
+	}
+	VM_CASE(OP_POP)
+	{
+		sp--;
+		VM_NEXT();
+	}
+	VM_CASE(OP_GET_LOCAL)
+	{
+		*sp++ = base[READ_SHORT()];
+		VM_NEXT();
+	}
+	VM_CASE(OP_SET_LOCAL)
+	{
+		base[READ_SHORT()] = *--sp;
+		VM_NEXT();
+	}
+	VM_CASE(OP_GET_GLOBAL)
+	{
+		Value& global = globals[READ_SHORT()];
+		uint16_t message = READ_SHORT();
+		if (global.IsEmpty())
+		{
+			throw std::invalid_argument(chunk->messages[message]);
+		}
+		*sp++ = global;
+		VM_NEXT();
+	}
+	VM_CASE(OP_SET_GLOBAL)
+	{
+		Value& global = globals[READ_SHORT()];
+		uint16_t message = READ_SHORT();
+		if (global.IsEmpty())
+		{
+			throw std::invalid_argument(chunk->messages[message]);
+		}
+		global = *--sp;
+		VM_NEXT();
+	}
+	VM_CASE(OP_ADD)
+	{
+		BINARY_OP(PLUS_TOKEN, +);
+		VM_NEXT();
+	}
+	VM_CASE(OP_SUBTRACT)
+	{
+		BINARY_OP(MINUS_TOKEN, -);
+		VM_NEXT();
+	}
+	VM_CASE(OP_MULTIPLY)
+	{
+		BINARY_OP(STAR_TOKEN, *);
+		VM_NEXT();
+	}
+	VM_CASE(OP_DIVIDE)
+	{
+		Value right = *--sp;
+		Value& left = sp[-1];
+		if (left.type == VAL_DOUBLE && right.type == VAL_DOUBLE)
+		{
+			left = Value(left.as.d / right.as.d);
+		}
+		else
+		{
+			left = BinaryOperation(SLASH_TOKEN, left, right);
+		}
+		VM_NEXT();
+	}
+	VM_CASE(OP_EQUAL)
+	{
+		BINARY_OP(EQUAL_EQUAL_TOKEN, ==);
+		VM_NEXT();
+	}
+	VM_CASE(OP_NOT_EQUAL)
+	{
+		BINARY_OP(BANG_EQUAL_TOKEN, !=);
+		VM_NEXT();
+	}
+	VM_CASE(OP_BINARY)
+	{
+		Token_t op = (Token_t)READ_BYTE();
+		Value right = *--sp;
+		sp[-1] = BinaryOperation(op, sp[-1], right);
+		VM_NEXT();
+	}
+	VM_CASE(OP_NEGATE)
+	{
+		Value& operand = sp[-1];
+		if (operand.type == VAL_INT)
+		{
+			operand = Value(-operand.as.i);
+		}
+		else if (operand.type == VAL_DOUBLE)
+		{
+			operand = Value(-operand.as.d);
+		}
+		else
+		{
+			operand = UnaryOperation(MINUS_TOKEN, operand);
+		}
+		VM_NEXT();
+	}
+	VM_CASE(OP_NOT)
+	{
+		Value& operand = sp[-1];
+		if (operand.type == VAL_BOOL)
+		{
+			operand = Value(!operand.as.b);
+		}
+		else
+		{
+			operand = UnaryOperation(BANG_TOKEN, operand);
+		}
+		VM_NEXT();
+	}
+	VM_CASE(OP_UNARY)
+	{
+		Token_t op = (Token_t)READ_BYTE();
+		sp[-1] = UnaryOperation(op, sp[-1]);
+		VM_NEXT();
+	}
+	VM_CASE(OP_PRINT)
+	{
+		Value value = *--sp;
+		if (value.IsEmpty())
+		{
+			throw std::invalid_argument("Runtime Error: Invalid expression (found: " + ValueTypeName(value.type) + ") in print statement.");
+		}
+		std::cout << value;
+		VM_NEXT();
+	}
+	VM_CASE(OP_JUMP_IF_FALSE)
+	{
+		uint32_t offset = READ_INT();
+		Value condition = *--sp;
+		bool taken = condition.type == VAL_BOOL ? condition.as.b : IfCondition(condition);
+		if (not taken)
+		{
+			ip += offset;
+		}
+		VM_NEXT();
+	}
+	VM_CASE(OP_CHECK_ARGUMENT)
+	{
+		uint16_t function = READ_SHORT();
+		Value argument = sp[-1];
+		if (not argument.IsNumber() && not argument.IsBool())
+		{
+			throw std::invalid_argument("Function '" + this->chunks[function].name + "' have an invalid parameter: " + ValueTypeName(argument.type));
+		}
+		VM_NEXT();
+	}
+	VM_CASE(OP_CALL)
+	{
+		const Chunk* callee = &this->chunks[READ_SHORT()];
+		Value* callee_base = sp - callee->arity;
+		Value* callee_sp = callee_base + callee->slot_count;
+		if (callee_sp + callee->max_stack > stack_end)
+		{
+			ptrdiff_t moved = GrowStack(callee_sp + callee->max_stack - this->stack.data());
+			if (moved == PTRDIFF_MAX)
+			{
+				throw std::invalid_argument("Runtime Error: stack overflow in function '" + callee->name + "'.");
+			}
+			globals += moved;
+			base += moved;
+			sp += moved;
+			callee_base += moved;
+			callee_sp += moved;
+			stack_end = this->stack.data() + this->stack.size();
+		}
+		// locals start empty, like a freshly pushed FrameStack frame
+		for (Value* slot = sp; slot < callee_sp; slot++)
+		{
+			*slot = Value();
+		}
+		this->frames.back().ip = ip;
+		this->frames.push_back({ callee, callee->code.data(), callee_base });
+
+		chunk = callee;
+		ip = callee->code.data();
+		base = callee_base;
+		sp = callee_sp;
+		VM_NEXT();
+	}
+	VM_CASE(OP_FAIL)
+	{
+		throw std::invalid_argument(chunk->messages[READ_SHORT()]);
+	}
+	VM_CASE(OP_RETURN)
+	{
+		this->frames.pop_back();
+		if (this->frames.empty())
+		{
+			return;
+		}
+		// calls evaluate to nothing
+		sp = base;
+		*sp++ = Value();
+
+		CallFrame& caller = this->frames.back();
+		chunk = caller.chunk;
+		ip = caller.ip;
+		base = caller.base;
+		VM_NEXT();
+	}
+
+#ifndef VM_COMPUTED_GOTO
+	default:
+		throw std::invalid_argument("Runtime Error: invalid opcode.");
+	}
+#endif
+}
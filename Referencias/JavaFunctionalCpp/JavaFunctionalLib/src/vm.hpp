@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "chunk.hpp"
+
+// Stack machine executing the Compiler's chunks. Globals, call frames and
+// operands share one Value stack: a frame is its slots followed by its
+// operands, and arguments pushed by the caller become the callee's first
+// slots. Runtime errors match the tree Interpreter's messages.
+class VirtualMachine
+{
+public:
+	VirtualMachine(std::vector<Chunk>& chunks);
+
+	void Run();
+	std::vector<std::string> GetRuntimeErrors();
+
+private:
+	struct CallFrame
+	{
+		const Chunk* chunk;
+		const uint8_t* ip;
+		Value* base;
+	};
+
+	std::vector<Chunk>& chunks;
+	std::vector<Value> stack;
+	std::vector<CallFrame> frames;
+
+	std::vector<std::string> runtime_errors;
+	void Report(std::string error);
+
+	ptrdiff_t GrowStack(size_t required);
+	void Execute();
+};
@@ -0,0 +1,25 @@
+#pragma once
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// Runs task(0) .. task(count - 1), each on its own thread.
+template <class F>
+void RunWorkers(size_t count, F task)
+{
+	std::vector<std::thread> workers;
+	for (size_t i = 0; i < count; i++)
+	{
+		workers.emplace_back(task, i);
+	}
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+// Worker threads to use when the caller asks for 0.
+inline size_t DefaultThreads()
+{
+	return std::max<size_t>(1, std::thread::hardware_concurrency());
+}